@@ -22,6 +22,7 @@
 #include "log.h"
 #include "login-util.h"
 #include "macro.h"
+#include "memory-util.h"
 #include "missing_fs.h"
 #include "missing_magic.h"
 #include "missing_threads.h"
@@ -1725,14 +1726,28 @@ int cg_set_attribute(const char *controller, const char *path, const char *attri
 }
 
 int cg_get_attribute(const char *controller, const char *path, const char *attribute, char **ret) {
-        _cleanup_free_ char *p = NULL;
+        _cleanup_free_ char *p = NULL, *v = NULL;
+        size_t n, k;
         int r;
 
         r = cg_get_path(controller, path, attribute, &p);
         if (r < 0)
                 return r;
 
-        return read_one_line_file(p, ret);
+        /* Attributes are read very frequently (e.g. for accounting), and are nearly always a single short
+         * line. Hence, read them with a single read() into a page sized buffer rather than going through
+         * stdio, and only fall back to the line reader if the first line does not fit. */
+        r = read_virtual_file(p, page_size() - 1, &v, &n);
+        if (r < 0)
+                return r;
+
+        k = strcspn(v, NEWLINE);
+        if (r == 0 && k >= n)
+                return read_one_line_file(p, ret);
+
+        v[k] = 0;
+        *ret = TAKE_PTR(v);
+        return 0;
 }
 
 int cg_get_attribute_as_uint64(const char *controller, const char *path, const char *attribute, uint64_t *ret) {
@@ -1828,7 +1843,9 @@ int cg_get_keyed_attribute_full(
         if (r < 0)
                 return r;
 
-        r = read_full_file(filename, &contents, NULL);
+        /* Keyed attributes such as memory.stat or cpu.stat are generated in one go by the kernel, read them
+         * with a single read() rather than through stdio. */
+        r = read_virtual_file(filename, SIZE_MAX, &contents, NULL);
         if (r < 0)
                 return r;
 
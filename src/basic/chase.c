@@ -196,7 +196,10 @@ int chaseat(int dir_fd, const char *path, ChaseFlags flags, char **ret_path, int
             !ret_path && ret_fd) {
 
                 /* Shortcut the ret_fd case if the caller isn't interested in the actual path and has no root
-                 * set and doesn't care about any of the other special features we provide either. */
+                 * set and doesn't care about any of the other special features we provide either. Note that
+                 * we do not use openat2(RESOLVE_IN_ROOT) for the CHASE_AT_RESOLVE_IN_ROOT case: it cannot
+                 * return the resolved path, which nearly all callers want, and it is frequently blocked by
+                 * seccomp filters, so the slow path below would need to be kept around anyway. */
                 r = openat(dir_fd, path, O_PATH|O_CLOEXEC|(FLAGS_SET(flags, CHASE_NOFOLLOW) ? O_NOFOLLOW : 0));
                 if (r < 0)
                         return -errno;
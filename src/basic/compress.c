@@ -19,6 +19,7 @@
 
 #include "alloc-util.h"
 #include "compress.h"
+#include "cpu-set-util.h"
 #include "fd-util.h"
 #include "fileio.h"
 #include "io-util.h"
@@ -28,6 +29,12 @@
 #include "string-util.h"
 #include "unaligned.h"
 
+struct DecompressContext {
+#if HAVE_ZSTD
+        ZSTD_DCtx *zstd;
+#endif
+};
+
 #if HAVE_LZ4
 static void *lz4_dl = NULL;
 
@@ -54,6 +61,7 @@ DEFINE_TRIVIAL_CLEANUP_FUNC_FULL(LZ4F_decompressionContext_t, sym_LZ4F_freeDecom
 static void *zstd_dl = NULL;
 
 static DLSYM_PROTOTYPE(ZSTD_CCtx_setParameter) = NULL;
+static DLSYM_PROTOTYPE(ZSTD_DCtx_reset) = NULL;
 static DLSYM_PROTOTYPE(ZSTD_compress) = NULL;
 static DLSYM_PROTOTYPE(ZSTD_compressStream2) = NULL;
 static DLSYM_PROTOTYPE(ZSTD_createCCtx) = NULL;
@@ -83,6 +91,44 @@ static int zstd_ret_to_errno(size_t ret) {
                 return -EBADMSG;
         }
 }
+
+static int zstd_get_dctx(DecompressContext **ctx, ZSTD_DCtx **ret) {
+        DecompressContext *c;
+
+        assert(ctx);
+        assert(ret);
+
+        /* Allocating a decompression context is not cheap, and journal readers decompress lots of small
+         * objects one after the other. Hence, callers may keep one around, which we reset whenever it is
+         * reused. */
+
+        if (!*ctx) {
+                *ctx = new0(DecompressContext, 1);
+                if (!*ctx)
+                        return -ENOMEM;
+        }
+
+        c = *ctx;
+
+        if (c->zstd) {
+                size_t k = sym_ZSTD_DCtx_reset(c->zstd, ZSTD_reset_session_and_parameters);
+                if (!sym_ZSTD_isError(k)) {
+                        *ret = c->zstd;
+                        return 0;
+                }
+
+                log_debug("Failed to reset ZSTD decompression context, allocating a new one: %s",
+                          sym_ZSTD_getErrorName(k));
+                sym_ZSTD_freeDCtx(c->zstd);
+        }
+
+        c->zstd = sym_ZSTD_createDCtx();
+        if (!c->zstd)
+                return -ENOMEM;
+
+        *ret = c->zstd;
+        return 0;
+}
 #endif
 
 #if HAVE_XZ
@@ -108,6 +154,9 @@ static inline void lzma_end_wrapper(lzma_stream *ls) {
 
 #define ALIGN_8(l) ALIGN_TO(l, sizeof(size_t))
 
+/* Upper bound for the number of zstd worker threads used for stream compression */
+#define ZSTD_STREAM_WORKERS_MAX 4
+
 static const char* const compression_table[_COMPRESSION_MAX] = {
         [COMPRESSION_NONE] = "NONE",
         [COMPRESSION_XZ]   = "XZ",
@@ -127,6 +176,19 @@ bool compression_supported(Compression c) {
         return c >= 0 && c < _COMPRESSION_MAX && FLAGS_SET(supported, 1U << c);
 }
 
+DecompressContext* decompress_context_free(DecompressContext *c) {
+        if (!c)
+                return NULL;
+
+#if HAVE_ZSTD
+        /* The context is only ever allocated once libzstd has been loaded */
+        if (c->zstd)
+                sym_ZSTD_freeDCtx(c->zstd);
+#endif
+
+        return mfree(c);
+}
+
 #if HAVE_XZ
 int dlopen_lzma(void) {
         ELF_NOTE_DLOPEN("lzma",
@@ -275,8 +337,10 @@ int dlopen_zstd(void) {
                         DLSYM_ARG(ZSTD_freeDCtx),
                         DLSYM_ARG(ZSTD_isError),
                         DLSYM_ARG(ZSTD_createDCtx),
-                        DLSYM_ARG(ZSTD_createCCtx));
+                        DLSYM_ARG(ZSTD_createCCtx),
+                        DLSYM_ARG(ZSTD_DCtx_reset));
 }
+
 #endif
 
 int compress_blob_zstd(
@@ -416,9 +480,10 @@ int decompress_blob_lz4(
 #endif
 }
 
-int decompress_blob_zstd(
+static int decompress_blob_zstd_full(
                 const void *src,
                 uint64_t src_size,
+                DecompressContext **ctx,
                 void **dst,
                 size_t *dst_size,
                 size_t dst_max) {
@@ -429,6 +494,7 @@ int decompress_blob_zstd(
         assert(dst_size);
 
 #if HAVE_ZSTD
+        _cleanup_(decompress_context_freep) DecompressContext *temporary = NULL;
         uint64_t size;
         int r;
 
@@ -448,9 +514,10 @@ int decompress_blob_zstd(
         if (!(greedy_realloc(dst, MAX(sym_ZSTD_DStreamOutSize(), size), 1)))
                 return -ENOMEM;
 
-        _cleanup_(sym_ZSTD_freeDCtxp) ZSTD_DCtx *dctx = sym_ZSTD_createDCtx();
-        if (!dctx)
-                return -ENOMEM;
+        ZSTD_DCtx *dctx;
+        r = zstd_get_dctx(ctx ?: &temporary, &dctx);
+        if (r < 0)
+                return r;
 
         ZSTD_inBuffer input = {
                 .src = src,
@@ -475,10 +542,21 @@ int decompress_blob_zstd(
 #endif
 }
 
-int decompress_blob(
+int decompress_blob_zstd(
+                const void *src,
+                uint64_t src_size,
+                void **dst,
+                size_t *dst_size,
+                size_t dst_max) {
+
+        return decompress_blob_zstd_full(src, src_size, NULL, dst, dst_size, dst_max);
+}
+
+int decompress_blob_full(
                 Compression compression,
                 const void *src,
                 uint64_t src_size,
+                DecompressContext **ctx,
                 void **dst,
                 size_t* dst_size,
                 size_t dst_max) {
@@ -492,8 +570,9 @@ int decompress_blob(
                                 src, src_size,
                                 dst, dst_size, dst_max);
         else if (compression == COMPRESSION_ZSTD)
-                return decompress_blob_zstd(
+                return decompress_blob_zstd_full(
                                 src, src_size,
+                                ctx,
                                 dst, dst_size, dst_max);
         else
                 return -EPROTONOSUPPORT;
@@ -640,9 +719,10 @@ int decompress_startswith_lz4(
 #endif
 }
 
-int decompress_startswith_zstd(
+static int decompress_startswith_zstd_full(
                 const void *src,
                 uint64_t src_size,
+                DecompressContext **ctx,
                 void **buffer,
                 const void *prefix,
                 size_t prefix_len,
@@ -654,6 +734,7 @@ int decompress_startswith_zstd(
         assert(prefix);
 
 #if HAVE_ZSTD
+        _cleanup_(decompress_context_freep) DecompressContext *temporary = NULL;
         int r;
 
         r = dlopen_zstd();
@@ -667,9 +748,10 @@ int decompress_startswith_zstd(
         if (size < prefix_len + 1)
                 return 0; /* Decompressed text too short to match the prefix and extra */
 
-        _cleanup_(sym_ZSTD_freeDCtxp) ZSTD_DCtx *dctx = sym_ZSTD_createDCtx();
-        if (!dctx)
-                return -ENOMEM;
+        ZSTD_DCtx *dctx;
+        r = zstd_get_dctx(ctx ?: &temporary, &dctx);
+        if (r < 0)
+                return r;
 
         if (!(greedy_realloc(buffer, MAX(sym_ZSTD_DStreamOutSize(), prefix_len + 1), 1)))
                 return -ENOMEM;
@@ -698,10 +780,22 @@ int decompress_startswith_zstd(
 #endif
 }
 
-int decompress_startswith(
+int decompress_startswith_zstd(
+                const void *src,
+                uint64_t src_size,
+                void **buffer,
+                const void *prefix,
+                size_t prefix_len,
+                uint8_t extra) {
+
+        return decompress_startswith_zstd_full(src, src_size, NULL, buffer, prefix, prefix_len, extra);
+}
+
+int decompress_startswith_full(
                 Compression compression,
                 const void *src,
                 uint64_t src_size,
+                DecompressContext **ctx,
                 void **buffer,
                 const void *prefix,
                 size_t prefix_len,
@@ -721,8 +815,9 @@ int decompress_startswith(
                                 prefix, prefix_len,
                                 extra);
         else if (compression == COMPRESSION_ZSTD)
-                return decompress_startswith_zstd(
+                return decompress_startswith_zstd_full(
                                 src, src_size,
+                                ctx,
                                 buffer,
                                 prefix, prefix_len,
                                 extra);
@@ -1081,6 +1176,18 @@ int compress_stream_zstd(int fdf, int fdt, uint64_t max_bytes, uint64_t *ret_unc
         if (sym_ZSTD_isError(z))
                 log_debug("Failed to enable ZSTD checksum, ignoring: %s", sym_ZSTD_getErrorName(z));
 
+        /* Stream compression is used for potentially huge inputs such as core dumps. If libzstd has been
+         * built with multithreading support, let it compress in the background with a few worker threads,
+         * so that reading the input and compressing it overlap. This fails if libzstd has no such support,
+         * in which case we simply compress in this thread. Only count the CPUs we may actually run on, the
+         * coredump processing might be confined to a few of them. */
+        int n_cpus = cpus_in_affinity_mask();
+        if (n_cpus > 1) {
+                z = sym_ZSTD_CCtx_setParameter(cctx, ZSTD_c_nbWorkers, MIN(n_cpus, ZSTD_STREAM_WORKERS_MAX));
+                if (sym_ZSTD_isError(z))
+                        log_debug("Failed to enable ZSTD worker threads, ignoring: %s", sym_ZSTD_getErrorName(z));
+        }
+
         /* This loop read from the input file, compresses that entire chunk,
          * and writes all output produced to the output file.
          */
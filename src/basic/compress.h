@@ -27,6 +27,13 @@ Compression compression_from_string(const char *compression);
 
 bool compression_supported(Compression c);
 
+/* Decompression state that is worth keeping around between calls, e.g. by journal readers, which
+ * decompress lots of small objects one after the other. Allocated on first use by the _full() calls below. */
+typedef struct DecompressContext DecompressContext;
+
+DecompressContext* decompress_context_free(DecompressContext *c);
+DEFINE_TRIVIAL_CLEANUP_FUNC(DecompressContext*, decompress_context_free);
+
 int compress_blob_xz(const void *src, uint64_t src_size,
                      void *dst, size_t dst_alloc_size, size_t *dst_size);
 int compress_blob_lz4(const void *src, uint64_t src_size,
@@ -40,9 +47,15 @@ int decompress_blob_lz4(const void *src, uint64_t src_size,
                         void **dst, size_t* dst_size, size_t dst_max);
 int decompress_blob_zstd(const void *src, uint64_t src_size,
                         void **dst, size_t* dst_size, size_t dst_max);
-int decompress_blob(Compression compression,
-                    const void *src, uint64_t src_size,
-                    void **dst, size_t* dst_size, size_t dst_max);
+int decompress_blob_full(Compression compression,
+                         const void *src, uint64_t src_size,
+                         DecompressContext **ctx,
+                         void **dst, size_t* dst_size, size_t dst_max);
+static inline int decompress_blob(Compression compression,
+                                  const void *src, uint64_t src_size,
+                                  void **dst, size_t* dst_size, size_t dst_max) {
+        return decompress_blob_full(compression, src, src_size, NULL, dst, dst_size, dst_max);
+}
 
 int decompress_startswith_xz(const void *src, uint64_t src_size,
                              void **buffer,
@@ -56,11 +69,19 @@ int decompress_startswith_zstd(const void *src, uint64_t src_size,
                                void **buffer,
                                const void *prefix, size_t prefix_len,
                                uint8_t extra);
-int decompress_startswith(Compression compression,
-                          const void *src, uint64_t src_size,
-                          void **buffer,
-                          const void *prefix, size_t prefix_len,
-                          uint8_t extra);
+int decompress_startswith_full(Compression compression,
+                               const void *src, uint64_t src_size,
+                               DecompressContext **ctx,
+                               void **buffer,
+                               const void *prefix, size_t prefix_len,
+                               uint8_t extra);
+static inline int decompress_startswith(Compression compression,
+                                        const void *src, uint64_t src_size,
+                                        void **buffer,
+                                        const void *prefix, size_t prefix_len,
+                                        uint8_t extra) {
+        return decompress_startswith_full(compression, src, src_size, NULL, buffer, prefix, prefix_len, extra);
+}
 
 int compress_stream_xz(int fdf, int fdt, uint64_t max_bytes, uint64_t *ret_uncompressed_size);
 int compress_stream_lz4(int fdf, int fdt, uint64_t max_bytes, uint64_t *ret_uncompressed_size);
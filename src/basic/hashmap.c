@@ -341,10 +341,33 @@ static uint8_t* hash_key(HashmapBase *h) {
                                : shared_hash_key;
 }
 
+static uint64_t trivial_hash_mix(HashmapBase *h, const void *p) {
+        uint64_t x, k;
+
+        /* Keys of maps using trivial_hash_func() are pointers (or integers stored in pointers) that we
+         * allocated or chose ourselves, hence there is no point in protecting them against collision
+         * attacks with SipHash. Salt the key with the per-map hash key, so that the bucket layout is
+         * still randomized, and scramble the bits with the 64-bit finalizer of MurmurHash3. */
+
+        memcpy(&k, hash_key(h), sizeof(k));
+        x = (uint64_t) (uintptr_t) p ^ k;
+
+        x ^= x >> 33;
+        x *= UINT64_C(0xff51afd7ed558ccd);
+        x ^= x >> 33;
+        x *= UINT64_C(0xc4ceb9fe1a85ec53);
+        x ^= x >> 33;
+
+        return x;
+}
+
 static unsigned base_bucket_hash(HashmapBase *h, const void *p) {
         struct siphash state;
         uint64_t hash;
 
+        if (h->hash_ops->hash == trivial_hash_func)
+                return (unsigned) (trivial_hash_mix(h, p) % n_buckets(h));
+
         siphash24_init(&state, hash_key(h));
 
         h->hash_ops->hash(p, &state);
@@ -1241,6 +1264,10 @@ static unsigned base_bucket_scan(HashmapBase *h, unsigned idx, const void *key)
 
                 dib = bucket_calculate_dib(h, idx, dibs[idx]);
 
+                /* Thanks to the Robin Hood invariant, only entries whose initial bucket is the same as the
+                 * one of the key (i.e. dib == distance) can match, hence the compare callback is only
+                 * invoked for real bucket collisions, and the scan stops as soon as we see an entry that
+                 * is closer to its initial bucket than we are to ours. */
                 if (dib < distance)
                         return IDX_NIL;
                 if (dib == distance) {
@@ -0,0 +1,19 @@
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+#pragma once
+
+/* Static user space trace points (USDT), usable from bpftrace, perf, SystemTap and friends, e.g.
+ *
+ *     bpftrace -e 'usdt:/usr/lib/systemd/systemd:pid1:job_finished { printf("%s\n", str(arg0)); }'
+ *
+ * A trace point compiles to a single nop plus an ELF note describing where to find the arguments, hence it is
+ * essentially free while nobody is attached. Arguments are still evaluated though, so only pass values that
+ * are readily available (pointers, integers), and never anything that needs to be computed or allocated. */
+
+#if HAVE_SYS_SDT_H
+#define SDT_USE_VARIADIC
+#include <sys/sdt.h>
+
+#define TRACE_POINT(provider, name, ...) STAP_PROBEV(provider, name __VA_OPT__(,) __VA_ARGS__)
+#else
+#define TRACE_POINT(provider, name, ...) ((void) 0)
+#endif
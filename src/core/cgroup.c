@@ -115,6 +115,18 @@ bool unit_has_host_root_cgroup(const Unit *u) {
         return unit_has_name(u, SPECIAL_ROOT_SLICE);
 }
 
+static int cgroup_runtime_set_attribute(CGroupRuntime *crt, const char *controller, const char *attribute, const char *value) {
+        assert(crt);
+        assert(crt->cgroup_path);
+
+        /* While cgroup_context_apply() runs on the unified hierarchy it keeps the unit's cgroup directory
+         * open, so that each attribute write doesn't have to build and resolve the full path again. */
+        if (crt->cgroup_attribute_fd >= 0)
+                return write_string_file_at(crt->cgroup_attribute_fd, attribute, value, WRITE_STRING_FILE_DISABLE_BUFFER);
+
+        return cg_set_attribute(controller, crt->cgroup_path, attribute, value);
+}
+
 static int set_attribute_and_warn(Unit *u, const char *controller, const char *attribute, const char *value) {
         int r;
 
@@ -124,7 +136,7 @@ static int set_attribute_and_warn(Unit *u, const char *controller, const char *a
         if (!crt || !crt->cgroup_path)
                 return -EOWNERDEAD;
 
-        r = cg_set_attribute(controller, crt->cgroup_path, attribute, value);
+        r = cgroup_runtime_set_attribute(crt, controller, attribute, value);
         if (r < 0)
                 log_unit_full_errno(u, LOG_LEVEL_CGROUP_WRITE(r), r, "Failed to set '%s' attribute on '%s' to '%.*s': %m",
                                     strna(attribute), empty_to_root(crt->cgroup_path), (int) strcspn(value, NEWLINE), value);
@@ -1551,7 +1563,7 @@ static void cgroup_apply_unified_cpu_idle(Unit *u, uint64_t weight) {
 
         is_idle = weight == CGROUP_WEIGHT_IDLE;
         idle_val = one_zero(is_idle);
-        r = cg_set_attribute("cpu", crt->cgroup_path, "cpu.idle", idle_val);
+        r = cgroup_runtime_set_attribute(crt, "cpu", "cpu.idle", idle_val);
         if (r < 0 && (r != -ENOENT || is_idle))
                 log_unit_full_errno(u, LOG_LEVEL_CGROUP_WRITE(r), r, "Failed to set '%s' attribute on '%s' to '%s': %m",
                                     "cpu.idle", empty_to_root(crt->cgroup_path), idle_val);
@@ -1695,7 +1707,7 @@ static int set_bfq_weight(Unit *u, const char *controller, dev_t dev, uint64_t i
         else
                 xsprintf(buf, "%" PRIu64 "\n", bfq_weight);
 
-        r = cg_set_attribute(controller, crt->cgroup_path, p, buf);
+        r = cgroup_runtime_set_attribute(crt, controller, p, buf);
 
         /* FIXME: drop this when kernels prior
          * 795fe54c2a82 ("bfq: Add per-device weight") v5.4
@@ -1731,7 +1743,7 @@ static void cgroup_apply_io_device_weight(Unit *u, const char *dev_path, uint64_
         r1 = set_bfq_weight(u, "io", dev, io_weight);
 
         xsprintf(buf, DEVNUM_FORMAT_STR " %" PRIu64 "\n", DEVNUM_FORMAT_VAL(dev), io_weight);
-        r2 = cg_set_attribute("io", crt->cgroup_path, "io.weight", buf);
+        r2 = cgroup_runtime_set_attribute(crt, "io", "io.weight", buf);
 
         /* Look at the configured device, when both fail, prefer io.weight errno. */
         r = r2 == -EOPNOTSUPP ? r1 : r2;
@@ -2044,6 +2056,16 @@ static void cgroup_context_apply(
         if (is_local_root) /* Make sure we don't try to display messages with an empty path. */
                 path = "/";
 
+        /* Attribute writes are looked up relative to this directory fd for the duration of this call. If
+         * opening it fails we'll simply fall back to writing via the full paths. */
+        assert(crt->cgroup_attribute_fd < 0);
+        if (cg_all_unified() > 0) {
+                _cleanup_free_ char *fs = NULL;
+
+                if (cg_get_path(SYSTEMD_CGROUP_CONTROLLER, crt->cgroup_path, NULL, &fs) >= 0)
+                        crt->cgroup_attribute_fd = open(fs, O_DIRECTORY|O_CLOEXEC|O_PATH);
+        }
+
         /* We generally ignore errors caused by read-only mounted cgroup trees (assuming we are running in a container
          * then), and missing cgroups, i.e. EROFS and ENOENT. */
 
@@ -2318,6 +2340,8 @@ static void cgroup_context_apply(
                 }
         }
 
+        crt->cgroup_attribute_fd = safe_close(crt->cgroup_attribute_fd);
+
         if (apply_mask & CGROUP_MASK_BPF_FIREWALL)
                 cgroup_apply_firewall(u);
 
@@ -5219,6 +5243,8 @@ CGroupRuntime* cgroup_runtime_new(void) {
                 .cgroup_control_inotify_wd = -1,
                 .cgroup_memory_inotify_wd = -1,
 
+                .cgroup_attribute_fd = -EBADF,
+
                 .ip_accounting_ingress_map_fd = -EBADF,
                 .ip_accounting_egress_map_fd = -EBADF,
 
@@ -5257,6 +5283,8 @@ CGroupRuntime* cgroup_runtime_free(CGroupRuntime *crt) {
 #endif
         fdset_free(crt->initial_restrict_ifaces_link_fds);
 
+        safe_close(crt->cgroup_attribute_fd);
+
         bpf_firewall_close(crt);
 
         free(crt->cgroup_path);
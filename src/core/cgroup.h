@@ -327,6 +327,9 @@ typedef struct CGroupRuntime {
         int cgroup_control_inotify_wd;
         int cgroup_memory_inotify_wd;
 
+        /* The unit's cgroup directory, only open while cgroup_context_apply() runs (only on cgroupv2) */
+        int cgroup_attribute_fd;
+
         /* Device Controller BPF program */
         BPFProgram *bpf_device_control_installed;
 
@@ -939,6 +939,10 @@ const sd_bus_vtable bus_unit_vtable[] = {
         SD_BUS_PROPERTY("Refs", "as", property_get_refs, 0, 0),
         SD_BUS_PROPERTY("ActivationDetails", "a(ss)", bus_property_get_activation_details, offsetof(Unit, activation_details), SD_BUS_VTABLE_PROPERTY_EMITS_CHANGE),
         SD_BUS_PROPERTY("DebugInvocation", "b", bus_property_get_bool, offsetof(Unit, debug_invocation), 0),
+        SD_BUS_PROPERTY("NStartJobs", "t", NULL, offsetof(Unit, n_start_jobs), 0),
+        SD_BUS_PROPERTY("StartJobWaitUSec", "t", bus_property_get_usec, offsetof(Unit, start_job_wait_usec), 0),
+        SD_BUS_PROPERTY("StartJobRunUSec", "t", bus_property_get_usec, offsetof(Unit, start_job_run_usec), 0),
+        SD_BUS_PROPERTY("StartJobRunMaxUSec", "t", bus_property_get_usec, offsetof(Unit, start_job_run_max_usec), 0),
 
         SD_BUS_METHOD_WITH_ARGS("Start",
                                 SD_BUS_ARGS("s", mode),
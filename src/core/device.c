@@ -768,16 +768,50 @@ static bool device_is_ready(sd_device *dev) {
         return r != 0;
 }
 
-static int device_setup_devlink_unit_one(Manager *m, const char *devlink, Set **ready_units, Set **not_ready_units) {
+static bool device_devlink_points_to(const char *devlink, sd_device *dev) {
+        struct stat st;
+        dev_t devnum;
+
+        assert(devlink);
+        assert(dev);
+
+        if (sd_device_get_devnum(dev, &devnum) < 0)
+                return false;
+
+        if (stat(devlink, &st) < 0)
+                return false;
+
+        /* Block and character devices may share device numbers, hence also compare the type. */
+        if ((S_ISBLK(st.st_mode) && device_in_subsystem(dev, "block")) ||
+            (S_ISCHR(st.st_mode) && !device_in_subsystem(dev, "block")))
+                return st.st_rdev == devnum;
+
+        return false;
+}
+
+static int device_setup_devlink_unit_one(
+                Manager *m,
+                sd_device *origin,
+                const char *devlink,
+                Set **ready_units,
+                Set **not_ready_units) {
+
         _cleanup_(sd_device_unrefp) sd_device *dev = NULL;
         Unit *u;
 
         assert(m);
+        assert(origin);
         assert(devlink);
         assert(ready_units);
         assert(not_ready_units);
 
-        if (sd_device_new_from_devname(&dev, devlink) >= 0 && device_is_ready(dev))
+        /* In most cases the devlink points to the device we are processing the uevent for. Then, let's use
+         * that directly, instead of resolving the devlink and reading the udev database for the very same
+         * device once more, which is noticeable with lots of devices with several devlinks each. */
+        if (device_devlink_points_to(devlink, origin)) {
+                if (device_is_ready(origin))
+                        return device_setup_unit(m, origin, devlink, /* main = */ false, ready_units);
+        } else if (sd_device_new_from_devname(&dev, devlink) >= 0 && device_is_ready(dev))
                 return device_setup_unit(m, dev, devlink, /* main = */ false, ready_units);
 
         /* the devlink is already removed or not ready */
@@ -811,7 +845,7 @@ static int device_setup_extra_units(Manager *m, sd_device *dev, Set **ready_unit
                 if (PATH_STARTSWITH_SET(devlink, "/dev/block/", "/dev/char/"))
                         continue;
 
-                (void) device_setup_devlink_unit_one(m, devlink, ready_units, not_ready_units);
+                (void) device_setup_devlink_unit_one(m, dev, devlink, ready_units, not_ready_units);
         }
 
         if (device_is_ready(dev)) {
@@ -865,7 +899,7 @@ static int device_setup_extra_units(Manager *m, sd_device *dev, Set **ready_unit
 
                 if (path_startswith(d->path, "/dev/"))
                         /* This is a devlink unit. Check existence and update syspath. */
-                        (void) device_setup_devlink_unit_one(m, d->path, ready_units, not_ready_units);
+                        (void) device_setup_devlink_unit_one(m, dev, d->path, ready_units, not_ready_units);
                 else
                         /* This is an alias unit of dropped or not ready device. */
                         (void) set_ensure_put(not_ready_units, NULL, d);
@@ -26,6 +26,7 @@
 #include "string-util.h"
 #include "strv.h"
 #include "terminal-util.h"
+#include "trace-util.h"
 #include "unit.h"
 #include "virt.h"
 
@@ -282,6 +283,7 @@ Job* job_install(Job *j) {
         log_unit_debug(j->unit,
                        "Installed new job %s/%s as %u",
                        j->unit->id, job_type_to_string(j->type), (unsigned) j->id);
+        TRACE_POINT(pid1, job_enqueued, j->unit->id, (int) j->type, j->id);
 
         job_add_to_gc_queue(j);
 
@@ -927,6 +929,7 @@ int job_run_and_invalidate(Job *j) {
         job_start_timer(j, true);
         job_set_state(j, JOB_RUNNING);
         job_add_to_dbus_queue(j);
+        TRACE_POINT(pid1, job_started, j->unit->id, (int) j->type, j->id);
 
         switch (j->type) {
 
@@ -1003,6 +1006,30 @@ static void job_fail_dependencies(Unit *u, UnitDependencyAtom match_atom) {
         }
 }
 
+static void job_account_start_latency(Job *j) {
+        usec_t n, wait_usec, run_usec;
+        Unit *u;
+
+        assert(j);
+
+        u = j->unit;
+
+        if (!timestamp_is_set(j->begin_usec) || !timestamp_is_set(j->begin_running_usec))
+                return;
+
+        n = now(CLOCK_MONOTONIC);
+        wait_usec = usec_sub_unsigned(j->begin_running_usec, j->begin_usec);
+        run_usec = usec_sub_unsigned(n, j->begin_running_usec);
+
+        u->n_start_jobs++;
+        u->start_job_wait_usec = usec_add(u->start_job_wait_usec, wait_usec);
+        u->start_job_run_usec = usec_add(u->start_job_run_usec, run_usec);
+        u->start_job_run_max_usec = MAX(u->start_job_run_max_usec, run_usec);
+
+        log_unit_debug(u, "Start job waited %s in the queue and ran for %s.",
+                       FORMAT_TIMESPAN(wait_usec, USEC_PER_MSEC), FORMAT_TIMESPAN(run_usec, USEC_PER_MSEC));
+}
+
 int job_finish_and_invalidate(Job *j, JobResult result, bool recursive, bool already) {
         Unit *u, *other;
         JobType t;
@@ -1018,6 +1045,7 @@ int job_finish_and_invalidate(Job *j, JobResult result, bool recursive, bool alr
 
         log_unit_debug(u, "Job %" PRIu32 " %s/%s finished, result=%s",
                        j->id, u->id, job_type_to_string(t), job_result_to_string(result));
+        TRACE_POINT(pid1, job_finished, u->id, (int) t, j->id, (int) result);
 
         /* If this job did nothing to the respective unit we don't log the status message */
         if (!already)
@@ -1039,6 +1067,10 @@ int job_finish_and_invalidate(Job *j, JobResult result, bool recursive, bool alr
         if (IN_SET(result, JOB_FAILED, JOB_INVALID, JOB_FROZEN))
                 j->manager->n_failed_jobs++;
 
+        /* Only account start jobs that actually did something, i.e. not the ones for already active units */
+        if (result == JOB_DONE && t == JOB_START && !already)
+                job_account_start_latency(j);
+
         job_uninstall(j);
         job_free(j);
 
@@ -6171,14 +6171,19 @@ int unit_load_fragment(Unit *u) {
                 return 0;
         }
 
-        /* Possibly rebuild the fragment map to catch new units */
-        r = unit_file_build_name_map(&u->manager->lookup_paths,
-                                     &u->manager->unit_cache_timestamp_hash,
-                                     &u->manager->unit_id_map,
-                                     &u->manager->unit_name_map,
-                                     &u->manager->unit_path_cache);
-        if (r < 0)
-                return log_error_errno(r, "Failed to rebuild name map: %m");
+        /* Possibly rebuild the fragment map to catch new units. While dispatching the load queue, it's
+         * sufficient to do that for the first unit. */
+        if (!u->manager->unit_cache_checked) {
+                r = unit_file_build_name_map(&u->manager->lookup_paths,
+                                             &u->manager->unit_cache_timestamp_hash,
+                                             &u->manager->unit_id_map,
+                                             &u->manager->unit_name_map,
+                                             &u->manager->unit_path_cache);
+                if (r < 0)
+                        return log_error_errno(r, "Failed to rebuild name map: %m");
+
+                u->manager->unit_cache_checked = u->manager->dispatching_load_queue;
+        }
 
         r = unit_file_find_fragment(u->manager->unit_id_map,
                                     u->manager->unit_name_map,
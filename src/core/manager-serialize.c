@@ -19,10 +19,27 @@
 #include "user-util.h"
 #include "varlink-serialize.h"
 
+/* stdio sizes its buffer after st_blksize, i.e. a single page for memfds, which results in a write() and read()
+ * for every few units serialized. */
+#define SERIALIZATION_BUFFER_SIZE (64U*1024U)
+
 int manager_open_serialization(Manager *m, FILE **ret_f) {
+        /* glibc only honours the buffer size if we pass the buffer in too. There's only ever one
+         * serialization of ours in use at a time, hence a static buffer suffices. */
+        static char buffer[SERIALIZATION_BUFFER_SIZE];
+        _cleanup_fclose_ FILE *f = NULL;
+        int r;
+
         assert(ret_f);
 
-        return open_serialization_file("systemd-state", ret_f);
+        r = open_serialization_file("systemd-state", &f);
+        if (r < 0)
+                return r;
+
+        (void) setvbuf(f, buffer, _IOFBF, sizeof(buffer));
+
+        *ret_f = TAKE_PTR(f);
+        return 0;
 }
 
 static bool manager_timestamp_shall_serialize(ManagerObjective o, ManagerTimestamp t) {
@@ -225,7 +242,7 @@ static int manager_deserialize_units(Manager *m, FILE *f, FDSet *fds) {
                 _cleanup_free_ char *line = NULL;
 
                 /* Start marker */
-                r = read_stripped_line(f, LONG_LINE_MAX, &line);
+                r = read_stripped_line_full(f, LONG_LINE_MAX, READ_LINE_NOT_A_TTY, &line);
                 if (r < 0)
                         return log_error_errno(r, "Failed to read serialization line: %m");
                 if (r == 0)
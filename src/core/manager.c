@@ -117,6 +117,13 @@
 /* How many units and jobs to process of the bus queue before returning to the event loop. */
 #define MANAGER_BUS_MESSAGE_BUDGET 100U
 
+/* How long to hold back change signals after the bus queue became non-empty, so that further changes to the same
+ * units and jobs in quick succession (as in big transactions) are merged into a single signal per object. */
+#define MANAGER_BUS_COALESCE_USEC (10*USEC_PER_MSEC)
+
+/* How many units to pop off the GC queue before giving the event loop a chance to run. */
+#define MANAGER_GC_UNIT_BUDGET 1000U
+
 #define DEFAULT_TASKS_MAX ((CGroupTasksMax) { 15U, 100U }) /* 15% */
 
 static int manager_dispatch_notify_fd(sd_event_source *source, int fd, uint32_t revents, void *userdata);
@@ -757,6 +764,7 @@ static void manager_free_unit_name_maps(Manager *m) {
         m->unit_name_map = hashmap_free(m->unit_name_map);
         m->unit_path_cache = set_free(m->unit_path_cache);
         m->unit_cache_timestamp_hash = 0;
+        m->unit_cache_checked = false;
 }
 
 static int manager_setup_run_queue(Manager *m) {
@@ -1054,12 +1062,12 @@ int manager_new(RuntimeScope runtime_scope, ManagerTestRunFlags test_run_flags,
                 if (m->executor_fd < 0)
                         return log_debug_errno(m->executor_fd, "Failed to pin executor binary: %m");
 
-                if (DEBUG_LOGGING) {
-                        _cleanup_free_ char *executor_path = NULL;
+                /* Resolve the path once here, rather than on every exec_spawn() */
+                r = fd_get_path(m->executor_fd, &m->executor_path);
+                if (r < 0)
+                        return log_debug_errno(r, "Failed to get executor path from fd: %m");
 
-                        (void) fd_get_path(m->executor_fd, &executor_path);
-                        log_debug("Using systemd-executor binary from '%s'.", strna(executor_path));
-                }
+                log_debug("Using systemd-executor binary from '%s'.", m->executor_path);
         }
 
         /* Note that we do not set up the notify fd here. We do that after deserialization,
@@ -1423,11 +1431,16 @@ good:
 }
 
 static unsigned manager_dispatch_gc_unit_queue(Manager *m) {
-        unsigned n = 0, gc_marker;
+        unsigned n = 0, gc_marker, budget = MANAGER_GC_UNIT_BUDGET;
         Unit *u;
 
         assert(m);
 
+        /* If the last run used up its budget, let the event loop run once before we continue, so that a
+         * burst of units to collect doesn't stall everything else. */
+        if (m->gc_unit_queue_yield)
+                return 0;
+
         /* log_debug("Running GC..."); */
 
         m->gc_marker += _GC_OFFSET_MAX;
@@ -1436,9 +1449,11 @@ static unsigned manager_dispatch_gc_unit_queue(Manager *m) {
 
         gc_marker = m->gc_marker;
 
-        while ((u = LIST_POP(gc_queue, m->gc_unit_queue))) {
+        while (budget > 0 && (u = LIST_POP(gc_queue, m->gc_unit_queue))) {
                 assert(u->in_gc_queue);
 
+                budget--;
+
                 unit_gc_sweep(u, gc_marker);
 
                 u->in_gc_queue = false;
@@ -1454,6 +1469,9 @@ static unsigned manager_dispatch_gc_unit_queue(Manager *m) {
                 }
         }
 
+        if (m->gc_unit_queue)
+                m->gc_unit_queue_yield = true;
+
         return n;
 }
 
@@ -1775,6 +1793,7 @@ Manager* manager_free(Manager *m) {
 #endif
 
         safe_close(m->executor_fd);
+        free(m->executor_path);
 
         return mfree(m);
 }
@@ -2314,6 +2333,11 @@ unsigned manager_dispatch_load_queue(Manager *m) {
         /* Dispatches the load queue. Takes a unit from the queue and
          * tries to load its data until the queue is empty */
 
+        /* Checking whether the unit name maps are still current means stat()ing every directory in the
+         * search path, hence do that only once for all units we load in one go, rather than once for each
+         * of them, see unit_load_fragment(). */
+        m->unit_cache_checked = false;
+
         while ((u = m->load_queue)) {
                 assert(u->in_load_queue);
 
@@ -2321,6 +2345,7 @@ unsigned manager_dispatch_load_queue(Manager *m) {
                 n++;
         }
 
+        m->unit_cache_checked = false;
         m->dispatching_load_queue = false;
 
         /* Dispatch the units waiting for their target dependencies to be added now, as all targets that we know about
@@ -2550,7 +2575,20 @@ static unsigned manager_dispatch_dbus_queue(Manager *m) {
                 budget = UINT_MAX; /* infinite budget in this case */
         else {
                 /* Anything to do at all? */
-                if (!m->dbus_unit_queue && !m->dbus_job_queue)
+                if (!m->dbus_unit_queue && !m->dbus_job_queue) {
+                        m->dbus_queue_since = 0;
+                        return 0;
+                }
+
+                /* Give units and jobs that were just queued a moment to change further before we announce them,
+                 * so that we generate one signal for all of it rather than one per change. Note that state
+                 * changes flush pending signals right away anyway, see bus_unit_send_pending_change_signal(),
+                 * hence clients still get to see every state transition. */
+                if (m->dbus_queue_since == 0) {
+                        m->dbus_queue_since = now(CLOCK_MONOTONIC);
+                        return 0;
+                }
+                if (usec_add(m->dbus_queue_since, MANAGER_BUS_COALESCE_USEC) > now(CLOCK_MONOTONIC))
                         return 0;
 
                 /* Do we have overly many messages queued at the moment? If so, let's not enqueue more on top, let's
@@ -2593,6 +2631,9 @@ static unsigned manager_dispatch_dbus_queue(Manager *m) {
                         budget--;
         }
 
+        if (!m->dbus_unit_queue && !m->dbus_job_queue)
+                m->dbus_queue_since = 0;
+
         if (m->send_reloading_done) {
                 m->send_reloading_done = false;
                 bus_manager_send_reloading(m, false);
@@ -2607,6 +2648,26 @@ static unsigned manager_dispatch_dbus_queue(Manager *m) {
         return n;
 }
 
+static usec_t manager_dbus_queue_wait(Manager *m) {
+        usec_t deadline, n;
+
+        assert(m);
+
+        /* Returns how long to sleep at most until held back bus signals are due. Once they are due they are
+         * either sent right away, or the bus queues are full, in which case we wait for them to drain, hence
+         * there's no point in waking up for them again. */
+
+        if (m->dbus_queue_since == 0 || (!m->dbus_unit_queue && !m->dbus_job_queue))
+                return USEC_INFINITY;
+
+        deadline = usec_add(m->dbus_queue_since, MANAGER_BUS_COALESCE_USEC);
+        n = now(CLOCK_MONOTONIC);
+        if (deadline <= n)
+                return USEC_INFINITY;
+
+        return deadline - n;
+}
+
 static int manager_dispatch_cgroups_agent_fd(sd_event_source *source, int fd, uint32_t revents, void *userdata) {
         Manager *m = userdata;
         char buf[PATH_MAX];
@@ -3410,8 +3471,10 @@ int manager_loop(Manager *m) {
                 if (manager_dispatch_dbus_queue(m) > 0)
                         continue;
 
-                /* Sleep for watchdog runtime wait time */
-                r = sd_event_run(m->event, watchdog_runtime_wait());
+                /* Don't sleep at all if we still have units to collect, otherwise sleep for watchdog
+                 * runtime wait time, but wake up in time to send out held back bus signals */
+                m->gc_unit_queue_yield = false;
+                r = sd_event_run(m->event, m->gc_unit_queue ? 0 : MIN(watchdog_runtime_wait(), manager_dbus_queue_wait(m)));
                 if (r < 0)
                         return log_error_errno(r, "Failed to run event loop: %m");
         }
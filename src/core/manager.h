@@ -213,6 +213,7 @@ struct Manager {
          * D-Bus change signals. */
         LIST_HEAD(Unit, dbus_unit_queue);
         LIST_HEAD(Job, dbus_job_queue);
+        usec_t dbus_queue_since; /* When we first found the queues above non-empty, CLOCK_MONOTONIC */
 
         /* Units to remove */
         LIST_HEAD(Unit, cleanup_queue);
@@ -296,6 +297,7 @@ struct Manager {
         Hashmap *unit_name_map;
         Set *unit_path_cache;
         uint64_t unit_cache_timestamp_hash;
+        bool unit_cache_checked; /* Set while dispatching the load queue once the cache was checked to be current */
 
         /* We don't have support for atomically enabling/disabling units, and unit_file_state might become
          * outdated if such operations failed half-way. Therefore, we set this flag if changes to unit files
@@ -376,6 +378,8 @@ struct Manager {
         int pin_cgroupfs_fd;
 
         unsigned gc_marker;
+        /* Set when a GC run used up its budget, until the event loop ran once */
+        bool gc_unit_queue_yield;
 
         /* The stat() data the last time we saw /etc/localtime */
         usec_t etc_localtime_mtime;
@@ -508,6 +512,7 @@ struct Manager {
         /* Pin the systemd-executor binary, so that it never changes until re-exec, ensuring we don't have
          * serialization/deserialization compatibility issues during upgrades. */
         int executor_fd;
+        char *executor_path;
 
         unsigned soft_reboots_count;
 
@@ -303,7 +303,10 @@ static void transaction_drop_redundant(Transaction *tr) {
                                           j->unit->id, job_type_to_string(j->type));
                                 transaction_delete_job(tr, j, false);
                                 again = true;
-                                break;
+
+                                /* This only removes the current entry, which is safe while iterating,
+                                 * hence continue with the remaining jobs instead of starting over, so
+                                 * that this doesn't become quadratic for large transactions. */
                         }
                 }
         } while (again);
@@ -520,9 +523,12 @@ static void transaction_collect_garbage(Transaction *tr) {
 
                         if (!j->object_list) {
                                 log_trace("Garbage collecting job %s/%s", j->unit->id, job_type_to_string(j->type));
+
+                                /* Nothing depends on this job, hence deleting it doesn't delete any other
+                                 * jobs, and we can safely continue iterating. */
                                 transaction_delete_job(tr, j, true);
                                 again = true;
-                                break;
+                                continue;
                         }
 
                         log_trace("Keeping job %s/%s because of %s/%s",
@@ -91,6 +91,13 @@ int unit_serialize_state(Unit *u, FILE *f, FDSet *fds, bool switching_root) {
         (void) serialize_ratelimit(f, "start-ratelimit", &u->start_ratelimit);
         (void) serialize_ratelimit(f, "auto-start-stop-ratelimit", &u->auto_start_stop_ratelimit);
 
+        if (u->n_start_jobs > 0) {
+                (void) serialize_item_format(f, "n-start-jobs", "%" PRIu64, u->n_start_jobs);
+                (void) serialize_usec(f, "start-job-wait-usec", u->start_job_wait_usec);
+                (void) serialize_usec(f, "start-job-run-usec", u->start_job_run_usec);
+                (void) serialize_usec(f, "start-job-run-max-usec", u->start_job_run_max_usec);
+        }
+
         if (dual_timestamp_is_set(&u->condition_timestamp))
                 (void) serialize_bool(f, "condition-result", u->condition_result);
 
@@ -254,7 +261,16 @@ int unit_deserialize_state(Unit *u, FILE *f, FDSet *fds) {
                         deserialize_ratelimit(&u->auto_start_stop_ratelimit, l, v);
                         continue;
 
-                } else if (MATCH_DESERIALIZE("condition-result", l, v, parse_boolean, u->condition_result))
+                } else if (MATCH_DESERIALIZE_IMMEDIATE("n-start-jobs", l, v, safe_atou64, u->n_start_jobs))
+                        continue;
+                else if (MATCH_DESERIALIZE_IMMEDIATE("start-job-wait-usec", l, v, deserialize_usec, u->start_job_wait_usec))
+                        continue;
+                else if (MATCH_DESERIALIZE_IMMEDIATE("start-job-run-usec", l, v, deserialize_usec, u->start_job_run_usec))
+                        continue;
+                else if (MATCH_DESERIALIZE_IMMEDIATE("start-job-run-max-usec", l, v, deserialize_usec, u->start_job_run_max_usec))
+                        continue;
+
+                else if (MATCH_DESERIALIZE("condition-result", l, v, parse_boolean, u->condition_result))
                         continue;
 
                 else if (MATCH_DESERIALIZE("assert-result", l, v, parse_boolean, u->assert_result))
@@ -387,7 +403,7 @@ int unit_deserialize_state_skip(FILE *f) {
         for (;;) {
                 _cleanup_free_ char *line = NULL;
 
-                r = read_stripped_line(f, LONG_LINE_MAX, &line);
+                r = read_stripped_line_full(f, LONG_LINE_MAX, READ_LINE_NOT_A_TTY, &line);
                 if (r < 0)
                         return log_error_errno(r, "Failed to read serialization line: %m");
                 if (r == 0)
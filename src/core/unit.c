@@ -58,6 +58,7 @@
 #include "strv.h"
 #include "terminal-util.h"
 #include "tmpfile-util.h"
+#include "trace-util.h"
 #include "umask-util.h"
 #include "unit-name.h"
 #include "unit.h"
@@ -631,9 +632,12 @@ static void unit_clear_dependencies(Unit *u) {
 
                 for (Unit *other; (other = hashmap_steal_first_key(deps));) {
                         Hashmap *other_deps;
+                        void *dt;
 
-                        HASHMAP_FOREACH(other_deps, other->dependencies)
-                                hashmap_remove(other_deps, u);
+                        /* Don't leave empty per-type hashmaps behind on the other unit either */
+                        HASHMAP_FOREACH_KEY(other_deps, dt, other->dependencies)
+                                if (hashmap_remove(other_deps, u) && hashmap_isempty(other_deps))
+                                        hashmap_free(hashmap_remove(other->dependencies, dt));
 
                         unit_add_to_gc_queue(other);
                 }
@@ -2605,6 +2609,8 @@ void unit_notify(Unit *u, UnitActiveState os, UnitActiveState ns, bool reload_su
 
         Manager *m = ASSERT_PTR(u->manager);
 
+        TRACE_POINT(pid1, unit_state_changed, u->id, (int) os, (int) ns);
+
         /* Let's enqueue the change signal early. In case this unit has a job associated we want that this unit is in
          * the bus queue, so that any job change signal queued will force out the unit change signal first. */
         unit_add_to_dbus_queue(u);
@@ -5514,6 +5520,8 @@ static void unit_update_dependency_mask(Hashmap *deps, Unit *other, UnitDependen
 
 void unit_remove_dependencies(Unit *u, UnitDependencyMask mask) {
         Hashmap *deps;
+        void *dt;
+
         assert(u);
 
         /* Removes all dependencies u has on other units marked for ownership by 'mask'. */
@@ -5521,50 +5529,50 @@ void unit_remove_dependencies(Unit *u, UnitDependencyMask mask) {
         if (mask == 0)
                 return;
 
-        HASHMAP_FOREACH(deps, u->dependencies) {
-                bool done;
-
-                do {
-                        UnitDependencyInfo di;
-                        Unit *other;
-
-                        done = true;
+        /* Removing or updating the current entry doesn't invalidate the iterators, hence there's no need to
+         * restart the iteration after each dependency we dropped. */
+        HASHMAP_FOREACH_KEY(deps, dt, u->dependencies) {
+                UnitDependencyInfo di;
+                Unit *other;
 
-                        HASHMAP_FOREACH_KEY(di.data, other, deps) {
-                                Hashmap *other_deps;
+                HASHMAP_FOREACH_KEY(di.data, other, deps) {
+                        Hashmap *other_deps;
+                        void *other_dt;
 
-                                if (FLAGS_SET(~mask, di.origin_mask))
-                                        continue;
+                        if (FLAGS_SET(~mask, di.origin_mask))
+                                continue;
 
-                                di.origin_mask &= ~mask;
-                                unit_update_dependency_mask(deps, other, di);
+                        di.origin_mask &= ~mask;
+                        unit_update_dependency_mask(deps, other, di);
 
-                                /* We updated the dependency from our unit to the other unit now. But most
-                                 * dependencies imply a reverse dependency. Hence, let's delete that one
-                                 * too. For that we go through all dependency types on the other unit and
-                                 * delete all those which point to us and have the right mask set. */
+                        /* We updated the dependency from our unit to the other unit now. But most
+                         * dependencies imply a reverse dependency. Hence, let's delete that one too. For
+                         * that we go through all dependency types on the other unit and delete all those
+                         * which point to us and have the right mask set. */
 
-                                HASHMAP_FOREACH(other_deps, other->dependencies) {
-                                        UnitDependencyInfo dj;
+                        HASHMAP_FOREACH_KEY(other_deps, other_dt, other->dependencies) {
+                                UnitDependencyInfo dj;
 
-                                        dj.data = hashmap_get(other_deps, u);
-                                        if (FLAGS_SET(~mask, dj.destination_mask))
-                                                continue;
+                                dj.data = hashmap_get(other_deps, u);
+                                if (FLAGS_SET(~mask, dj.destination_mask))
+                                        continue;
 
-                                        dj.destination_mask &= ~mask;
-                                        unit_update_dependency_mask(other_deps, u, dj);
-                                }
+                                dj.destination_mask &= ~mask;
+                                unit_update_dependency_mask(other_deps, u, dj);
 
-                                unit_add_to_gc_queue(other);
+                                if (hashmap_isempty(other_deps))
+                                        hashmap_free(hashmap_remove(other->dependencies, other_dt));
+                        }
 
-                                /* The unit 'other' may not be wanted by the unit 'u'. */
-                                unit_submit_to_stop_when_unneeded_queue(other);
+                        unit_add_to_gc_queue(other);
 
-                                done = false;
-                                break;
-                        }
+                        /* The unit 'other' may not be wanted by the unit 'u'. */
+                        unit_submit_to_stop_when_unneeded_queue(other);
+                }
 
-                } while (!done);
+                /* Don't keep empty per-type hashmaps around */
+                if (hashmap_isempty(deps))
+                        hashmap_free(hashmap_remove(u->dependencies, dt));
         }
 }
 
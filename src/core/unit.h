@@ -295,6 +295,13 @@ typedef struct Unit {
         dual_timestamp active_exit_timestamp;
         dual_timestamp inactive_enter_timestamp;
 
+        /* Latency statistics of the start jobs of this unit that completed successfully: how long they
+         * waited in the job queue before they were run, and how long they took to complete once running */
+        uint64_t n_start_jobs;
+        usec_t start_job_wait_usec;
+        usec_t start_job_run_usec;
+        usec_t start_job_run_max_usec;
+
         /* Per type list */
         LIST_FIELDS(Unit, units_by_type);
 
@@ -34,6 +34,7 @@
 #include "fd-util.h"
 #include "fileio.h"
 #include "fs-util.h"
+#include "io-util.h"
 #include "iovec-util.h"
 #include "journal-importer.h"
 #include "journal-send.h"
@@ -443,6 +444,62 @@ static int grant_user_access(int core_fd, const Context *context) {
         return ret;
 }
 
+/* Size of the chunks the core is read in, and the minimal run of zero bytes that is turned into a hole */
+#define CORE_COPY_BUFFER_SIZE (128U*1024U)
+#define CORE_HOLE_MIN 4096U
+
+static int copy_core_sparse(int input_fd, int fd, uint64_t max_size) {
+        _cleanup_free_ uint8_t *buf = NULL;
+        uint64_t left = max_size;
+        bool truncated = false;
+        off_t offset;
+
+        assert(input_fd >= 0);
+        assert(fd >= 0);
+
+        /* The kernel writes unpopulated memory areas into the pipe as zero pages, which tend to make up a
+         * large part of a core. Store such areas as holes, so that they neither take up disk space nor
+         * memory if the core is stored on tmpfs while being compressed. Returns 1 if the core was
+         * truncated to max_size, 0 otherwise, like copy_bytes(). */
+
+        buf = malloc(CORE_COPY_BUFFER_SIZE);
+        if (!buf)
+                return -ENOMEM;
+
+        for (;;) {
+                ssize_t n;
+
+                if (left == 0) {
+                        truncated = true;
+                        break;
+                }
+
+                n = read(input_fd, buf, MIN((uint64_t) CORE_COPY_BUFFER_SIZE, left));
+                if (n < 0) {
+                        if (errno == EINTR)
+                                continue;
+                        return -errno;
+                }
+                if (n == 0)
+                        break;
+
+                n = sparse_write(fd, buf, n, CORE_HOLE_MIN);
+                if (n < 0)
+                        return n;
+
+                left -= n;
+        }
+
+        /* If the core ends in a hole, we only seeked past the end of the file, extend it explicitly. */
+        offset = lseek(fd, 0, SEEK_CUR);
+        if (offset < 0)
+                return -errno;
+        if (ftruncate(fd, offset) < 0)
+                return -errno;
+
+        return truncated;
+}
+
 static int save_external_coredump(
                 const Context *context,
                 int input_fd,
@@ -554,7 +611,7 @@ static int save_external_coredump(
                 log_debug("Limiting core file size to %" PRIu64 " bytes due to cgroup and/or filesystem limits.", max_size);
         }
 
-        r = copy_bytes(input_fd, fd, max_size, 0);
+        r = copy_core_sparse(input_fd, fd, max_size);
         if (r < 0)
                 return log_error_errno(r, "Cannot store coredump of %s (%s): %m",
                                 context->meta[META_ARGV_PID], context->meta[META_COMM]);
@@ -3,6 +3,11 @@
 #include "import-compress.h"
 #include "string-table.h"
 
+/* Every chunk of decompressed output is hashed and written to disk by the callback, usually in a
+ * separate write() call. Use reasonably large chunks to keep the per-chunk overhead low when pulling
+ * large images. */
+#define UNCOMPRESS_BUFFER_SIZE (64U * 1024U)
+
 void import_compress_free(ImportCompress *c) {
         assert(c);
 
@@ -121,7 +126,7 @@ int import_uncompress(ImportCompress *c, const void *data, size_t size, ImportCo
                 c->xz.avail_in = size;
 
                 while (c->xz.avail_in > 0) {
-                        uint8_t buffer[16 * 1024];
+                        uint8_t buffer[UNCOMPRESS_BUFFER_SIZE];
                         lzma_ret lzr;
 
                         c->xz.next_out = buffer;
@@ -145,7 +150,7 @@ int import_uncompress(ImportCompress *c, const void *data, size_t size, ImportCo
                 c->gzip.avail_in = size;
 
                 while (c->gzip.avail_in > 0) {
-                        uint8_t buffer[16 * 1024];
+                        uint8_t buffer[UNCOMPRESS_BUFFER_SIZE];
 
                         c->gzip.next_out = buffer;
                         c->gzip.avail_out = sizeof(buffer);
@@ -169,7 +174,7 @@ int import_uncompress(ImportCompress *c, const void *data, size_t size, ImportCo
                 c->bzip2.avail_in = size;
 
                 while (c->bzip2.avail_in > 0) {
-                        uint8_t buffer[16 * 1024];
+                        uint8_t buffer[UNCOMPRESS_BUFFER_SIZE];
 
                         c->bzip2.next_out = (char*) buffer;
                         c->bzip2.avail_out = sizeof(buffer);
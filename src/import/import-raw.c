@@ -48,7 +48,7 @@ struct RawImport {
 
         sd_event_source *input_event_source;
 
-        uint8_t buffer[16*1024];
+        uint8_t buffer[64*1024];
         size_t buffer_size;
 
         uint64_t written_compressed;
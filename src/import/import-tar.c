@@ -49,7 +49,7 @@ struct TarImport {
 
         sd_event_source *input_event_source;
 
-        uint8_t buffer[16*1024];
+        uint8_t buffer[64*1024];
         size_t buffer_size;
 
         uint64_t written_compressed;
@@ -28,13 +28,13 @@
 #include "logs-show.h"
 #include "main-func.h"
 #include "memory-util.h"
+#include "memstream-util.h"
 #include "microhttpd-util.h"
 #include "os-util.h"
 #include "parse-util.h"
 #include "pretty-print.h"
 #include "signal-util.h"
 #include "time-util.h"
-#include "tmpfile-util.h"
 
 #define JOURNAL_WAIT_TIMEOUT (10*USEC_PER_SEC)
 
@@ -62,7 +62,7 @@ typedef struct RequestMeta {
         uint64_t n_entries;
         bool n_entries_set, since_set, until_set;
 
-        FILE *tmp;
+        char *buffer; /* The currently serialized item */
         uint64_t delta, size;
 
         int argument_parse_error;
@@ -107,8 +107,7 @@ static void request_meta_free(
 
         sd_journal_close(m->journal);
 
-        safe_fclose(m->tmp);
-
+        free(m->buffer);
         free(m->cursor);
         free(m);
 }
@@ -127,24 +126,36 @@ static int open_journal(RequestMeta *m) {
                 return sd_journal_open(&m->journal, (arg_merge ? 0 : SD_JOURNAL_LOCAL_ONLY) | arg_journal_type);
 }
 
-static int request_meta_ensure_tmp(RequestMeta *m) {
+static int request_meta_finalize_item(RequestMeta *m, MemStream *ms) {
+        char *buf;
+        size_t sz;
+        int r;
+
         assert(m);
+        assert(ms);
 
-        if (m->tmp)
-                rewind(m->tmp);
-        else {
-                _cleanup_close_ int fd = -EBADF;
+        r = memstream_finalize(ms, &buf, &sz);
+        if (r < 0)
+                return r;
 
-                fd = open_tmpfile_unlinkable("/tmp", O_RDWR|O_CLOEXEC);
-                if (fd < 0)
-                        return fd;
+        free_and_replace(m->buffer, buf);
+        m->size = sz;
+        return 0;
+}
 
-                m->tmp = take_fdopen(&fd, "w+");
-                if (!m->tmp)
-                        return -errno;
-        }
+static ssize_t request_meta_read_item(RequestMeta *m, uint64_t pos, char *buf, size_t max) {
+        size_t n;
 
-        return 0;
+        assert(m);
+        assert(buf);
+
+        if (pos >= m->size)
+                return 0;
+
+        n = MIN(m->size - pos, max);
+        memcpy(buf, m->buffer + pos, n);
+
+        return (ssize_t) n;
 }
 
 static ssize_t request_reader_entries(
@@ -157,7 +168,6 @@ static ssize_t request_reader_entries(
         dual_timestamp previous_ts = DUAL_TIMESTAMP_NULL;
         sd_id128_t previous_boot_id = SD_ID128_NULL;
         int r;
-        size_t n, k;
 
         assert(buf);
         assert(max > 0);
@@ -166,7 +176,8 @@ static ssize_t request_reader_entries(
         pos -= m->delta;
 
         while (pos >= m->size) {
-                off_t sz;
+                _cleanup_(memstream_done) MemStream ms = {};
+                FILE *f;
 
                 /* End of this entry, so let's serialize the next
                  * one */
@@ -234,50 +245,27 @@ static ssize_t request_reader_entries(
 
                 m->n_skip = 0;
 
-                r = request_meta_ensure_tmp(m);
-                if (r < 0) {
-                        log_error_errno(r, "Failed to create temporary file: %m");
+                f = memstream_init(&ms);
+                if (!f) {
+                        log_oom();
                         return MHD_CONTENT_READER_END_WITH_ERROR;
                 }
 
-                r = show_journal_entry(m->tmp, m->journal, m->mode, 0, OUTPUT_FULL_WIDTH,
+                r = show_journal_entry(f, m->journal, m->mode, 0, OUTPUT_FULL_WIDTH,
                                    NULL, NULL, NULL, &previous_ts, &previous_boot_id);
                 if (r < 0) {
                         log_error_errno(r, "Failed to serialize item: %m");
                         return MHD_CONTENT_READER_END_WITH_ERROR;
                 }
 
-                sz = ftello(m->tmp);
-                if (sz < 0) {
-                        log_error_errno(errno, "Failed to retrieve file position: %m");
+                r = request_meta_finalize_item(m, &ms);
+                if (r < 0) {
+                        log_error_errno(r, "Failed to serialize item: %m");
                         return MHD_CONTENT_READER_END_WITH_ERROR;
                 }
-
-                m->size = (uint64_t) sz;
-        }
-
-        if (m->tmp == NULL && m->follow)
-                return 0;
-
-        if (fseeko(m->tmp, pos, SEEK_SET) < 0) {
-                log_error_errno(errno, "Failed to seek to position: %m");
-                return MHD_CONTENT_READER_END_WITH_ERROR;
-        }
-
-        n = m->size - pos;
-        if (n < 1)
-                return 0;
-        if (n > max)
-                n = max;
-
-        errno = 0;
-        k = fread(buf, 1, n, m->tmp);
-        if (k != n) {
-                log_error("Failed to read from file: %s", STRERROR_OR_EOF(errno));
-                return MHD_CONTENT_READER_END_WITH_ERROR;
         }
 
-        return (ssize_t) k;
+        return request_meta_read_item(m, pos, buf, max);
 }
 
 static int request_parse_accept(
@@ -632,7 +620,6 @@ static ssize_t request_reader_fields(
 
         RequestMeta *m = ASSERT_PTR(cls);
         int r;
-        size_t n, k;
 
         assert(buf);
         assert(max > 0);
@@ -641,8 +628,9 @@ static ssize_t request_reader_fields(
         pos -= m->delta;
 
         while (pos >= m->size) {
-                off_t sz;
+                _cleanup_(memstream_done) MemStream ms = {};
                 const void *d;
+                FILE *f;
                 size_t l;
 
                 /* End of this field, so let's serialize the next
@@ -658,44 +646,26 @@ static ssize_t request_reader_fields(
                 pos -= m->size;
                 m->delta += m->size;
 
-                r = request_meta_ensure_tmp(m);
-                if (r < 0) {
-                        log_error_errno(r, "Failed to create temporary file: %m");
+                f = memstream_init(&ms);
+                if (!f) {
+                        log_oom();
                         return MHD_CONTENT_READER_END_WITH_ERROR;
                 }
 
-                r = output_field(m->tmp, m->mode, d, l);
+                r = output_field(f, m->mode, d, l);
                 if (r < 0) {
                         log_error_errno(r, "Failed to serialize item: %m");
                         return MHD_CONTENT_READER_END_WITH_ERROR;
                 }
 
-                sz = ftello(m->tmp);
-                if (sz < 0) {
-                        log_error_errno(errno, "Failed to retrieve file position: %m");
+                r = request_meta_finalize_item(m, &ms);
+                if (r < 0) {
+                        log_error_errno(r, "Failed to serialize item: %m");
                         return MHD_CONTENT_READER_END_WITH_ERROR;
                 }
-
-                m->size = (uint64_t) sz;
-        }
-
-        if (fseeko(m->tmp, pos, SEEK_SET) < 0) {
-                log_error_errno(errno, "Failed to seek to position: %m");
-                return MHD_CONTENT_READER_END_WITH_ERROR;
-        }
-
-        n = m->size - pos;
-        if (n > max)
-                n = max;
-
-        errno = 0;
-        k = fread(buf, 1, n, m->tmp);
-        if (k != n) {
-                log_error("Failed to read from file: %s", STRERROR_OR_EOF(errno));
-                return MHD_CONTENT_READER_END_WITH_ERROR;
         }
 
-        return (ssize_t) k;
+        return request_meta_read_item(m, pos, buf, max);
 }
 
 static int request_handler_fields(
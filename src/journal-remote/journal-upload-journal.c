@@ -76,9 +76,10 @@ static ssize_t write_entry(char *buf, size_t size, Uploader *u) {
                         _fallthrough_;
                 case ENTRY_MONOTONIC: {
                         usec_t monotonic;
-                        sd_id128_t boot_id;
 
-                        r = sd_journal_get_monotonic_usec(u->journal, &monotonic, &boot_id);
+                        /* Remember the boot ID, so that we don't have to look at the entry again for
+                         * ENTRY_BOOT_ID, which might only be reached in the next callback. */
+                        r = sd_journal_get_monotonic_usec(u->journal, &monotonic, &u->current_boot_id);
                         if (r < 0)
                                 return log_error_errno(r, "Failed to get monotonic timestamp: %m");
 
@@ -101,14 +102,8 @@ static ssize_t write_entry(char *buf, size_t size, Uploader *u) {
                 }
                         _fallthrough_;
                 case ENTRY_BOOT_ID: {
-                        sd_id128_t boot_id;
-
-                        r = sd_journal_get_monotonic_usec(u->journal, NULL, &boot_id);
-                        if (r < 0)
-                                return log_error_errno(r, "Failed to get monotonic timestamp: %m");
-
                         r = snprintf(buf + pos, size - pos,
-                                     "_BOOT_ID=%s\n", SD_ID128_TO_STRING(boot_id));
+                                     "_BOOT_ID=%s\n", SD_ID128_TO_STRING(u->current_boot_id));
                         assert(r >= 0);
                         if ((size_t) r > size - pos)
                                 /* not enough space */
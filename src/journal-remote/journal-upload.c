@@ -65,6 +65,10 @@ static void close_fd_input(Uploader *u);
 
 #define SERVER_ANSWER_KEEP 2048
 
+/* Size of the buffer curl hands to the read callback. The default of 64K results in many small chunks
+ * when catching up with a backlog of entries over a slow link, hence use the maximum curl allows. */
+#define UPLOAD_BUFFER_SIZE (2L*1024L*1024L)
+
 #define STATE_FILE "/var/lib/systemd/journal-upload/state"
 
 #define easy_setopt(curl, opt, value, level, cmd)                       \
@@ -241,6 +245,16 @@ int start_upload(Uploader *u,
                 easy_setopt(curl, CURLOPT_READDATA, data,
                             LOG_ERR, return -EXFULL);
 
+#if LIBCURL_VERSION_NUM >= 0x073e00 /* libcurl 7.62.0 */
+                easy_setopt(curl, CURLOPT_UPLOAD_BUFFERSIZE, UPLOAD_BUFFER_SIZE,
+                            LOG_WARNING, );
+#endif
+
+                /* The handle and its connection are reused for subsequent uploads, make sure idle
+                 * connections are not silently dropped by firewalls and NAT in between. */
+                easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L,
+                            LOG_WARNING, );
+
                 /* use our special own mime type and chunked transfer */
                 easy_setopt(curl, CURLOPT_HTTPHEADER, u->header,
                             LOG_ERR, return -EXFULL);
@@ -45,6 +45,7 @@ typedef struct Uploader {
         entry_state entry_state;
         const void *field_data;
         size_t field_pos, field_length;
+        sd_id128_t current_boot_id;
 
         /* general metrics */
         const char *state_file;
@@ -1,9 +1,12 @@
 /* SPDX-License-Identifier: LGPL-2.1-or-later */
 
+#include "copy.h"
 #include "dirent-util.h"
 #include "fd-util.h"
 #include "format-table.h"
 #include "format-util.h"
+#include "fs-util.h"
+#include "journal-file-util.h"
 #include "journal-internal.h"
 #include "journal-verify.h"
 #include "journalctl.h"
@@ -11,6 +14,7 @@
 #include "journalctl-util.h"
 #include "logs-show.h"
 #include "syslog-util.h"
+#include "tmpfile-util.h"
 
 int action_print_header(void) {
         _cleanup_(sd_journal_closep) sd_journal *j = NULL;
@@ -79,6 +83,77 @@ int action_verify(void) {
         return r;
 }
 
+static int rewrite_archived_one(sd_journal *j, JournalFile *f) {
+        _cleanup_(unlink_and_freep) char *t = NULL;
+        JournalFile *copy;
+        uint64_t old_size, new_size;
+        int r;
+
+        assert(j);
+        assert(f);
+
+        r = tempfn_random(f->path, NULL, &t);
+        if (r < 0)
+                return log_error_errno(r, "Failed to generate temporary file name for %s: %m", f->path);
+
+        r = journal_file_rewrite(f, t, j->mmap, &copy);
+        if (r < 0)
+                return log_error_errno(r, "Failed to rewrite %s: %m", f->path);
+
+        r = copy_rights_with_fallback(f->fd, copy->fd, t);
+        if (r < 0)
+                log_warning_errno(r, "Failed to copy access mode and ownership of %s, ignoring: %m", f->path);
+
+        /* journald also sets ACLs on its files, for example to give users access to their own logs */
+        r = copy_xattr(f->fd, NULL, copy->fd, NULL, COPY_ALL_XATTRS);
+        if (r < 0)
+                log_warning_errno(r, "Failed to copy extended attributes of %s, ignoring: %m", f->path);
+
+        old_size = le64toh(f->header->header_size) + le64toh(f->header->arena_size);
+        new_size = le64toh(copy->header->header_size) + le64toh(copy->header->arena_size);
+
+        /* Make sure the copy is marked as archived when it is taken offline */
+        copy->archive = true;
+        (void) journal_file_offline_close(copy);
+
+        if (rename(t, f->path) < 0)
+                return log_error_errno(errno, "Failed to replace %s: %m", f->path);
+
+        t = mfree(t);
+
+        log_full(arg_quiet ? LOG_DEBUG : LOG_INFO, "Rewrote %s (%s → %s).",
+                 f->path, FORMAT_BYTES(old_size), FORMAT_BYTES(new_size));
+        return 0;
+}
+
+int action_rewrite_archived(void) {
+        _cleanup_(sd_journal_closep) sd_journal *j = NULL;
+        int ret = 0, r;
+
+        assert(arg_action == ACTION_REWRITE_ARCHIVED);
+
+        r = acquire_journal(&j);
+        if (r < 0)
+                return r;
+
+        JournalFile *f;
+        ORDERED_HASHMAP_FOREACH(f, j->files) {
+                if (f->header->state != STATE_ARCHIVED) {
+                        log_debug("Journal file %s is not archived, skipping.", f->path);
+                        continue;
+                }
+
+                if (JOURNAL_HEADER_SEALED(f->header)) {
+                        log_notice("Journal file %s is sealed, not rewriting it.", f->path);
+                        continue;
+                }
+
+                RET_GATHER(ret, rewrite_archived_one(j, f));
+        }
+
+        return ret;
+}
+
 int action_disk_usage(void) {
         _cleanup_(sd_journal_closep) sd_journal *j = NULL;
         uint64_t bytes = 0;
@@ -5,6 +5,7 @@
 
 int action_print_header(void);
 int action_verify(void);
+int action_rewrite_archived(void);
 int action_disk_usage(void);
 int action_list_boots(void);
 int action_list_fields(void);
@@ -14,6 +14,7 @@
 #include "terminal-util.h"
 
 #define PROCESS_INOTIFY_INTERVAL 1024   /* Every 1024 messages processed */
+#define STDOUT_BUFFER_SIZE (256U*1024U)  /* Output buffer when not writing to a terminal */
 
 typedef struct Context {
         sd_journal *journal;
@@ -411,9 +412,21 @@ int action_show(char **matches) {
                         return log_error_errno(poll_fd, "Failed to get journal fd: %m");
         }
 
-        if (!arg_follow)
+        if (!arg_follow) {
                 pager_open(arg_pager_flags);
 
+                /* When dumping into a pipe or file, stdio's default buffer (usually a page) means one write()
+                 * per few entries, hence use a larger buffer. Note that once the pager is running stdout is a
+                 * pipe to it, but the output is shown interactively then, so keep the default buffering. */
+                if (!pager_have() && !isatty_safe(STDOUT_FILENO)) {
+                        /* glibc ignores the size unless we pass our own buffer. It must stay valid until
+                         * stdout is flushed on exit, hence make it static. */
+                        static char stdout_buffer[STDOUT_BUFFER_SIZE];
+
+                        (void) setvbuf(stdout, stdout_buffer, _IOFBF, sizeof(stdout_buffer));
+                }
+        }
+
         if (!arg_quiet && (arg_lines != 0 || arg_follow) && DEBUG_LOGGING) {
                 usec_t start, end;
                 char start_buf[FORMAT_TIMESTAMP_MAX], end_buf[FORMAT_TIMESTAMP_MAX];
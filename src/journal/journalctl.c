@@ -287,6 +287,7 @@ static int help(void) {
                "     --vacuum-files=INT      Leave only the specified number of journal files\n"
                "     --vacuum-time=TIME      Remove journal files older than specified time\n"
                "     --verify                Verify journal file consistency\n"
+               "     --rewrite-archived      Rewrite archived journal files for faster reading\n"
                "     --sync                  Synchronize unwritten journal messages to disk\n"
                "     --relinquish-var        Stop logging to disk, log to temporary file system\n"
                "     --smart-relinquish-var  Similar, but NOP if log directory is on root mount\n"
@@ -330,6 +331,7 @@ static int parse_argv(int argc, char *argv[]) {
                 ARG_INTERVAL,
                 ARG_VERIFY,
                 ARG_VERIFY_KEY,
+                ARG_REWRITE_ARCHIVED,
                 ARG_DISK_USAGE,
                 ARG_AFTER_CURSOR,
                 ARG_CURSOR_FILE,
@@ -397,6 +399,7 @@ static int parse_argv(int argc, char *argv[]) {
                 { "interval",             required_argument, NULL, ARG_INTERVAL             },
                 { "verify",               no_argument,       NULL, ARG_VERIFY               },
                 { "verify-key",           required_argument, NULL, ARG_VERIFY_KEY           },
+                { "rewrite-archived",     no_argument,       NULL, ARG_REWRITE_ARCHIVED     },
                 { "disk-usage",           no_argument,       NULL, ARG_DISK_USAGE           },
                 { "cursor",               required_argument, NULL, 'c'                      },
                 { "cursor-file",          required_argument, NULL, ARG_CURSOR_FILE          },
@@ -672,6 +675,10 @@ static int parse_argv(int argc, char *argv[]) {
                         arg_action = ACTION_VERIFY;
                         break;
 
+                case ARG_REWRITE_ARCHIVED:
+                        arg_action = ACTION_REWRITE_ARCHIVED;
+                        break;
+
                 case ARG_DISK_USAGE:
                         arg_action = ACTION_DISK_USAGE;
                         break;
@@ -1120,6 +1127,9 @@ static int run(int argc, char *argv[]) {
         case ACTION_VERIFY:
                 return action_verify();
 
+        case ACTION_REWRITE_ARCHIVED:
+                return action_rewrite_archived();
+
         case ACTION_DISK_USAGE:
                 return action_disk_usage();
 
@@ -22,6 +22,7 @@ typedef enum JournalctlAction {
         ACTION_UPDATE_CATALOG,
         ACTION_PRINT_HEADER,
         ACTION_VERIFY,
+        ACTION_REWRITE_ARCHIVED,
         ACTION_DISK_USAGE,
         ACTION_LIST_BOOTS,
         ACTION_LIST_FIELDS,
@@ -20,6 +20,7 @@
 #include "path-util.h"
 #include "process-util.h"
 #include "procfs-util.h"
+#include "stdio-util.h"
 #include "string-util.h"
 #include "syslog-util.h"
 #include "unaligned.h"
@@ -61,6 +62,9 @@
 /* Data older than 5s we flush out */
 #define MAX_USEC (5*USEC_PER_SEC)
 
+/* Keep at most this many entries in the per-cgroup cache */
+#define CGROUP_DATA_MAX 1024U
+
 /* Keep at most 16K entries in the cache. (Note though that this limit may be violated if enough streams pin entries in
  * the cache, in which case we *do* permit this limit to be breached. That's safe however, as the number of stream
  * clients itself is limited.) */
@@ -92,6 +96,188 @@ static size_t cache_max(void) {
         return cached;
 }
 
+/* The metadata read from the per-unit files in /run/systemd/units/ is the same for all processes of a unit.
+ * When many short-lived processes of the same unit log, each of them gets a new client context, and we'd
+ * read the same files over and over again. Hence we cache what we read per cgroup path, for the same time we
+ * cache a client context for before refreshing it. A restarted unit keeps its cgroup path but gets a new
+ * invocation ID, and PID 1 rewrites the per-unit files when starting it, hence an entry is only valid for
+ * the invocation it was read for. The invocation ID itself is always read. */
+typedef struct ClientCgroupData {
+        char *cgroup;
+        usec_t timestamp;
+
+        sd_id128_t invocation_id;
+        int log_level_max;
+
+        struct iovec *extra_fields_iovec;
+        size_t extra_fields_n_iovec;
+        void *extra_fields_data;
+        nsec_t extra_fields_mtime;
+
+        usec_t log_ratelimit_interval;
+        unsigned log_ratelimit_burst;
+} ClientCgroupData;
+
+static ClientCgroupData* client_cgroup_data_free(ClientCgroupData *d) {
+        if (!d)
+                return NULL;
+
+        free(d->cgroup);
+        free(d->extra_fields_iovec);
+        free(d->extra_fields_data);
+        return mfree(d);
+}
+
+DEFINE_TRIVIAL_CLEANUP_FUNC(ClientCgroupData*, client_cgroup_data_free);
+
+DEFINE_PRIVATE_HASH_OPS_WITH_VALUE_DESTRUCTOR(
+        client_cgroup_data_hash_ops,
+        char,
+        path_hash_func,
+        path_compare,
+        ClientCgroupData,
+        client_cgroup_data_free);
+
+static int copy_extra_fields(
+                const struct iovec *iovec,
+                size_t n_iovec,
+                const void *data,
+                struct iovec **ret_iovec,
+                void **ret_data) {
+
+        _cleanup_free_ struct iovec *copy_iovec = NULL;
+        _cleanup_free_ void *copy_data = NULL;
+        size_t size;
+
+        assert(iovec || n_iovec == 0);
+        assert(ret_iovec);
+        assert(ret_data);
+
+        if (n_iovec == 0) {
+                *ret_iovec = NULL;
+                *ret_data = NULL;
+                return 0;
+        }
+
+        /* The fields are stored back to back in the data blob, each prefixed by its size, see
+         * client_context_read_extra_fields(). Hence the last one tells us how much to copy. */
+        size = (const uint8_t*) iovec[n_iovec - 1].iov_base + iovec[n_iovec - 1].iov_len - (const uint8_t*) data;
+
+        copy_data = memdup(data, size);
+        if (!copy_data)
+                return -ENOMEM;
+
+        copy_iovec = newdup(struct iovec, iovec, n_iovec);
+        if (!copy_iovec)
+                return -ENOMEM;
+
+        FOREACH_ARRAY(i, copy_iovec, n_iovec)
+                i->iov_base = (uint8_t*) copy_data + ((uint8_t*) i->iov_base - (const uint8_t*) data);
+
+        *ret_iovec = TAKE_PTR(copy_iovec);
+        *ret_data = TAKE_PTR(copy_data);
+        return 0;
+}
+
+static int client_cgroup_data_apply(Server *s, ClientContext *c, usec_t timestamp) {
+        _cleanup_free_ struct iovec *iovec = NULL;
+        _cleanup_free_ void *data = NULL;
+        ClientCgroupData *d;
+        int r;
+
+        assert(s);
+        assert(c);
+
+        /* Returns > 0 if we found fresh data for the cgroup and invocation of the client and applied it, 0
+         * otherwise */
+
+        if (!c->cgroup || sd_id128_is_null(c->invocation_id))
+                return 0;
+
+        d = hashmap_get(s->client_cgroup_data, c->cgroup);
+        if (!d || d->timestamp + REFRESH_USEC < timestamp)
+                return 0;
+        if (!sd_id128_equal(d->invocation_id, c->invocation_id))
+                return 0;
+
+        if (d->extra_fields_mtime != c->extra_fields_mtime) {
+                r = copy_extra_fields(d->extra_fields_iovec, d->extra_fields_n_iovec, d->extra_fields_data, &iovec, &data);
+                if (r < 0)
+                        return r;
+
+                free_and_replace(c->extra_fields_iovec, iovec);
+                c->extra_fields_n_iovec = d->extra_fields_n_iovec;
+                free_and_replace(c->extra_fields_data, data);
+                c->extra_fields_mtime = d->extra_fields_mtime;
+        }
+
+        /* Apply the values as they were read, including unset ones, so that nothing of a previous
+         * invocation survives */
+        c->log_level_max = d->log_level_max;
+        c->log_ratelimit_interval = d->log_ratelimit_interval;
+        c->log_ratelimit_burst = d->log_ratelimit_burst;
+
+        return 1;
+}
+
+static void client_cgroup_data_flush_stale(Server *s, usec_t timestamp) {
+        ClientCgroupData *d;
+
+        assert(s);
+
+        HASHMAP_FOREACH(d, s->client_cgroup_data)
+                if (d->timestamp + REFRESH_USEC < timestamp)
+                        client_cgroup_data_free(hashmap_remove(s->client_cgroup_data, d->cgroup));
+}
+
+static int client_cgroup_data_store(Server *s, const ClientContext *c, usec_t timestamp) {
+        _cleanup_(client_cgroup_data_freep) ClientCgroupData *d = NULL;
+        int r;
+
+        assert(s);
+        assert(c);
+
+        if (!c->cgroup || sd_id128_is_null(c->invocation_id))
+                return 0;
+
+        if (hashmap_size(s->client_cgroup_data) >= CGROUP_DATA_MAX)
+                client_cgroup_data_flush_stale(s, timestamp);
+        if (hashmap_size(s->client_cgroup_data) >= CGROUP_DATA_MAX)
+                return 0; /* Still full? Then let's not bother */
+
+        d = new(ClientCgroupData, 1);
+        if (!d)
+                return -ENOMEM;
+
+        *d = (ClientCgroupData) {
+                .timestamp = timestamp,
+                .invocation_id = c->invocation_id,
+                .log_level_max = c->log_level_max,
+                .extra_fields_n_iovec = c->extra_fields_n_iovec,
+                .extra_fields_mtime = c->extra_fields_mtime,
+                .log_ratelimit_interval = c->log_ratelimit_interval,
+                .log_ratelimit_burst = c->log_ratelimit_burst,
+        };
+
+        d->cgroup = strdup(c->cgroup);
+        if (!d->cgroup)
+                return -ENOMEM;
+
+        r = copy_extra_fields(c->extra_fields_iovec, c->extra_fields_n_iovec, c->extra_fields_data,
+                              &d->extra_fields_iovec, &d->extra_fields_data);
+        if (r < 0)
+                return r;
+
+        client_cgroup_data_free(hashmap_remove(s->client_cgroup_data, d->cgroup));
+
+        r = hashmap_ensure_put(&s->client_cgroup_data, &client_cgroup_data_hash_ops, d->cgroup, d);
+        if (r < 0)
+                return r;
+
+        TAKE_PTR(d);
+        return 0;
+}
+
 static int client_context_compare(const void *a, const void *b) {
         const ClientContext *x = a, *y = b;
         int r;
@@ -177,6 +363,11 @@ static void client_context_reset(Server *s, ClientContext *c) {
         c->extra_fields_data = mfree(c->extra_fields_data);
         c->extra_fields_mtime = NSEC_INFINITY;
 
+        iovec_array_free(c->meta_iovec, c->meta_n_iovec);
+        c->meta_iovec = NULL;
+        c->meta_n_iovec = 0;
+        c->meta_valid = false;
+
         c->log_level_max = -1;
 
         c->log_ratelimit_interval = s->ratelimit_interval;
@@ -507,6 +698,94 @@ static int client_context_read_log_ratelimit_burst(ClientContext *c) {
         return safe_atou(value, &c->log_ratelimit_burst);
 }
 
+static int client_context_add_meta_field(ClientContext *c, const char *field, const void *value, size_t size) {
+        char *k;
+
+        assert(c);
+        assert(field);
+        assert(value || size == 0);
+
+        if (size == 0)
+                return 0;
+
+        if (!GREEDY_REALLOC(c->meta_iovec, c->meta_n_iovec + 1))
+                return -ENOMEM;
+
+        k = malloc(strlen(field) + 1 + size + 1);
+        if (!k)
+                return -ENOMEM;
+
+        *(char*) mempcpy(stpcpy(stpcpy(k, field), "="), value, size) = 0;
+        c->meta_iovec[c->meta_n_iovec++] = IOVEC_MAKE_STRING(k);
+        return 0;
+}
+
+static int client_context_add_meta_string(ClientContext *c, const char *field, const char *value) {
+        return client_context_add_meta_field(c, field, value, strlen_ptr(value));
+}
+
+static int client_context_add_meta_uid(ClientContext *c, const char *field, uid_t uid) {
+        char buf[DECIMAL_STR_MAX(uid_t)];
+
+        if (!uid_is_valid(uid))
+                return 0;
+
+        xsprintf(buf, UID_FMT, uid);
+        return client_context_add_meta_string(c, field, buf);
+}
+
+static void client_context_build_meta(ClientContext *c) {
+        char buf[MAX(DECIMAL_STR_MAX(uint64_t), SD_ID128_STRING_MAX)];
+        int r = 0;
+
+        assert(c);
+
+        iovec_array_free(c->meta_iovec, c->meta_n_iovec);
+        c->meta_iovec = NULL;
+        c->meta_n_iovec = 0;
+
+        /* Keep this in sync with N_IOVEC_META_FIELDS */
+
+        if (pid_is_valid(c->pid)) {
+                xsprintf(buf, PID_FMT, c->pid);
+                RET_GATHER(r, client_context_add_meta_string(c, "_PID", buf));
+        }
+        RET_GATHER(r, client_context_add_meta_uid(c, "_UID", c->uid));
+        if (gid_is_valid(c->gid)) {
+                xsprintf(buf, GID_FMT, c->gid);
+                RET_GATHER(r, client_context_add_meta_string(c, "_GID", buf));
+        }
+
+        RET_GATHER(r, client_context_add_meta_string(c, "_COMM", c->comm));
+        RET_GATHER(r, client_context_add_meta_string(c, "_EXE", c->exe));
+        RET_GATHER(r, client_context_add_meta_string(c, "_CMDLINE", c->cmdline));
+        RET_GATHER(r, client_context_add_meta_string(c, "_CAP_EFFECTIVE", c->capeff));
+        RET_GATHER(r, client_context_add_meta_field(c, "_SELINUX_CONTEXT", c->label, c->label_size));
+        if (audit_session_is_valid(c->auditid)) {
+                xsprintf(buf, "%" PRIu32, c->auditid);
+                RET_GATHER(r, client_context_add_meta_string(c, "_AUDIT_SESSION", buf));
+        }
+        RET_GATHER(r, client_context_add_meta_uid(c, "_AUDIT_LOGINUID", c->loginuid));
+
+        RET_GATHER(r, client_context_add_meta_string(c, "_SYSTEMD_CGROUP", c->cgroup));
+        RET_GATHER(r, client_context_add_meta_string(c, "_SYSTEMD_SESSION", c->session));
+        RET_GATHER(r, client_context_add_meta_uid(c, "_SYSTEMD_OWNER_UID", c->owner_uid));
+        RET_GATHER(r, client_context_add_meta_string(c, "_SYSTEMD_UNIT", c->unit));
+        RET_GATHER(r, client_context_add_meta_string(c, "_SYSTEMD_USER_UNIT", c->user_unit));
+        RET_GATHER(r, client_context_add_meta_string(c, "_SYSTEMD_SLICE", c->slice));
+        RET_GATHER(r, client_context_add_meta_string(c, "_SYSTEMD_USER_SLICE", c->user_slice));
+
+        if (!sd_id128_is_null(c->invocation_id))
+                RET_GATHER(r, client_context_add_meta_string(c, "_SYSTEMD_INVOCATION_ID", sd_id128_to_string(c->invocation_id, buf)));
+
+        /* If this fails we'll try again on the next message, see client_context_maybe_refresh(). */
+        c->meta_valid = r >= 0;
+        if (r < 0)
+                log_ratelimit_warning_errno(r, JOURNAL_LOG_RATELIMIT,
+                                            "Failed to format metadata fields of client context for PID " PID_FMT ", ignoring: %m",
+                                            c->pid);
+}
+
 static void client_context_really_refresh(
                 Server *s,
                 ClientContext *c,
@@ -530,11 +809,19 @@ static void client_context_really_refresh(
         (void) audit_loginuid_from_pid(c->pid, &c->loginuid);
 
         (void) client_context_read_cgroup(s, c, unit_id);
+
         (void) client_context_read_invocation_id(s, c);
-        (void) client_context_read_log_level_max(s, c);
-        (void) client_context_read_extra_fields(s, c);
-        (void) client_context_read_log_ratelimit_interval(c);
-        (void) client_context_read_log_ratelimit_burst(c);
+
+        if (client_cgroup_data_apply(s, c, timestamp) <= 0) {
+                (void) client_context_read_log_level_max(s, c);
+                (void) client_context_read_extra_fields(s, c);
+                (void) client_context_read_log_ratelimit_interval(c);
+                (void) client_context_read_log_ratelimit_burst(c);
+
+                (void) client_cgroup_data_store(s, c, timestamp);
+        }
+
+        client_context_build_meta(c);
 
         c->timestamp = timestamp;
 
@@ -583,6 +870,10 @@ void client_context_maybe_refresh(
         if (label_size > 0 && (label_size != c->label_size || memcmp(label, c->label, label_size) != 0))
                 goto refresh;
 
+        /* If we failed to format the metadata fields the last time, try again */
+        if (!c->meta_valid)
+                goto refresh;
+
         return;
 
 refresh:
@@ -638,6 +929,8 @@ static void client_context_try_shrink_to(Server *s, size_t limit) {
 
 void client_context_flush_regular(Server *s) {
         client_context_try_shrink_to(s, 0);
+
+        s->client_cgroup_data = hashmap_free(s->client_cgroup_data);
 }
 
 void client_context_flush_all(Server *s) {
@@ -678,16 +971,8 @@ static int client_context_get_internal(
         c = hashmap_get(s->client_contexts, PID_TO_PTR(pid));
         if (c) {
 
-                if (add_ref) {
-                        if (c->in_lru) {
-                                /* The entry wasn't pinned so far, let's remove it from the LRU list then */
-                                assert(c->n_ref == 0);
-                                assert_se(prioq_remove(s->client_contexts_lru, c, &c->lru_index) >= 0);
-                                c->in_lru = false;
-                        }
-
-                        c->n_ref++;
-                }
+                if (add_ref)
+                        client_context_pin(s, c);
 
                 client_context_maybe_refresh(s, c, ucred, label, label_len, unit_id, USEC_INFINITY);
 
@@ -741,6 +1026,20 @@ int client_context_acquire(
         return client_context_get_internal(s, pid, ucred, label, label_len, unit_id, true, ret);
 };
 
+void client_context_pin(Server *s, ClientContext *c) {
+        assert(s);
+        assert(c);
+
+        if (c->in_lru) {
+                /* The entry wasn't pinned so far, let's remove it from the LRU list then */
+                assert(c->n_ref == 0);
+                assert_se(prioq_remove(s->client_contexts_lru, c, &c->lru_index) >= 0);
+                c->in_lru = false;
+        }
+
+        c->n_ref++;
+}
+
 ClientContext *client_context_release(Server *s, ClientContext *c) {
         assert(s);
 
@@ -54,6 +54,12 @@ struct ClientContext {
         void *extra_fields_data;
         nsec_t extra_fields_mtime;
 
+        /* The _PID=, _UID=, _COMM=, … fields derived from the above, formatted once on each refresh so that
+         * we don't have to do that again for each message */
+        struct iovec *meta_iovec;
+        size_t meta_n_iovec;
+        bool meta_valid;
+
         usec_t log_ratelimit_interval;
         unsigned log_ratelimit_burst;
 
@@ -77,6 +83,7 @@ int client_context_acquire(
                 const char *unit_id,
                 ClientContext **ret);
 
+void client_context_pin(Server *s, ClientContext *c);
 ClientContext* client_context_release(Server *s, ClientContext *c);
 
 void client_context_maybe_refresh(
@@ -26,6 +26,12 @@
 #include "stdio-util.h"
 #include "string-util.h"
 
+/* How many records to read from /dev/kmsg per wakeup */
+#define DEV_KMSG_BATCH_MAX 64U
+
+/* How long to reuse a device looked up for a kernel message */
+#define KMSG_DEVICE_CACHE_USEC (1 * USEC_PER_SEC)
+
 void server_forward_kmsg(
                 Server *s,
                 int priority,
@@ -96,6 +102,34 @@ static bool is_us(const char *identifier, const char *pid) {
                streq(identifier, program_invocation_short_name);
 }
 
+static sd_device* kmsg_get_device(Server *s, const char *id) {
+        const char *cached;
+        usec_t n;
+
+        assert(s);
+        assert(id);
+
+        /* Floods of kernel messages usually originate from a single device, hence remember the device we
+         * looked up last, instead of reading its sysfs and udev database entries again for every message.
+         * Only reuse it for a short while though, so that renamed devices and changed device links are picked
+         * up quickly. */
+
+        n = now(CLOCK_MONOTONIC);
+        if (s->kmsg_device &&
+            n < usec_add(s->kmsg_device_timestamp, KMSG_DEVICE_CACHE_USEC) &&
+            sd_device_get_device_id(s->kmsg_device, &cached) >= 0 &&
+            streq(cached, id))
+                return s->kmsg_device;
+
+        s->kmsg_device = sd_device_unref(s->kmsg_device);
+
+        if (sd_device_new_from_device_id(&s->kmsg_device, id) < 0)
+                return NULL;
+
+        s->kmsg_device_timestamp = n;
+        return s->kmsg_device;
+}
+
 void dev_kmsg_record(Server *s, char *p, size_t l) {
 
         _cleanup_free_ char *message = NULL, *syslog_pid = NULL, *syslog_identifier = NULL, *identifier = NULL, *pid = NULL;
@@ -214,9 +248,10 @@ void dev_kmsg_record(Server *s, char *p, size_t l) {
         }
 
         if (kernel_device) {
-                _cleanup_(sd_device_unrefp) sd_device *d = NULL;
+                sd_device *d;
 
-                if (sd_device_new_from_device_id(&d, kernel_device) >= 0) {
+                d = kmsg_get_device(s, kernel_device);
+                if (d) {
                         const char *g;
                         char *b;
 
@@ -371,6 +406,7 @@ int server_flush_dev_kmsg(Server *s) {
 
 static int dispatch_dev_kmsg(sd_event_source *es, int fd, uint32_t revents, void *userdata) {
         Server *s = ASSERT_PTR(userdata);
+        int r;
 
         assert(es);
         assert(fd == s->dev_kmsg_fd);
@@ -382,7 +418,16 @@ static int dispatch_dev_kmsg(sd_event_source *es, int fd, uint32_t revents, void
         if (!(revents & EPOLLIN))
                 log_error("Got invalid event from epoll for /dev/kmsg: %"PRIx32, revents);
 
-        return server_read_dev_kmsg(s);
+        /* Every read() returns exactly one record. Read a bounded batch of them per wakeup, so that we keep
+         * up with floods of kernel messages without starving the other event sources. The event source is
+         * level triggered, hence we'll be called again if there's more. */
+        for (unsigned i = 0; i < DEV_KMSG_BATCH_MAX; i++) {
+                r = server_read_dev_kmsg(s);
+                if (r <= 0)
+                        return r;
+        }
+
+        return 0;
 }
 
 int server_open_dev_kmsg(Server *s) {
@@ -121,6 +121,30 @@ static int journal_ratelimit_group_new(
         return 0;
 }
 
+static int journal_ratelimit_group_bump(JournalRateLimitGroup *g) {
+        int r;
+
+        assert(g);
+        assert(g->groups_by_id);
+
+        /* Moves the group to the end of the hashmap, whenever one of its pools starts a new interval. This
+         * keeps the hashmap ordered by the time the groups become expired (at least for groups with the same
+         * interval), so that journal_ratelimit_vacuum() finds expired groups at the front, and when it has
+         * to make room, flushes out groups that were idle the longest, not the ones created first. */
+
+        assert_se(ordered_hashmap_remove(g->groups_by_id, g->id) == g);
+
+        r = ordered_hashmap_put(g->groups_by_id, g->id, g);
+        if (r < 0) {
+                /* Already removed from the hashmap, hence unset it so it isn't removed another time */
+                g->groups_by_id = NULL;
+                journal_ratelimit_group_free(g);
+                return r;
+        }
+
+        return 0;
+}
+
 static int journal_ratelimit_group_acquire(
                 OrderedHashmap **groups_by_id,
                 const char *id,
@@ -178,16 +202,17 @@ int journal_ratelimit_test(
                 usec_t rl_interval,
                 unsigned rl_burst,
                 int priority,
-                uint64_t available) {
+                uint64_t available,
+                usec_t ts) {
 
         JournalRateLimitGroup *g;
         JournalRateLimitPool *p;
         unsigned burst;
-        usec_t ts;
         int r;
 
         assert(groups_by_id);
         assert(id);
+        assert(timestamp_is_set(ts));
 
         /* Returns:
          *
@@ -196,8 +221,6 @@ int journal_ratelimit_test(
          * < 0   → error
          */
 
-        ts = now(CLOCK_MONOTONIC);
-
         r = journal_ratelimit_group_acquire(groups_by_id, id, rl_interval, ts, &g);
         if (r < 0)
                 return r;
@@ -210,6 +233,10 @@ int journal_ratelimit_test(
         p = &g->pools[priority_map[priority]];
 
         if (p->begin <= 0) {
+                r = journal_ratelimit_group_bump(g);
+                if (r < 0)
+                        return r;
+
                 p->suppressed = 0;
                 p->num = 1;
                 p->begin = ts;
@@ -219,6 +246,10 @@ int journal_ratelimit_test(
         if (usec_add(p->begin, rl_interval) < ts) {
                 unsigned s;
 
+                r = journal_ratelimit_group_bump(g);
+                if (r < 0)
+                        return r;
+
                 s = p->suppressed;
                 p->suppressed = 0;
                 p->num = 1;
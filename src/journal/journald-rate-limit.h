@@ -12,4 +12,5 @@ int journal_ratelimit_test(
                 usec_t rl_interval,
                 unsigned rl_burst,
                 int priority,
-                uint64_t available);
+                uint64_t available,
+                usec_t ts);
@@ -61,6 +61,7 @@
 #include "string-table.h"
 #include "string-util.h"
 #include "syslog-util.h"
+#include "trace-util.h"
 #include "uid-classification.h"
 #include "user-util.h"
 #include "varlink-io.systemd.Journal.h"
@@ -90,6 +91,10 @@
 
 #define IDLE_TIMEOUT_USEC (30*USEC_PER_SEC)
 
+/* The maximum number of datagrams to process per event loop iteration on the native, syslog and audit
+ * sockets */
+#define DATAGRAM_BATCH_MAX 64U
+
 #define FAILED_TO_WRITE_ENTRY_RATELIMIT ((const RateLimit) { .interval = 1 * USEC_PER_SEC, .burst = 1 })
 
 static int server_schedule_sync(Server *s, int priority);
@@ -1004,6 +1009,7 @@ static void server_write_to_journal(
                         /* ret_object= */ NULL,
                         /* ret_offset= */ NULL);
         if (r >= 0) {
+                TRACE_POINT(journald, message_written, f->path, s->seqnum->seqnum, priority, n);
                 server_schedule_sync(s, priority);
                 return;
         }
@@ -1039,8 +1045,10 @@ static void server_write_to_journal(
                 log_ratelimit_error_errno(r, FAILED_TO_WRITE_ENTRY_RATELIMIT,
                                           "Failed to write entry to %s (%zu items, %zu bytes) despite vacuuming, ignoring: %m",
                                           f->path, n, iovec_total_size(iovec, n));
-        else
+        else {
+                TRACE_POINT(journald, message_written, f->path, s->seqnum->seqnum, priority, n);
                 server_schedule_sync(s, priority);
+        }
 }
 
 #define IOVEC_ADD_NUMERIC_FIELD(iovec, n, value, type, isset, format, field)  \
@@ -1077,13 +1085,13 @@ static void server_write_to_journal(
 static void server_dispatch_message_real(
                 Server *s,
                 struct iovec *iovec, size_t n, size_t m,
-                const ClientContext *c,
+                ClientContext *c,
                 const struct timeval *tv,
                 int priority,
                 pid_t object_pid) {
 
         char source_time[STRLEN("_SOURCE_REALTIME_TIMESTAMP=") + DECIMAL_STR_MAX(usec_t)];
-        _unused_ _cleanup_free_ char *cmdline1 = NULL, *cmdline2 = NULL;
+        _unused_ _cleanup_free_ char *cmdline = NULL;
         uid_t journal_uid;
         ClientContext *o;
 
@@ -1096,32 +1104,9 @@ static void server_dispatch_message_real(
                client_context_extra_fields_n_iovec(c) <= m);
 
         if (c) {
-                IOVEC_ADD_NUMERIC_FIELD(iovec, n, c->pid, pid_t, pid_is_valid, PID_FMT, "_PID");
-                IOVEC_ADD_NUMERIC_FIELD(iovec, n, c->uid, uid_t, uid_is_valid, UID_FMT, "_UID");
-                IOVEC_ADD_NUMERIC_FIELD(iovec, n, c->gid, gid_t, gid_is_valid, GID_FMT, "_GID");
-
-                IOVEC_ADD_STRING_FIELD(iovec, n, c->comm, "_COMM"); /* At most TASK_COMM_LENGTH (16 bytes) */
-                IOVEC_ADD_STRING_FIELD(iovec, n, c->exe, "_EXE"); /* A path, so at most PATH_MAX (4096 bytes) */
-
-                if (c->cmdline)
-                        /* At most _SC_ARG_MAX (2MB usually), which is too much to put on stack.
-                         * Let's use a heap allocation for this one. */
-                        cmdline1 = set_iovec_string_field(iovec, &n, "_CMDLINE=", c->cmdline);
-
-                IOVEC_ADD_STRING_FIELD(iovec, n, c->capeff, "_CAP_EFFECTIVE"); /* Read from /proc/.../status */
-                IOVEC_ADD_SIZED_FIELD(iovec, n, c->label, c->label_size, "_SELINUX_CONTEXT");
-                IOVEC_ADD_NUMERIC_FIELD(iovec, n, c->auditid, uint32_t, audit_session_is_valid, "%" PRIu32, "_AUDIT_SESSION");
-                IOVEC_ADD_NUMERIC_FIELD(iovec, n, c->loginuid, uid_t, uid_is_valid, UID_FMT, "_AUDIT_LOGINUID");
-
-                IOVEC_ADD_STRING_FIELD(iovec, n, c->cgroup, "_SYSTEMD_CGROUP"); /* A path */
-                IOVEC_ADD_STRING_FIELD(iovec, n, c->session, "_SYSTEMD_SESSION");
-                IOVEC_ADD_NUMERIC_FIELD(iovec, n, c->owner_uid, uid_t, uid_is_valid, UID_FMT, "_SYSTEMD_OWNER_UID");
-                IOVEC_ADD_STRING_FIELD(iovec, n, c->unit, "_SYSTEMD_UNIT"); /* Unit names are bounded by UNIT_NAME_MAX */
-                IOVEC_ADD_STRING_FIELD(iovec, n, c->user_unit, "_SYSTEMD_USER_UNIT");
-                IOVEC_ADD_STRING_FIELD(iovec, n, c->slice, "_SYSTEMD_SLICE");
-                IOVEC_ADD_STRING_FIELD(iovec, n, c->user_slice, "_SYSTEMD_USER_SLICE");
-
-                IOVEC_ADD_ID128_FIELD(iovec, n, c->invocation_id, "_SYSTEMD_INVOCATION_ID");
+                /* Preformatted by client_context_build_meta() */
+                memcpy_safe(iovec + n, c->meta_iovec, c->meta_n_iovec * sizeof(struct iovec));
+                n += c->meta_n_iovec;
 
                 if (c->extra_fields_n_iovec > 0) {
                         memcpy(iovec + n, c->extra_fields_iovec, c->extra_fields_n_iovec * sizeof(struct iovec));
@@ -1131,7 +1116,20 @@ static void server_dispatch_message_real(
 
         assert(n <= m);
 
-        if (pid_is_valid(object_pid) && client_context_get(s, object_pid, NULL, NULL, 0, NULL, &o) >= 0) {
+        /* Looking up the object's context might refresh or flush out entries of the cache, including our
+         * own, whose fields we reference above. Hence pin it while we are at it, and don't look it up again
+         * if it's the same process. */
+        if (c && pid_is_valid(object_pid))
+                client_context_pin(s, c);
+
+        if (!pid_is_valid(object_pid))
+                o = NULL;
+        else if (c && c->pid == object_pid)
+                o = c;
+        else if (client_context_get(s, object_pid, NULL, NULL, 0, NULL, &o) < 0)
+                o = NULL;
+
+        if (o) {
 
                 IOVEC_ADD_NUMERIC_FIELD(iovec, n, o->pid, pid_t, pid_is_valid, PID_FMT, "OBJECT_PID");
                 IOVEC_ADD_NUMERIC_FIELD(iovec, n, o->uid, uid_t, uid_is_valid, UID_FMT, "OBJECT_UID");
@@ -1141,7 +1139,7 @@ static void server_dispatch_message_real(
                 IOVEC_ADD_STRING_FIELD(iovec, n, o->comm, "OBJECT_COMM");
                 IOVEC_ADD_STRING_FIELD(iovec, n, o->exe, "OBJECT_EXE");
                 if (o->cmdline)
-                        cmdline2 = set_iovec_string_field(iovec, &n, "OBJECT_CMDLINE=", o->cmdline);
+                        cmdline = set_iovec_string_field(iovec, &n, "OBJECT_CMDLINE=", o->cmdline);
 
                 IOVEC_ADD_STRING_FIELD(iovec, n, o->capeff, "OBJECT_CAP_EFFECTIVE");
                 IOVEC_ADD_SIZED_FIELD(iovec, n, o->label, o->label_size, "OBJECT_SELINUX_CONTEXT");
@@ -1206,6 +1204,9 @@ static void server_dispatch_message_real(
         (void) server_forward_socket(s, iovec, n, &ts, priority);
 
         server_write_to_journal(s, journal_uid, iovec, n, &ts, priority);
+
+        if (c && pid_is_valid(object_pid))
+                client_context_release(s, c);
 }
 
 void server_driver_message(Server *s, pid_t object_pid, const char *message_id, const char *format, ...) {
@@ -1275,6 +1276,9 @@ void server_dispatch_message(
         if (n == 0)
                 return;
 
+        /* Arguments: unit, pid, priority, number of fields */
+        TRACE_POINT(journald, message_received, c ? c->unit : NULL, c ? c->pid : 0, priority, n);
+
         if (LOG_PRI(priority) > s->max_level_store)
                 return;
 
@@ -1292,9 +1296,12 @@ void server_dispatch_message(
                                 c->log_ratelimit_interval,
                                 c->log_ratelimit_burst,
                                 LOG_PRI(priority),
-                                available);
-                if (rl == 0)
+                                available,
+                                now(CLOCK_MONOTONIC));
+                if (rl == 0) {
+                        TRACE_POINT(journald, message_dropped, c->unit, c->pid, priority);
                         return;
+                }
 
                 /* Write a suppression message if we suppressed something */
                 if (rl > 1)
@@ -1487,14 +1494,8 @@ static int server_relinquish_var(Server *s) {
         return 0;
 }
 
-int server_process_datagram(
-                sd_event_source *es,
-                int fd,
-                uint32_t revents,
-                void *userdata) {
-
+static int server_receive_datagram(Server *s, int fd) {
         size_t label_len = 0, m;
-        Server *s = ASSERT_PTR(userdata);
         struct ucred *ucred = NULL;
         struct timeval tv_buf, *tv = NULL;
         struct cmsghdr *cmsg;
@@ -1527,12 +1528,10 @@ int server_process_datagram(
                 .msg_namelen = sizeof(sa),
         };
 
+        assert(s);
         assert(fd == s->native_fd || fd == s->syslog_fd || fd == s->audit_fd);
 
-        if (revents != EPOLLIN)
-                return log_error_errno(SYNTHETIC_ERRNO(EIO),
-                                       "Got invalid event from epoll for datagram fd: %" PRIx32,
-                                       revents);
+        /* Returns 0 if there was nothing to read, > 0 if a datagram was consumed (processed or not). */
 
         /* Try to get the right size, if we can. (Not all sockets support SIOCINQ, hence we just try, but don't rely on
          * it.) */
@@ -1554,11 +1553,11 @@ int server_process_datagram(
         if (n == -ECHRNG) {
                 log_ratelimit_warning_errno(n, JOURNAL_LOG_RATELIMIT,
                                             "Got message with truncated control data (too many fds sent?), ignoring.");
-                return 0;
+                return 1;
         }
         if (n == -EXFULL) {
                 log_ratelimit_warning_errno(n, JOURNAL_LOG_RATELIMIT, "Got message with truncated payload data, ignoring.");
-                return 0;
+                return 1;
         }
         if (n < 0)
                 return log_ratelimit_error_errno(n, JOURNAL_LOG_RATELIMIT, "Failed to receive message: %m");
@@ -1616,9 +1615,39 @@ int server_process_datagram(
         }
 
         close_many(fds, n_fds);
+        return 1;
+}
+
+int server_process_datagram(
+                sd_event_source *es,
+                int fd,
+                uint32_t revents,
+                void *userdata) {
+
+        Server *s = ASSERT_PTR(userdata);
+        int r = 0;
+
+        assert(fd == s->native_fd || fd == s->syslog_fd || fd == s->audit_fd);
+
+        if (revents != EPOLLIN)
+                return log_error_errno(SYNTHETIC_ERRNO(EIO),
+                                       "Got invalid event from epoll for datagram fd: %" PRIx32,
+                                       revents);
+
+        /* Process a bunch of queued datagrams per wakeup, so that during log storms we don't pay the full
+         * event loop iteration for each of them. We stick to individual recvmsg() calls rather than
+         * recvmmsg(), since the latter requires the buffer size for each slot to be fixed ahead of time,
+         * while we size the buffer by the datagram actually queued, and datagrams on the native socket
+         * may be much larger than the typical message. The limit keeps the other event sources (stream
+         * connections, signals, timers) from being starved. */
+        for (unsigned i = 0; i < DATAGRAM_BATCH_MAX; i++) {
+                r = server_receive_datagram(s, fd);
+                if (r <= 0)
+                        break;
+        }
 
         server_refresh_idle_timer(s);
-        return 0;
+        return MIN(r, 0);
 }
 
 static void server_full_flush(Server *s) {
@@ -1966,52 +1995,79 @@ static int server_dispatch_sync(sd_event_source *es, usec_t t, void *userdata) {
         return 0;
 }
 
-static int server_schedule_sync(Server *s, int priority) {
+static int server_arm_sync_timer(Server *s, usec_t delay) {
         int r;
 
         assert(s);
 
-        if (priority <= LOG_CRIT) {
-                /* Immediately sync to disk when this is of priority CRIT, ALERT, EMERG */
-                server_sync(s, /* wait = */ false);
-                return 0;
+        if (s->sync_scheduled) {
+                usec_t next;
+
+                /* Already scheduled early enough? */
+                if (delay > 0)
+                        return 0;
+
+                r = sd_event_source_get_time(s->sync_event_source, &next);
+                if (r < 0)
+                        return r;
+                if (next <= now(CLOCK_MONOTONIC))
+                        return 0;
         }
 
-        if (!s->event || sd_event_get_state(s->event) == SD_EVENT_FINISHED) {
-                /* Shutting down the server? Let's sync immediately. */
-                server_sync(s, /* wait = */ false);
-                return 0;
+        if (!s->sync_event_source) {
+                r = sd_event_add_time_relative(
+                                s->event,
+                                &s->sync_event_source,
+                                CLOCK_MONOTONIC,
+                                delay, 0,
+                                server_dispatch_sync, s);
+                if (r < 0)
+                        return r;
+
+                r = sd_event_source_set_priority(s->sync_event_source, SD_EVENT_PRIORITY_IMPORTANT);
+        } else {
+                r = sd_event_source_set_time_relative(s->sync_event_source, delay);
+                if (r < 0)
+                        return r;
+
+                r = sd_event_source_set_enabled(s->sync_event_source, SD_EVENT_ONESHOT);
         }
+        if (r < 0)
+                return r;
 
-        if (s->sync_scheduled)
-                return 0;
+        s->sync_scheduled = true;
+        return 0;
+}
 
-        if (s->sync_interval_usec > 0) {
+static int server_schedule_sync(Server *s, int priority) {
+        int r;
 
-                if (!s->sync_event_source) {
-                        r = sd_event_add_time_relative(
-                                        s->event,
-                                        &s->sync_event_source,
-                                        CLOCK_MONOTONIC,
-                                        s->sync_interval_usec, 0,
-                                        server_dispatch_sync, s);
-                        if (r < 0)
-                                return r;
+        assert(s);
 
-                        r = sd_event_source_set_priority(s->sync_event_source, SD_EVENT_PRIORITY_IMPORTANT);
-                } else {
-                        r = sd_event_source_set_time_relative(s->sync_event_source, s->sync_interval_usec);
-                        if (r < 0)
-                                return r;
+        if (!s->event || sd_event_get_state(s->event) == SD_EVENT_FINISHED) {
+                /* Shutting down the server? Let's sync immediately. */
+                server_sync(s, /* wait = */ false);
+                return 0;
+        }
 
-                        r = sd_event_source_set_enabled(s->sync_event_source, SD_EVENT_ONESHOT);
+        if (priority <= LOG_CRIT) {
+                /* Sync to disk right away when this is of priority CRIT, ALERT, EMERG. We don't do it
+                 * synchronously here though, but on the next event loop iteration, so that a burst of such
+                 * messages (e.g. a batch of datagrams processed in one go, see server_process_datagram()) is
+                 * covered by a single sync, rather than each of them waiting for the previous sync to finish
+                 * before it can be written. */
+                r = server_arm_sync_timer(s, 0);
+                if (r < 0) {
+                        log_debug_errno(r, "Failed to schedule immediate sync, syncing right away: %m");
+                        server_sync(s, /* wait = */ false);
                 }
-                if (r < 0)
-                        return r;
 
-                s->sync_scheduled = true;
+                return 0;
         }
 
+        if (s->sync_interval_usec > 0)
+                return server_arm_sync_timer(s, s->sync_interval_usec);
+
         return 0;
 }
 
@@ -2926,12 +2982,13 @@ Server* server_free(Server *s) {
         safe_close(s->audit_fd);
         safe_close(s->hostname_fd);
         safe_close(s->notify_fd);
-        safe_close(s->forward_socket_fd);
+        server_close_forward_socket(s);
 
         ordered_hashmap_free(s->ratelimit_groups_by_id);
 
         server_unmap_seqnum_file(s->seqnum, sizeof(*s->seqnum));
         server_unmap_seqnum_file(s->kernel_seqnum, sizeof(*s->kernel_seqnum));
+        sd_device_unref(s->kmsg_device);
 
         free(s->buffer);
         free(s->tty_path);
@@ -4,6 +4,7 @@
 #include <stdbool.h>
 #include <sys/types.h>
 
+#include "sd-device.h"
 #include "sd-event.h"
 #include "sd-varlink.h"
 
@@ -97,6 +98,7 @@ struct Server {
         sd_event_source *notify_event_source;
         sd_event_source *watchdog_event_source;
         sd_event_source *idle_event_source;
+        sd_event_source *forward_socket_event_source;
         struct sigrtmin18_info sigrtmin18_info;
 
         JournalFile *runtime_journal;
@@ -125,6 +127,8 @@ struct Server {
         bool forward_to_console;
         bool forward_to_wall;
         SocketAddress forward_to_socket;
+        char *forward_socket_buffer; /* Output we couldn't write to the forward socket right away */
+        size_t forward_socket_buffer_size;
 
         unsigned n_forward_syslog_missed;
         usec_t last_warn_forward_syslog_missed;
@@ -157,6 +161,10 @@ struct Server {
         bool dev_kmsg_readable:1;
         RateLimit kmsg_own_ratelimit;
 
+        /* The device last referenced by a kernel message, and when we looked it up */
+        sd_device *kmsg_device;
+        usec_t kmsg_device_timestamp;
+
         bool send_watchdog:1;
         bool sent_notify_ready:1;
         bool sync_scheduled:1;
@@ -179,6 +187,7 @@ struct Server {
         /* Caching of client metadata */
         Hashmap *client_contexts;
         Prioq *client_contexts_lru;
+        Hashmap *client_cgroup_data; /* per-unit metadata shared between client contexts, by cgroup path */
 
         usec_t last_cache_pid_flush;
 
@@ -4,8 +4,11 @@
 #include <sys/socket.h>
 #include <sys/uio.h>
 
+#include "alloc-util.h"
+#include "errno-util.h"
 #include "fd-util.h"
 #include "iovec-util.h"
+#include "journal-internal.h"
 #include "journald-socket.h"
 #include "log.h"
 #include "macro.h"
@@ -13,10 +16,68 @@
 #include "socket-util.h"
 #include "sparse-endian.h"
 
+/* How much output for the forward socket we queue at most, if the receiver can't keep up. Beyond that,
+ * messages are dropped, so that a slow receiver cannot stall journald. */
+#define FORWARD_SOCKET_BUFFER_MAX (8U*1024U*1024U)
+
+void server_close_forward_socket(Server *s) {
+        assert(s);
+
+        s->forward_socket_event_source = sd_event_source_disable_unref(s->forward_socket_event_source);
+        s->forward_socket_fd = safe_close(s->forward_socket_fd);
+        s->forward_socket_buffer = mfree(s->forward_socket_buffer);
+        s->forward_socket_buffer_size = 0;
+}
+
+static int dispatch_forward_socket(sd_event_source *es, int fd, uint32_t revents, void *userdata) {
+        Server *s = ASSERT_PTR(userdata);
+        ssize_t k;
+        int r;
+
+        assert(fd == s->forward_socket_fd);
+
+        if (revents & (EPOLLERR|EPOLLHUP)) {
+                int error;
+
+                if (getsockopt_int(fd, SOL_SOCKET, SO_ERROR, &error) < 0 || error <= 0)
+                        error = ECONNRESET;
+
+                log_debug_errno(error, "Forward socket failed, closing: %m");
+                server_close_forward_socket(s);
+                return 0;
+        }
+
+        if (s->forward_socket_buffer_size > 0) {
+                k = write(fd, s->forward_socket_buffer, s->forward_socket_buffer_size);
+                if (k < 0) {
+                        if (ERRNO_IS_TRANSIENT(errno))
+                                return 0;
+
+                        log_debug_errno(errno, "Failed to forward log messages over socket, closing: %m");
+                        server_close_forward_socket(s);
+                        return 0;
+                }
+
+                assert((size_t) k <= s->forward_socket_buffer_size);
+                s->forward_socket_buffer_size -= k;
+                memmove(s->forward_socket_buffer, s->forward_socket_buffer + k, s->forward_socket_buffer_size);
+        }
+
+        if (s->forward_socket_buffer_size == 0) {
+                r = sd_event_source_set_enabled(es, SD_EVENT_OFF);
+                if (r < 0) {
+                        log_debug_errno(r, "Failed to disable forward socket event source, closing: %m");
+                        server_close_forward_socket(s);
+                }
+        }
+
+        return 0;
+}
+
 static int server_open_forward_socket(Server *s) {
         _cleanup_close_ int socket_fd = -EBADF;
         const SocketAddress *addr;
-        int family;
+        int family, r;
 
         assert(s);
 
@@ -35,18 +96,71 @@ static int server_open_forward_socket(Server *s) {
                 return log_debug_errno(SYNTHETIC_ERRNO(ESOCKTNOSUPPORT),
                                        "Unsupported socket type for forward socket: %d", family);
 
-        socket_fd = socket(family, SOCK_STREAM|SOCK_CLOEXEC, 0);
+        /* The socket is non-blocking, so that neither a slow connection attempt nor a receiver that can't
+         * keep up stall us. Any output that can't be written right away is queued, see below. */
+        socket_fd = socket(family, SOCK_STREAM|SOCK_CLOEXEC|SOCK_NONBLOCK, 0);
         if (socket_fd < 0)
                 return log_debug_errno(errno, "Failed to create forward socket, ignoring: %m");
 
-        if (connect(socket_fd, &addr->sockaddr.sa, addr->size) < 0)
+        if (connect(socket_fd, &addr->sockaddr.sa, addr->size) < 0 && errno != EINPROGRESS)
                 return log_debug_errno(errno, "Failed to connect to remote address for forwarding, ignoring: %m");
 
+        if (s->event) {
+                r = sd_event_add_io(s->event, &s->forward_socket_event_source, socket_fd, EPOLLOUT, dispatch_forward_socket, s);
+                if (r < 0)
+                        return log_debug_errno(r, "Failed to watch forward socket, ignoring: %m");
+
+                r = sd_event_source_set_enabled(s->forward_socket_event_source, SD_EVENT_OFF);
+                if (r < 0) {
+                        s->forward_socket_event_source = sd_event_source_unref(s->forward_socket_event_source);
+                        return log_debug_errno(r, "Failed to disable forward socket event source, ignoring: %m");
+                }
+
+                (void) sd_event_source_set_description(s->forward_socket_event_source, "forward-socket");
+        }
+
         s->forward_socket_fd = TAKE_FD(socket_fd);
-        log_debug("Successfully connected to remote address for forwarding.");
+        log_debug("Successfully initiated connection to remote address for forwarding.");
         return 1;
 }
 
+static int server_queue_forward_socket(Server *s, const struct iovec *iov, size_t n_iov, size_t skip) {
+        size_t total;
+        char *p;
+        int r;
+
+        assert(s);
+        assert(iov || n_iov == 0);
+
+        /* Queues the output, minus the first 'skip' bytes which were already written */
+
+        total = iovec_total_size(iov, n_iov);
+        assert(skip < total);
+
+        if (!s->forward_socket_event_source || /* No event loop to flush the queue with? */
+            total - skip > FORWARD_SOCKET_BUFFER_MAX - s->forward_socket_buffer_size)
+                return -ENOBUFS;
+
+        if (!GREEDY_REALLOC(s->forward_socket_buffer, s->forward_socket_buffer_size + total - skip))
+                return -ENOMEM;
+
+        p = s->forward_socket_buffer + s->forward_socket_buffer_size;
+        FOREACH_ARRAY(i, iov, n_iov) {
+                size_t k = MIN(skip, i->iov_len);
+
+                p = mempcpy_safe(p, (const uint8_t*) i->iov_base + k, i->iov_len - k);
+                skip -= k;
+        }
+
+        s->forward_socket_buffer_size = p - s->forward_socket_buffer;
+
+        r = sd_event_source_set_enabled(s->forward_socket_event_source, SD_EVENT_ON);
+        if (r < 0)
+                return r;
+
+        return 0;
+}
+
 static inline bool must_serialize(struct iovec iov) {
         /* checks an iovec of the form FIELD=VALUE to see if VALUE needs binary safe serialisation:
          * See https://systemd.io/JOURNAL_EXPORT_FORMATS/#journal-export-format for more information
@@ -151,12 +265,39 @@ int server_forward_socket(
         xsprintf(monotonic_buf, "__MONOTONIC_TIMESTAMP="USEC_FMT"\n\n", ts->monotonic);
         iov[iov_idx++] = IOVEC_MAKE_STRING(monotonic_buf);
 
-        if (writev(s->forward_socket_fd, iov, iov_idx) < 0) {
-                log_debug_errno(errno, "Failed to forward log message over socket: %m");
+        size_t written = 0;
+
+        /* If there's queued output already, don't bother trying to write, but queue this one too, to
+         * maintain ordering. */
+        if (s->forward_socket_buffer_size == 0) {
+                ssize_t k;
 
-                /* If we failed to send once we will probably fail again so wait for a new connection to
-                 * establish before attempting to forward again. */
-                s->forward_socket_fd = safe_close(s->forward_socket_fd);
+                k = writev(s->forward_socket_fd, iov, iov_idx);
+                if (k < 0) {
+                        if (!ERRNO_IS_TRANSIENT(errno)) {
+                                log_debug_errno(errno, "Failed to forward log message over socket: %m");
+
+                                /* If we failed to send once we will probably fail again so wait for a new
+                                 * connection to establish before attempting to forward again. */
+                                server_close_forward_socket(s);
+                                return 0;
+                        }
+                } else
+                        written = k;
+
+                if (written >= iovec_total_size(iov, iov_idx))
+                        return 0;
+        }
+
+        r = server_queue_forward_socket(s, iov, iov_idx, written);
+        if (r < 0) {
+                /* If we wrote part of the message already, the stream is out of sync now, hence start anew */
+                if (written > 0) {
+                        log_debug_errno(r, "Failed to queue rest of partially forwarded log message, closing socket: %m");
+                        server_close_forward_socket(s);
+                } else
+                        log_ratelimit_warning_errno(r, JOURNAL_LOG_RATELIMIT,
+                                                    "Failed to queue log message for forwarding over socket, dropping: %m");
         }
 
         return 0;
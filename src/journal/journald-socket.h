@@ -4,4 +4,5 @@
 #include "journald-server.h"
 #include "socket-util.h"
 
+void server_close_forward_socket(Server *s);
 int server_forward_socket(Server *s, const struct iovec *iovec, size_t n, const dual_timestamp *ts, int priority);
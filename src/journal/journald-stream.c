@@ -93,6 +93,7 @@ struct StdoutStream {
 
         char *buffer;
         size_t length;
+        size_t length_scanned; /* The first bytes of the buffer we already know not to contain a line break */
 
         sd_event_source *event_source;
 
@@ -499,6 +500,7 @@ static int stdout_stream_scan(
                 StdoutStream *s,
                 char *p,
                 size_t remaining,
+                size_t scanned,
                 LineBreak force_flush,
                 size_t *ret_consumed) {
 
@@ -507,6 +509,12 @@ static int stdout_stream_scan(
 
         assert(s);
         assert(p);
+        assert(scanned <= remaining);
+
+        /* 'scanned' is the number of bytes at the beginning of 'p' which are already known to contain
+         * neither a newline nor a NUL byte, because we looked at them before when they were the incomplete
+         * last line of the buffer. Skip over them, so that a long line trickling in piecemeal isn't scanned
+         * over and over again. */
 
         for (;;) {
                 LineBreak line_break;
@@ -516,9 +524,10 @@ static int stdout_stream_scan(
 
                 line_max = stdout_stream_line_max(s);
                 tmp_remaining = MIN(remaining, line_max);
+                scanned = MIN(scanned, tmp_remaining);
 
-                end1 = memchr(p, '\n', tmp_remaining);
-                end2 = memchr(p, 0, end1 ? (size_t) (end1 - p) : tmp_remaining);
+                end1 = memchr(p + scanned, '\n', tmp_remaining - scanned);
+                end2 = memchr(p + scanned, 0, end1 ? (size_t) (end1 - p) - scanned : tmp_remaining - scanned);
 
                 if (end2) {
                         /* We found a NUL terminator */
@@ -544,6 +553,7 @@ static int stdout_stream_scan(
                 p += skip;
                 consumed += skip;
                 remaining -= skip;
+                scanned = 0;
         }
 
         if (force_flush >= 0 && remaining > 0) {
@@ -562,7 +572,7 @@ static int stdout_stream_scan(
 
 static int stdout_stream_process(sd_event_source *es, int fd, uint32_t revents, void *userdata) {
         CMSG_BUFFER_TYPE(CMSG_SPACE(sizeof(struct ucred))) control;
-        size_t limit, consumed, allocated;
+        size_t limit, consumed, allocated, scanned;
         StdoutStream *s = ASSERT_PTR(userdata);
         struct ucred *ucred;
         struct iovec iovec;
@@ -610,7 +620,7 @@ static int stdout_stream_process(sd_event_source *es, int fd, uint32_t revents,
         cmsg_close_all(&msghdr);
 
         if (l == 0) {
-                (void) stdout_stream_scan(s, s->buffer, s->length, /* force_flush = */ LINE_BREAK_EOF, NULL);
+                (void) stdout_stream_scan(s, s->buffer, s->length, s->length_scanned, /* force_flush = */ LINE_BREAK_EOF, NULL);
                 goto terminate;
         }
 
@@ -621,30 +631,34 @@ static int stdout_stream_process(sd_event_source *es, int fd, uint32_t revents,
         if (ucred && ucred->pid != s->ucred.pid) {
                 /* Force out any previously half-written lines from a different process, before we switch to
                  * the new ucred structure for everything we just added */
-                r = stdout_stream_scan(s, s->buffer, s->length, /* force_flush = */ LINE_BREAK_PID_CHANGE, NULL);
+                r = stdout_stream_scan(s, s->buffer, s->length, s->length_scanned, /* force_flush = */ LINE_BREAK_PID_CHANGE, NULL);
                 if (r < 0)
                         goto terminate;
 
                 s->context = client_context_release(s->server, s->context);
 
                 p = s->buffer + s->length;
+                scanned = 0;
         } else {
                 p = s->buffer;
                 l += s->length;
+                scanned = s->length_scanned;
         }
 
         /* Always copy in the new credentials */
         if (ucred)
                 s->ucred = *ucred;
 
-        r = stdout_stream_scan(s, p, l, _LINE_BREAK_INVALID, &consumed);
+        r = stdout_stream_scan(s, p, l, scanned, _LINE_BREAK_INVALID, &consumed);
         if (r < 0)
                 goto terminate;
 
-        /* Move what wasn't consumed to the front of the buffer */
+        /* Move what wasn't consumed to the front of the buffer, unless it's there already. What's left is
+         * always an incomplete line, i.e. one we have fully scanned for line breaks already. */
         assert(consumed <= (size_t) l);
-        s->length = l - consumed;
-        memmove(s->buffer, p + consumed, s->length);
+        s->length = s->length_scanned = l - consumed;
+        if (p + consumed != s->buffer)
+                memmove(s->buffer, p + consumed, s->length);
 
         return 1;
 
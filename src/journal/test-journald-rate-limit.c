@@ -1,40 +1,72 @@
 /* SPDX-License-Identifier: LGPL-2.1-or-later */
 
 #include "journald-rate-limit.h"
+#include "stdio-util.h"
 #include "tests.h"
 
 TEST(journal_ratelimit_test) {
         _cleanup_ordered_hashmap_free_ OrderedHashmap *rl = NULL;
+        usec_t ts = now(CLOCK_MONOTONIC);
         int r;
 
         for (unsigned i = 0; i < 20; i++) {
-                r = journal_ratelimit_test(&rl, "hoge", USEC_PER_SEC, 10, LOG_DEBUG, 0);
+                r = journal_ratelimit_test(&rl, "hoge", USEC_PER_SEC, 10, LOG_DEBUG, 0, ts);
                 assert_se(r == (i < 10 ? 1 : 0));
-                r = journal_ratelimit_test(&rl, "foo", 10 * USEC_PER_SEC, 10, LOG_DEBUG, 0);
+                r = journal_ratelimit_test(&rl, "foo", 10 * USEC_PER_SEC, 10, LOG_DEBUG, 0, ts);
                 assert_se(r == (i < 10 ? 1 : 0));
         }
 
         /* Different priority group with the same ID is not ratelimited. */
-        assert_se(journal_ratelimit_test(&rl, "hoge", USEC_PER_SEC, 10, LOG_INFO, 0) == 1);
-        assert_se(journal_ratelimit_test(&rl, "foo", 10 * USEC_PER_SEC, 10, LOG_INFO, 0) == 1);
+        assert_se(journal_ratelimit_test(&rl, "hoge", USEC_PER_SEC, 10, LOG_INFO, 0, ts) == 1);
+        assert_se(journal_ratelimit_test(&rl, "foo", 10 * USEC_PER_SEC, 10, LOG_INFO, 0, ts) == 1);
         /* Still LOG_DEBUG is ratelimited. */
-        assert_se(journal_ratelimit_test(&rl, "hoge", USEC_PER_SEC, 10, LOG_DEBUG, 0) == 0);
-        assert_se(journal_ratelimit_test(&rl, "foo", 10 * USEC_PER_SEC, 10, LOG_DEBUG, 0) == 0);
+        assert_se(journal_ratelimit_test(&rl, "hoge", USEC_PER_SEC, 10, LOG_DEBUG, 0, ts) == 0);
+        assert_se(journal_ratelimit_test(&rl, "foo", 10 * USEC_PER_SEC, 10, LOG_DEBUG, 0, ts) == 0);
         /* Different ID is not ratelimited. */
-        assert_se(journal_ratelimit_test(&rl, "quux", USEC_PER_SEC, 10, LOG_DEBUG, 0) == 1);
+        assert_se(journal_ratelimit_test(&rl, "quux", USEC_PER_SEC, 10, LOG_DEBUG, 0, ts) == 1);
 
-        usleep_safe(USEC_PER_SEC);
+        /* Move past the end of the 1s interval */
+        ts += USEC_PER_SEC + 1;
 
         /* The ratelimit is now expired (11 trials are suppressed, so the return value should be 12). */
-        assert_se(journal_ratelimit_test(&rl, "hoge", USEC_PER_SEC, 10, LOG_DEBUG, 0) == 1 + 11);
+        assert_se(journal_ratelimit_test(&rl, "hoge", USEC_PER_SEC, 10, LOG_DEBUG, 0, ts) == 1 + 11);
 
         /* foo is still ratelimited. */
-        assert_se(journal_ratelimit_test(&rl, "foo", 10 * USEC_PER_SEC, 10, LOG_DEBUG, 0) == 0);
+        assert_se(journal_ratelimit_test(&rl, "foo", 10 * USEC_PER_SEC, 10, LOG_DEBUG, 0, ts) == 0);
 
         /* Still other priority and/or other IDs are not ratelimited. */
-        assert_se(journal_ratelimit_test(&rl, "hoge", USEC_PER_SEC, 10, LOG_INFO, 0) == 1);
-        assert_se(journal_ratelimit_test(&rl, "foo", 10 * USEC_PER_SEC, 10, LOG_INFO, 0) == 1);
-        assert_se(journal_ratelimit_test(&rl, "quux", USEC_PER_SEC, 10, LOG_DEBUG, 0) == 1);
+        assert_se(journal_ratelimit_test(&rl, "hoge", USEC_PER_SEC, 10, LOG_INFO, 0, ts) == 1);
+        assert_se(journal_ratelimit_test(&rl, "foo", 10 * USEC_PER_SEC, 10, LOG_INFO, 0, ts) == 1);
+        assert_se(journal_ratelimit_test(&rl, "quux", USEC_PER_SEC, 10, LOG_DEBUG, 0, ts) == 1);
+}
+
+TEST(journal_ratelimit_lru) {
+        _cleanup_ordered_hashmap_free_ OrderedHashmap *rl = NULL;
+        char id[DECIMAL_STR_MAX(unsigned) + 1];
+        usec_t ts = now(CLOCK_MONOTONIC);
+
+        /* Create a group, and then lots of further groups, which fill up the hashmap almost entirely. */
+        assert_se(journal_ratelimit_test(&rl, "hoge", USEC_PER_SEC, 10, LOG_DEBUG, 0, ts) == 1);
+        for (unsigned i = 0; i < 2046; i++) {
+                xsprintf(id, "g%u", i);
+                assert_se(journal_ratelimit_test(&rl, id, USEC_PER_MINUTE, 10, LOG_DEBUG, 0, ts) == 1);
+        }
+        assert_se(ordered_hashmap_size(rl) == 2047);
+
+        /* Move past the end of the 1s interval */
+        ts += USEC_PER_SEC + 1;
+
+        /* Start a new interval of the first group, and make it hit the limit. */
+        for (unsigned i = 0; i < 10; i++)
+                assert_se(journal_ratelimit_test(&rl, "hoge", USEC_PER_SEC, 10, LOG_DEBUG, 0, ts) == 1);
+        assert_se(journal_ratelimit_test(&rl, "hoge", USEC_PER_SEC, 10, LOG_DEBUG, 0, ts) == 0);
+
+        /* Adding a new group requires flushing out one, which must be the one idle longest, not the one we
+         * are actively using, even though that one was created first. */
+        assert_se(journal_ratelimit_test(&rl, "quux", USEC_PER_SEC, 10, LOG_DEBUG, 0, ts) == 1);
+        assert_se(ordered_hashmap_size(rl) == 2047);
+        assert_se(!ordered_hashmap_contains(rl, "g0"));
+        assert_se(journal_ratelimit_test(&rl, "hoge", USEC_PER_SEC, 10, LOG_DEBUG, 0, ts) == 0);
 }
 
 DEFINE_TEST_MAIN(LOG_INFO);
@@ -31,7 +31,10 @@
 #define DHCP_DEFAULT_LEASE_TIME_USEC USEC_PER_HOUR
 #define DHCP_MAX_LEASE_TIME_USEC (USEC_PER_HOUR*12)
 
-static void server_on_lease_change(sd_dhcp_server *server) {
+/* Maximum number of datagrams we read in one go when the socket becomes readable */
+#define DHCP_SERVER_RECEIVE_BATCH 64U
+
+static void server_save_leases(sd_dhcp_server *server) {
         int r;
 
         assert(server);
@@ -39,6 +42,58 @@ static void server_on_lease_change(sd_dhcp_server *server) {
         r = dhcp_server_save_leases(server);
         if (r < 0)
                 log_dhcp_server_errno(server, r, "Failed to save leases, ignoring: %m");
+}
+
+static int server_on_save_leases(sd_event_source *s, void *userdata) {
+        server_save_leases(ASSERT_PTR(userdata));
+        return 0;
+}
+
+static int server_schedule_save_leases(sd_dhcp_server *server) {
+        int r;
+
+        assert(server);
+
+        if (!server->event)
+                return -ESTALE;
+
+        if (server->save_leases)
+                return sd_event_source_set_enabled(server->save_leases, SD_EVENT_ONESHOT);
+
+        r = sd_event_add_defer(server->event, &server->save_leases, server_on_save_leases, server);
+        if (r < 0)
+                return r;
+
+        r = sd_event_source_set_priority(server->save_leases, server->event_priority);
+        if (r < 0)
+                return r;
+
+        (void) sd_event_source_set_description(server->save_leases, "dhcp-server-save-leases");
+        return 0;
+}
+
+static void server_flush_save_leases(sd_dhcp_server *server) {
+        assert(server);
+
+        /* Write out pending lease changes now, and drop the event source, as it is bound to the current
+         * event loop */
+        if (sd_event_source_get_enabled(server->save_leases, NULL) > 0)
+                server_save_leases(server);
+        server->save_leases = sd_event_source_disable_unref(server->save_leases);
+}
+
+static void server_on_lease_change(sd_dhcp_server *server) {
+        int r;
+
+        assert(server);
+
+        /* Writing the lease file costs time proportional to the number of leases. Hence, do not write it
+         * on every change, but once after a burst of changes has been processed. */
+        if (server->lease_file) {
+                r = server_schedule_save_leases(server);
+                if (r < 0)
+                        server_save_leases(server);
+        }
 
         if (server->callback)
                 server->callback(server, SD_DHCP_SERVER_EVENT_LEASE_CHANGED, server->callback_userdata);
@@ -230,6 +285,7 @@ int sd_dhcp_server_attach_event(sd_dhcp_server *server, sd_event *event, int64_t
 int sd_dhcp_server_detach_event(sd_dhcp_server *server) {
         assert_return(server, -EINVAL);
 
+        server_flush_save_leases(server);
         server->event = sd_event_unref(server->event);
 
         return 0;
@@ -288,6 +344,8 @@ int sd_dhcp_server_stop(sd_dhcp_server *server) {
         server->receive_message = sd_event_source_disable_unref(server->receive_message);
         server->receive_broadcast = sd_event_source_disable_unref(server->receive_broadcast);
 
+        server_flush_save_leases(server);
+
         server->fd_raw = safe_close(server->fd_raw);
         server->fd = safe_close(server->fd);
         server->fd_broadcast = safe_close(server->fd_broadcast);
@@ -1222,13 +1280,12 @@ static size_t relay_agent_information_length(const char* agent_circuit_id, const
         return sum;
 }
 
-static int server_receive_message(sd_event_source *s, int fd,
-                                  uint32_t revents, void *userdata) {
+/* Returns 1 if a datagram was consumed, and 0 if there was nothing (more) to read. */
+static int server_receive_message_one(sd_dhcp_server *server, int fd) {
         _cleanup_free_ DHCPMessage *message = NULL;
         /* This needs to be initialized with zero. See #20741. */
         CMSG_BUFFER_TYPE(CMSG_SPACE_TIMEVAL +
                          CMSG_SPACE(sizeof(struct in_pktinfo))) control = {};
-        sd_dhcp_server *server = ASSERT_PTR(userdata);
         struct iovec iov = {};
         struct msghdr msg = {
                 .msg_iov = &iov,
@@ -1239,6 +1296,8 @@ static int server_receive_message(sd_event_source *s, int fd,
         ssize_t datagram_size, len;
         int r;
 
+        assert(server);
+
         datagram_size = next_datagram_size_fd(fd);
         if (ERRNO_IS_NEG_TRANSIENT(datagram_size) || ERRNO_IS_NEG_DISCONNECT(datagram_size))
                 return 0;
@@ -1267,12 +1326,12 @@ static int server_receive_message(sd_event_source *s, int fd,
         }
 
         if ((size_t) len < sizeof(DHCPMessage))
-                return 0;
+                return 1;
 
         /* TODO figure out if this can be done as a filter on the socket, like for IPv6 */
         struct in_pktinfo *info = CMSG_FIND_DATA(&msg, IPPROTO_IP, IP_PKTINFO, struct in_pktinfo);
         if (info && info->ipi_ifindex != server->ifindex)
-                return 0;
+                return 1;
 
         if (sd_dhcp_server_is_in_relay_mode(server)) {
                 r = dhcp_server_relay_message(server, message, len - sizeof(DHCPMessage), buflen);
@@ -1283,6 +1342,26 @@ static int server_receive_message(sd_event_source *s, int fd,
                 if (r < 0)
                         log_dhcp_server_errno(server, r, "Couldn't process incoming message, ignoring: %m");
         }
+        return 1;
+}
+
+static int server_receive_message(sd_event_source *s, int fd,
+                                  uint32_t revents, void *userdata) {
+        _cleanup_(sd_dhcp_server_unrefp) sd_dhcp_server *server = sd_dhcp_server_ref(ASSERT_PTR(userdata));
+        int r;
+
+        /* Handle a bunch of datagrams per wakeup, so that bursts of requests don't cost an event loop
+         * iteration each, and lease changes made while processing them get saved together. */
+        for (unsigned i = 0; i < DHCP_SERVER_RECEIVE_BATCH; i++) {
+                r = server_receive_message_one(server, fd);
+                if (r <= 0)
+                        return r;
+
+                /* The server might have been stopped by the lease change callback. */
+                if (!sd_dhcp_server_is_running(server))
+                        break;
+        }
+
         return 0;
 }
 
@@ -53,11 +53,20 @@ static bool BUS_MATCH_IS_COMPARE(enum bus_match_node_type t) {
 }
 
 static bool BUS_MATCH_CAN_HASH(enum bus_match_node_type t) {
-        return (t >= BUS_MATCH_MESSAGE_TYPE && t <= BUS_MATCH_PATH) ||
+        return (t >= BUS_MATCH_MESSAGE_TYPE && t <= BUS_MATCH_PATH_NAMESPACE) ||
                 (t >= BUS_MATCH_ARG && t <= BUS_MATCH_ARG_LAST) ||
+                (t >= BUS_MATCH_ARG_NAMESPACE && t <= BUS_MATCH_ARG_NAMESPACE_LAST) ||
                 (t >= BUS_MATCH_ARG_HAS && t <= BUS_MATCH_ARG_HAS_LAST);
 }
 
+static char BUS_MATCH_NAMESPACE_SEPARATOR(enum bus_match_node_type t) {
+        if (t == BUS_MATCH_PATH_NAMESPACE)
+                return '/';
+        if (t >= BUS_MATCH_ARG_NAMESPACE && t <= BUS_MATCH_ARG_NAMESPACE_LAST)
+                return '.';
+        return 0;
+}
+
 static void bus_match_node_free(struct bus_match_node *node) {
         assert(node);
         assert(node->parent);
@@ -235,6 +244,75 @@ static bool value_node_same(
         }
 }
 
+static int bus_match_run_namespace(
+                sd_bus *bus,
+                struct bus_match_node *node,
+                sd_bus_message *m,
+                char separator,
+                const char *test_str) {
+
+        _cleanup_free_ char *s = NULL;
+        struct bus_match_node *found;
+        int r;
+
+        assert(node);
+        assert(separator != 0);
+        assert(test_str);
+
+        /* A namespace value matches test_str if it is equal to it, or if it is equal to a prefix of test_str
+         * that is followed by the separator, or to such a prefix including the separator, see
+         * simple_pattern_check(). Hence, rather than testing every value, look up each of these prefixes of
+         * test_str in the hash table. That's at most two lookups per label instead of one comparison per
+         * match installed for this namespace type. */
+
+        s = strdup(test_str);
+        if (!s)
+                return -ENOMEM;
+
+        for (char *p = s; *p; p++) {
+                char saved;
+
+                if (*p != separator)
+                        continue;
+
+                /* The prefix without the separator */
+                *p = 0;
+                found = hashmap_get(node->compare.children, s);
+                *p = separator;
+                if (found) {
+                        r = bus_match_run(bus, found, m);
+                        if (r != 0)
+                                return r;
+
+                        if (bus && bus->match_callbacks_modified)
+                                return 0;
+                }
+
+                /* The prefix including the separator, unless that is all of test_str, which is covered below */
+                if (p[1] == 0)
+                        break;
+
+                saved = p[1];
+                p[1] = 0;
+                found = hashmap_get(node->compare.children, s);
+                p[1] = saved;
+                if (found) {
+                        r = bus_match_run(bus, found, m);
+                        if (r != 0)
+                                return r;
+
+                        if (bus && bus->match_callbacks_modified)
+                                return 0;
+                }
+        }
+
+        found = hashmap_get(node->compare.children, s);
+        if (found)
+                return bus_match_run(bus, found, m);
+
+        return 0;
+}
+
 int bus_match_run(
                 sd_bus *bus,
                 struct bus_match_node *node,
@@ -377,10 +455,20 @@ int bus_match_run(
 
         if (BUS_MATCH_CAN_HASH(node->type)) {
                 struct bus_match_node *found;
+                char separator;
 
                 /* Lookup via hash table, nice! So let's jump directly. */
 
-                if (test_str)
+                separator = BUS_MATCH_NAMESPACE_SEPARATOR(node->type);
+                if (separator != 0) {
+                        if (test_str) {
+                                r = bus_match_run_namespace(bus, node, m, separator, test_str);
+                                if (r != 0)
+                                        return r;
+                        }
+
+                        found = NULL;
+                } else if (test_str)
                         found = hashmap_get(node->compare.children, test_str);
                 else if (test_strv) {
                         STRV_FOREACH(i, test_strv) {
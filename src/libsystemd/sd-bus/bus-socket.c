@@ -1,6 +1,7 @@
 /* SPDX-License-Identifier: LGPL-2.1-or-later */
 
 #include <endian.h>
+#include <limits.h>
 #include <poll.h>
 #include <stdlib.h>
 #include <unistd.h>
@@ -1216,8 +1217,8 @@ int bus_socket_take_fd(sd_bus *b) {
 
 int bus_socket_write_message(sd_bus *bus, sd_bus_message *m, size_t *idx) {
         struct iovec *iov;
+        size_t n, skip;
         ssize_t k;
-        size_t n;
         unsigned j;
         int r;
 
@@ -1233,19 +1234,27 @@ int bus_socket_write_message(sd_bus *bus, sd_bus_message *m, size_t *idx) {
         if (r < 0)
                 return r;
 
-        n = m->n_iovec * sizeof(struct iovec);
+        /* Skip the parts that have been written completely already, and only copy the remaining iovecs
+         * (which we need to adjust for the partially written one). For large messages with many body parts
+         * this also keeps us below IOV_MAX, the remainder will be written on the next invocation. */
+        skip = *idx;
+        for (j = 0; j < m->n_iovec && skip >= m->iovec[j].iov_len; j++)
+                skip -= m->iovec[j].iov_len;
+        assert(j < m->n_iovec);
+
+        n = MIN(m->n_iovec - j, (size_t) IOV_MAX);
         iov = newa(struct iovec, n);
-        memcpy_safe(iov, m->iovec, n);
+        memcpy(iov, m->iovec + j, n * sizeof(struct iovec));
 
         j = 0;
-        iovec_advance(iov, &j, *idx);
+        iovec_advance(iov, &j, skip);
 
         if (bus->prefer_writev)
-                k = writev(bus->output_fd, iov, m->n_iovec);
+                k = writev(bus->output_fd, iov, n);
         else {
                 struct msghdr mh = {
                         .msg_iov = iov,
-                        .msg_iovlen = m->n_iovec,
+                        .msg_iovlen = n,
                 };
 
                 if (m->n_fds > 0 && *idx == 0) {
@@ -1263,7 +1272,7 @@ int bus_socket_write_message(sd_bus *bus, sd_bus_message *m, size_t *idx) {
                 k = sendmsg(bus->output_fd, &mh, MSG_DONTWAIT|MSG_NOSIGNAL);
                 if (k < 0 && errno == ENOTSOCK) {
                         bus->prefer_writev = true;
-                        k = writev(bus->output_fd, iov, m->n_iovec);
+                        k = writev(bus->output_fd, iov, n);
                 }
         }
 
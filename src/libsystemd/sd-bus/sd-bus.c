@@ -46,6 +46,7 @@
 #include "stdio-util.h"
 #include "string-util.h"
 #include "strv.h"
+#include "trace-util.h"
 #include "user-util.h"
 
 #define log_debug_bus_message(m)                                         \
@@ -67,6 +68,11 @@
                           strna(_mm->error.message));                    \
         } while (false)
 
+/* Arguments: type, path, interface, member, cookie, reply cookie */
+#define TRACE_BUS_MESSAGE(name, m)                                       \
+        TRACE_POINT(sd_bus, name, (int) (m)->header->type, (m)->path, (m)->interface, (m)->member, \
+                    BUS_MESSAGE_COOKIE(m), (m)->reply_cookie)
+
 static int bus_poll(sd_bus *bus, bool need_more, uint64_t timeout_usec);
 static void bus_detach_io_events(sd_bus *b);
 
@@ -2206,6 +2212,8 @@ _public_ int sd_bus_send(sd_bus *bus, sd_bus_message *_m, uint64_t *cookie) {
         if (m->dont_send)
                 goto finish;
 
+        TRACE_BUS_MESSAGE(message_sent, m);
+
         if (IN_SET(bus->state, BUS_RUNNING, BUS_HELLO) && bus->wqueue_size <= 0) {
                 size_t idx = 0;
 
@@ -2471,6 +2479,7 @@ _public_ int sd_bus_call(
 
                                 rqueue_drop_one(bus, i);
                                 log_debug_bus_message(incoming);
+                                TRACE_BUS_MESSAGE(message_received, incoming);
 
                                 if (incoming->header->type == SD_BUS_MESSAGE_METHOD_RETURN) {
 
@@ -3011,6 +3020,7 @@ static int process_message(sd_bus *bus, sd_bus_message *m) {
                 c = log_context_new_strv_consume(bus_message_make_log_fields(m));
 
         log_debug_bus_message(m);
+        TRACE_BUS_MESSAGE(message_received, m);
 
         r = process_hello(bus, m);
         if (r != 0)
@@ -11,6 +11,8 @@
 #include "device-util.h"
 #include "dirent-util.h"
 #include "fd-util.h"
+#include "glob-util.h"
+#include "path-util.h"
 #include "set.h"
 #include "sort-util.h"
 #include "string-util.h"
@@ -952,9 +954,51 @@ static int enumerator_scan_devices_children(sd_device_enumerator *enumerator) {
         }
 }
 
+static bool enumerator_subsystems_are_literal(sd_device_enumerator *enumerator) {
+        const char *subsystem;
+
+        assert(enumerator);
+
+        if (set_isempty(enumerator->match_subsystem))
+                return false;
+
+        SET_FOREACH(subsystem, enumerator->match_subsystem)
+                if (string_is_glob(subsystem) || !filename_is_valid(subsystem))
+                        return false;
+
+        return true;
+}
+
+static int enumerator_scan_devices_subsystems(sd_device_enumerator *enumerator) {
+        const char *subsystem;
+        int k, r = 0;
+
+        assert(enumerator);
+
+        /* When only plain subsystem names are requested, open their directories directly, instead of reading
+         * all of /sys/bus/ and /sys/class/ only to throw away everything that doesn't match. */
+        SET_FOREACH(subsystem, enumerator->match_subsystem) {
+                if (!match_subsystem(enumerator, subsystem))
+                        continue;
+
+                k = enumerator_scan_dir_and_add_devices(enumerator, "bus", subsystem, "devices");
+                if (k < 0)
+                        r = log_debug_errno(k, "sd-device-enumerator: Failed to scan /sys/bus/%s/devices: %m", subsystem);
+
+                k = enumerator_scan_dir_and_add_devices(enumerator, "class", subsystem, NULL);
+                if (k < 0)
+                        r = log_debug_errno(k, "sd-device-enumerator: Failed to scan /sys/class/%s: %m", subsystem);
+        }
+
+        return r;
+}
+
 static int enumerator_scan_devices_all(sd_device_enumerator *enumerator) {
         int k, r = 0;
 
+        if (enumerator_subsystems_are_literal(enumerator))
+                return enumerator_scan_devices_subsystems(enumerator);
+
         k = enumerator_scan_dir(enumerator, "bus", "devices", NULL);
         if (k < 0)
                 r = log_debug_errno(k, "sd-device-enumerator: Failed to scan /sys/bus: %m");
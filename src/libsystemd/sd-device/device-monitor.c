@@ -69,6 +69,9 @@ struct sd_device_monitor {
 
 #define UDEV_MONITOR_MAGIC                0xfeedcafe
 
+/* The maximum number of messages processed in one event loop iteration */
+#define DEVICE_MONITOR_DISPATCH_BATCH     64U
+
 typedef struct monitor_netlink_header {
         /* "libudev" prefix to distinguish libudev and kernel messages */
         char prefix[8];
@@ -320,18 +323,39 @@ _public_ int sd_device_monitor_stop(sd_device_monitor *m) {
 }
 
 static int device_monitor_event_handler(sd_event_source *s, int fd, uint32_t revents, void *userdata) {
-        _cleanup_(sd_device_unrefp) sd_device *device = NULL;
-        _unused_ _cleanup_(log_context_unrefp) LogContext *c = NULL;
+        _unused_ _cleanup_(sd_device_monitor_unrefp) sd_device_monitor *ref = NULL;
         sd_device_monitor *m = ASSERT_PTR(userdata);
+        int r;
 
-        if (sd_device_monitor_receive(m, &device) <= 0)
-                return 0;
+        /* The callback might drop the last reference to the monitor */
+        ref = sd_device_monitor_ref(m);
+
+        /* During hotplug storms the socket fills up faster than one message per event loop iteration can
+         * drain it, hence process a batch of messages per wakeup. Stop early once the socket is empty or
+         * on any other error, and when the callback stopped the monitor. */
+        for (unsigned i = 0; i < DEVICE_MONITOR_DISPATCH_BATCH; i++) {
+                _cleanup_(sd_device_unrefp) sd_device *device = NULL;
+                _unused_ _cleanup_(log_context_unrefp) LogContext *c = NULL;
+
+                r = sd_device_monitor_receive(m, &device);
+                if (r < 0)
+                        break;
+                if (r == 0)
+                        continue;
+
+                if (log_context_enabled())
+                        c = log_context_new_strv_consume(device_make_log_fields(device));
 
-        if (log_context_enabled())
-                c = log_context_new_strv_consume(device_make_log_fields(device));
+                if (!m->callback)
+                        continue;
 
-        if (m->callback)
-                return m->callback(m, device, m->userdata);
+                r = m->callback(m, device, m->userdata);
+                if (r < 0)
+                        return r;
+
+                if (sd_device_monitor_is_running(m) <= 0)
+                        break;
+        }
 
         return 0;
 }
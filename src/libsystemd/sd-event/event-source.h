@@ -78,6 +78,13 @@ struct sd_event_source {
 
         RateLimit rate_limit;
 
+        /* Dispatch statistics, see sd_event_source_get_statistics() */
+        uint64_t n_dispatched;
+        usec_t dispatch_usec;
+        usec_t dispatch_usec_max;
+        usec_t pending_usec;
+        usec_t pending_since;
+
         /* These are primarily fields relevant for time event sources, but since any event source can
          * effectively become one when rate-limited, this is part of the common fields. */
         unsigned earliest_index;
@@ -88,9 +95,12 @@ struct sd_event_source {
                         sd_event_io_handler_t callback;
                         int fd;
                         uint32_t events;
+                        uint32_t registered_events; /* the mask last passed to epoll_ctl() */
                         uint32_t revents;
+                        LIST_FIELDS(sd_event_source, modify_list);
                         bool registered:1;
                         bool owned:1;
+                        bool in_modify_list:1;
                 } io;
                 struct {
                         sd_event_time_handler_t callback;
@@ -41,9 +41,13 @@
 #include "string-util.h"
 #include "strxcpyx.h"
 #include "time-util.h"
+#include "trace-util.h"
 
 #define DEFAULT_ACCURACY_USEC (250 * USEC_PER_MSEC)
 
+/* Callbacks running longer than this are logged, since they stall everything else on the event loop */
+#define SLOW_DISPATCH_USEC (250 * USEC_PER_MSEC)
+
 static bool EVENT_SOURCE_WATCH_PIDFD(sd_event_source *s) {
         /* Returns true if this is a PID event source and can be implemented by watching EPOLLIN */
         return s &&
@@ -148,6 +152,9 @@ struct sd_event {
         /* A list of memory pressure event sources that still need their subscription string written */
         LIST_HEAD(sd_event_source, memory_pressure_write_list);
 
+        /* IO event sources whose epoll event mask changed but has not been passed to the kernel yet */
+        LIST_HEAD(sd_event_source, io_modify_list);
+
         uint64_t origin_id;
 
         uint64_t iteration;
@@ -484,10 +491,25 @@ _public_ sd_event_source* sd_event_source_disable_unref(sd_event_source *s) {
         return sd_event_source_unref(s);
 }
 
+static void source_io_remove_from_modify_list(sd_event_source *s) {
+        assert(s);
+        assert(s->type == SOURCE_IO);
+
+        if (!s->io.in_modify_list)
+                return;
+
+        LIST_REMOVE(io.modify_list, s->event->io_modify_list, s);
+        s->io.in_modify_list = false;
+}
+
 static void source_io_unregister(sd_event_source *s) {
         assert(s);
         assert(s->type == SOURCE_IO);
 
+        /* Always drop the source from the list, even if it doesn't belong to our process, so that it can't
+         * be left linked in after being freed. */
+        source_io_remove_from_modify_list(s);
+
         if (event_origin_changed(s->event))
                 return;
 
@@ -521,10 +543,24 @@ static int source_io_register(
                 return -errno;
 
         s->io.registered = true;
+        s->io.registered_events = events;
+        source_io_remove_from_modify_list(s);
 
         return 0;
 }
 
+static void source_io_add_to_modify_list(sd_event_source *s) {
+        assert(s);
+        assert(s->type == SOURCE_IO);
+        assert(s->io.registered);
+
+        if (s->io.in_modify_list)
+                return;
+
+        LIST_PREPEND(io.modify_list, s->event->io_modify_list, s);
+        s->io.in_modify_list = true;
+}
+
 static void source_child_pidfd_unregister(sd_event_source *s) {
         assert(s);
         assert(s->type == SOURCE_CHILD);
@@ -886,6 +922,7 @@ static void event_source_pp_prioq_reshuffle(sd_event_source *s) {
 
 static void event_source_time_prioq_reshuffle(sd_event_source *s) {
         struct clock_data *d;
+        bool was_head;
 
         assert(s);
 
@@ -900,9 +937,16 @@ static void event_source_time_prioq_reshuffle(sd_event_source *s) {
         else
                 return; /* no-op for an event source which is neither a timer nor ratelimited. */
 
+        /* The timer only needs to be recalculated if the head of one of the queues might have changed,
+         * i.e. if this source was or becomes the head. Timers that get pushed forward deep inside the
+         * queue (e.g. watchdog-style deadlines) hence don't cause any rearming work. */
+        was_head = s->earliest_index == 0 || s->latest_index == 0;
+
         prioq_reshuffle(d->earliest, s, &s->earliest_index);
         prioq_reshuffle(d->latest, s, &s->latest_index);
-        d->needs_rearm = true;
+
+        if (was_head || s->earliest_index == 0 || s->latest_index == 0)
+                d->needs_rearm = true;
 }
 
 static void event_source_time_prioq_remove(
@@ -1147,6 +1191,7 @@ static int source_set_pending(sd_event_source *s, bool b) {
 
         if (b) {
                 s->pending_iteration = s->event->iteration;
+                s->pending_since = s->event->timestamp.monotonic;
 
                 r = prioq_put(s->event->pending, s, &s->pending_index);
                 if (r < 0) {
@@ -2732,13 +2777,12 @@ _public_ int sd_event_source_set_io_events(sd_event_source *s, uint32_t events)
         if (r < 0)
                 return r;
 
-        if (event_source_is_online(s)) {
-                r = source_io_register(s, s->enabled, events);
-                if (r < 0)
-                        return r;
-        }
-
+        /* Sources toggle EPOLLOUT on and off all the time as their output queues fill and drain, often
+         * several times during a single event loop iteration. Hence, don't issue EPOLL_CTL_MOD right away
+         * for sources that are registered already, but just once before the next time we poll. */
         s->io.events = events;
+        if (event_source_is_online(s))
+                source_io_add_to_modify_list(s);
 
         return 0;
 }
@@ -3126,6 +3170,10 @@ _public_ int sd_event_source_set_time(sd_event_source *s, uint64_t usec) {
         assert_return(s->event->state != SD_EVENT_FINISHED, -ESTALE);
         assert_return(!event_origin_changed(s->event), -ECHILD);
 
+        /* Fast path: nothing to reorder if the source is rearmed to the time it already has */
+        if (s->time.next == usec && !s->pending)
+                return 0;
+
         r = source_set_pending(s, false);
         if (r < 0)
                 return r;
@@ -3184,6 +3232,9 @@ _public_ int sd_event_source_set_time_accuracy(sd_event_source *s, uint64_t usec
         if (usec == 0)
                 usec = DEFAULT_ACCURACY_USEC;
 
+        if (s->time.accuracy == usec) /* Pending state was reset above, and nothing else changes */
+                return 0;
+
         s->time.accuracy = usec;
 
         event_source_time_prioq_reshuffle(s);
@@ -4156,9 +4207,33 @@ static int source_memory_pressure_initiate_dispatch(sd_event_source *s) {
         return 0; /* go on, dispatch to user callback */
 }
 
+static void source_dispatch_account(sd_event_source *s, usec_t begin, usec_t pending_since) {
+        usec_t end, d;
+
+        assert(s);
+
+        end = now(CLOCK_MONOTONIC);
+        d = usec_sub_unsigned(end, begin);
+
+        s->n_dispatched++;
+        s->dispatch_usec = usec_add(s->dispatch_usec, d);
+        s->dispatch_usec_max = MAX(s->dispatch_usec_max, d);
+
+        /* pending_since is the wakeup time of the iteration the source became pending in (or zero if it
+         * was marked before the first wakeup), hence this includes the time spent dispatching others. */
+        if (pending_since > 0)
+                s->pending_usec = usec_add(s->pending_usec, usec_sub_unsigned(begin, pending_since));
+
+        if (d >= SLOW_DISPATCH_USEC)
+                log_debug("Event source %s (type %s) blocked the event loop for %s.",
+                          strna(s->description), event_source_type_to_string(s->type),
+                          FORMAT_TIMESPAN(d, USEC_PER_MSEC));
+}
+
 static int source_dispatch(sd_event_source *s) {
         EventSourceType saved_type;
         sd_event *saved_event;
+        usec_t begin, pending_since;
         int r = 0;
 
         assert(s);
@@ -4183,11 +4258,16 @@ static int source_dispatch(sd_event_source *s) {
                 return 1;
         }
 
+        pending_since = s->pending ? s->pending_since : 0;
+
         if (!IN_SET(s->type, SOURCE_DEFER, SOURCE_EXIT)) {
                 r = source_set_pending(s, false);
                 if (r < 0)
                         return r;
-        }
+        } else if (s->pending)
+                /* Defer sources stay pending across dispatches. Account the time until the next dispatch from
+                 * this iteration on, rather than from when the source was enabled. */
+                s->pending_since = s->event->timestamp.monotonic;
 
         if (s->type != SOURCE_POST) {
                 sd_event_source *z;
@@ -4221,6 +4301,8 @@ static int source_dispatch(sd_event_source *s) {
         }
 
         s->dispatching = true;
+        begin = now(CLOCK_MONOTONIC);
+        TRACE_POINT(sd_event, dispatch_begin, s->description, (int) saved_type);
 
         switch (s->type) {
 
@@ -4311,6 +4393,8 @@ static int source_dispatch(sd_event_source *s) {
         }
 
         s->dispatching = false;
+        source_dispatch_account(s, begin, pending_since);
+        TRACE_POINT(sd_event, dispatch_end, s->description, (int) saved_type, r);
 
 finish:
         if (r < 0) {
@@ -4487,6 +4571,42 @@ static int event_memory_pressure_write_list(sd_event *e) {
         return 0;
 }
 
+static void event_io_modify_list(sd_event *e) {
+        int r;
+
+        assert(e);
+
+        for (;;) {
+                sd_event_source *s;
+
+                s = LIST_POP(io.modify_list, e->io_modify_list);
+                if (!s)
+                        break;
+
+                assert(s->type == SOURCE_IO);
+                s->io.in_modify_list = false;
+
+                r = source_io_register(s, s->enabled, s->io.events);
+                if (r >= 0)
+                        continue;
+
+                /* The change was deferred, hence the caller of sd_event_source_set_io_events() can't be
+                 * told. Treat it like a failing callback instead, and go back to the mask that is actually
+                 * in effect, so that sd_event_source_get_io_events() doesn't report one that never was. */
+                log_debug_errno(r, "Failed to update epoll event mask of event source %s (type %s), %s: %m",
+                                strna(s->description),
+                                event_source_type_to_string(s->type),
+                                s->exit_on_failure ? "exiting" : "disabling");
+
+                s->io.events = s->io.registered_events;
+
+                if (s->exit_on_failure)
+                        (void) sd_event_exit(e, r);
+
+                assert_se(sd_event_source_set_enabled(s, SD_EVENT_OFF) >= 0);
+        }
+}
+
 _public_ int sd_event_prepare(sd_event *e) {
         int r;
 
@@ -4519,6 +4639,8 @@ _public_ int sd_event_prepare(sd_event *e) {
         if (r < 0)
                 return r;
 
+        event_io_modify_list(e);
+
         r = event_arm_timer(e, &e->realtime);
         if (r < 0)
                 return r;
@@ -4627,6 +4749,9 @@ static int process_epoll(sd_event *e, usec_t timeout, int64_t threshold, int64_t
         if (e->buffered_inotify_data_list)
                 timeout = 0;
 
+        /* Event masks might have been changed after sd_event_prepare() */
+        event_io_modify_list(e);
+
         for (;;) {
                 r = epoll_wait_usec(
                                 e->epoll_fd,
@@ -5253,6 +5378,28 @@ _public_ int sd_event_source_leave_ratelimit(sd_event_source *s) {
         return 1; /* tell caller that we indeed just left the ratelimit state */
 }
 
+_public_ int sd_event_source_get_statistics(
+                sd_event_source *s,
+                uint64_t *ret_n_dispatched,
+                uint64_t *ret_dispatch_usec,
+                uint64_t *ret_dispatch_max_usec,
+                uint64_t *ret_pending_usec) {
+
+        assert_return(s, -EINVAL);
+        assert_return(!event_origin_changed(s->event), -ECHILD);
+
+        if (ret_n_dispatched)
+                *ret_n_dispatched = s->n_dispatched;
+        if (ret_dispatch_usec)
+                *ret_dispatch_usec = s->dispatch_usec;
+        if (ret_dispatch_max_usec)
+                *ret_dispatch_max_usec = s->dispatch_usec_max;
+        if (ret_pending_usec)
+                *ret_pending_usec = s->pending_usec;
+
+        return 0;
+}
+
 _public_ int sd_event_set_signal_exit(sd_event *e, int b) {
         bool change = false;
         int r;
@@ -0,0 +1,180 @@
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+
+#include <sys/eventfd.h>
+
+#include "sd-event.h"
+
+#include "alloc-util.h"
+#include "fd-util.h"
+#include "random-util.h"
+#include "rlimit-util.h"
+#include "tests.h"
+#include "time-util.h"
+
+/* Time-bounded sd-event benchmarks, measuring per-operation overhead of the event loop with a varying number
+ * of registered sources. See benchmark_run() for the output format, the number of sources is appended to the
+ * name of each benchmark. */
+
+#define BATCH 1000U
+
+static usec_t arg_duration;
+static sd_event_source **sources = NULL;
+static size_t n_sources = 0;
+
+static void sources_free(void) {
+        for (size_t i = 0; i < n_sources; i++)
+                sd_event_source_unref(sources[i]);
+
+        sources = mfree(sources);
+        n_sources = 0;
+}
+
+static void run(const char *name, unsigned n, sd_event *e, benchmark_func_t func) {
+        _cleanup_free_ char *t = NULL;
+
+        assert_se(asprintf(&t, "%s-%u", name, n) >= 0);
+        benchmark_run(t, arg_duration, func, e);
+}
+
+static int on_event(sd_event_source *s, void *userdata) {
+        return 0;
+}
+
+static int on_io(sd_event_source *s, int fd, uint32_t revents, void *userdata) {
+        return 0;
+}
+
+static int on_time(sd_event_source *s, uint64_t usec, void *userdata) {
+        return 0;
+}
+
+static uint64_t dispatch_batch(unsigned batch, void *userdata) {
+        sd_event *e = ASSERT_PTR(userdata);
+
+        for (unsigned i = 0; i < BATCH; i++)
+                assert_se(sd_event_run(e, 0) > 0);
+
+        return BATCH;
+}
+
+static uint64_t rearm_batch(unsigned batch, void *userdata) {
+        /* Modelled after the watchdog timer of PID 1: move the deadline of an armed timer into the future
+         * again before it elapses. */
+        for (unsigned i = 0; i < BATCH; i++) {
+                sd_event_source *s = sources[(batch * BATCH + i) % n_sources];
+
+                assert_se(sd_event_source_set_time_relative(s, USEC_PER_HOUR + random_u64_range(USEC_PER_MINUTE)) >= 0);
+                assert_se(sd_event_source_set_enabled(s, SD_EVENT_ONESHOT) >= 0);
+        }
+
+        return BATCH;
+}
+
+static uint64_t churn_batch(unsigned batch, void *userdata) {
+        sd_event *e = ASSERT_PTR(userdata);
+
+        for (unsigned i = 0; i < BATCH; i++) {
+                sd_event_source *s = sources[(batch * BATCH + i) % n_sources];
+
+                assert_se(sd_event_source_set_enabled(s, SD_EVENT_ON) >= 0);
+                assert_se(sd_event_source_set_enabled(s, SD_EVENT_OFF) >= 0);
+        }
+
+        /* Make sure the loop has nothing left to do, so that the disabling is actually processed */
+        assert_se(sd_event_run(e, 0) == 0);
+
+        return BATCH;
+}
+
+static void bench_defer(unsigned n) {
+        _cleanup_(sd_event_unrefp) sd_event *e = NULL;
+
+        /* All sources are always pending, every iteration dispatches one of them */
+        assert_se(sd_event_new(&e) >= 0);
+        assert_se(sources = new(sd_event_source*, n));
+        for (; n_sources < n; n_sources++)
+                assert_se(sd_event_add_defer(e, sources + n_sources, on_event, NULL) >= 0);
+
+        run("event-defer-dispatch", n, e, dispatch_batch);
+        sources_free();
+}
+
+static void bench_io(unsigned n) {
+        _cleanup_(sd_event_unrefp) sd_event *e = NULL;
+
+        /* Level triggered IO on eventfds that stay readable, so every iteration polls all of them */
+        assert_se(sd_event_new(&e) >= 0);
+        assert_se(sources = new(sd_event_source*, n));
+        for (; n_sources < n; n_sources++) {
+                _cleanup_close_ int fd = -EBADF;
+
+                assert_se((fd = eventfd(1, EFD_CLOEXEC|EFD_NONBLOCK)) >= 0);
+                assert_se(sd_event_add_io(e, sources + n_sources, fd, EPOLLIN, on_io, NULL) >= 0);
+                assert_se(sd_event_source_set_io_fd_own(sources[n_sources], true) >= 0);
+                TAKE_FD(fd);
+        }
+
+        run("event-io-dispatch", n, e, dispatch_batch);
+        sources_free();
+}
+
+static void bench_time(unsigned n) {
+        _cleanup_(sd_event_unrefp) sd_event *e = NULL;
+        _cleanup_(sd_event_source_unrefp) sd_event_source *ticker = NULL;
+
+        /* One elapsed timer that stays enabled and hence fires in every iteration, and n - 1 timers that are
+         * armed but far in the future */
+        assert_se(sd_event_new(&e) >= 0);
+        assert_se(sources = new(sd_event_source*, n));
+        for (; n_sources < n - 1; n_sources++)
+                assert_se(sd_event_add_time_relative(e, sources + n_sources, CLOCK_MONOTONIC,
+                                                     USEC_PER_HOUR + random_u64_range(USEC_PER_MINUTE), 0,
+                                                     on_time, NULL) >= 0);
+
+        assert_se(sd_event_add_time(e, &ticker, CLOCK_MONOTONIC, 1, 0, on_time, NULL) >= 0);
+        assert_se(sd_event_source_set_enabled(ticker, SD_EVENT_ON) >= 0);
+
+        run("event-time-dispatch", n, e, dispatch_batch);
+        ticker = sd_event_source_unref(ticker);
+
+        if (n_sources > 0)
+                run("event-time-rearm", n, e, rearm_batch);
+        sources_free();
+}
+
+static void bench_churn(unsigned n) {
+        _cleanup_(sd_event_unrefp) sd_event *e = NULL;
+
+        assert_se(sd_event_new(&e) >= 0);
+        assert_se(sources = new(sd_event_source*, n));
+        for (; n_sources < n; n_sources++) {
+                assert_se(sd_event_add_defer(e, sources + n_sources, on_event, NULL) >= 0);
+                assert_se(sd_event_source_set_enabled(sources[n_sources], SD_EVENT_OFF) >= 0);
+        }
+
+        run("event-enable-churn", n, e, churn_batch);
+        sources_free();
+}
+
+int main(int argc, char *argv[]) {
+        static const unsigned scales[] = { 10, 1000, 100000 };
+
+        test_setup_logging(LOG_INFO);
+
+        arg_duration = benchmark_duration(argc, argv);
+
+        /* We need one eventfd per IO source */
+        (void) rlimit_nofile_bump(-1);
+
+        FOREACH_ELEMENT(n, scales) {
+                bench_defer(*n);
+                bench_time(*n);
+                bench_churn(*n);
+
+                /* Don't exhaust the fd table, 100k file descriptors are beyond the default limits */
+                if (*n <= 1000)
+                        bench_io(*n);
+        }
+
+        return 0;
+}
@@ -741,6 +741,70 @@ TEST(simple_timeout) {
         assert_se(t >= usec_add(f, some_time));
 }
 
+static int rearm_time_handler(sd_event_source *s, uint64_t usec, void *userdata) {
+        sd_event_source **fired = ASSERT_PTR(userdata);
+
+        *fired = s;
+        return 0;
+}
+
+TEST(time_rearm) {
+        _cleanup_(sd_event_unrefp) sd_event *e = NULL;
+        _cleanup_(sd_event_source_unrefp) sd_event_source *a = NULL, *b = NULL, *c = NULL;
+        sd_event_source *fired = NULL;
+        usec_t n;
+
+        assert_se(sd_event_new(&e) >= 0);
+        assert_se(sd_event_now(e, CLOCK_MONOTONIC, &n) >= 0);
+
+        assert_se(sd_event_add_time(e, &a, CLOCK_MONOTONIC, n + 10 * USEC_PER_MSEC, 1, rearm_time_handler, &fired) >= 0);
+        assert_se(sd_event_add_time(e, &b, CLOCK_MONOTONIC, n + 20 * USEC_PER_MSEC, 1, rearm_time_handler, &fired) >= 0);
+        assert_se(sd_event_add_time(e, &c, CLOCK_MONOTONIC, n + 30 * USEC_PER_MSEC, 1, rearm_time_handler, &fired) >= 0);
+
+        /* Arm the timer fd for the first source, then push it (the head) behind the others */
+        assert_se(sd_event_run(e, 0) == 0);
+        assert_se(sd_event_source_set_time(a, n + 60 * USEC_PER_SEC) >= 0);
+        while (!fired)
+                assert_se(sd_event_run(e, UINT64_MAX) >= 0);
+        assert_se(fired == b);
+
+        /* Rearming a non-head source to a later time, or to the same time, must not lose the head */
+        fired = NULL;
+        assert_se(sd_event_source_set_time(a, n + 120 * USEC_PER_SEC) >= 0);
+        assert_se(sd_event_source_set_time(a, n + 120 * USEC_PER_SEC) >= 0);
+        assert_se(sd_event_source_set_time_accuracy(a, 1) >= 0);
+        while (!fired)
+                assert_se(sd_event_run(e, UINT64_MAX) >= 0);
+        assert_se(fired == c);
+}
+
+static int statistics_handler(sd_event_source *s, void *userdata) {
+        assert_se(usleep_safe(10 * USEC_PER_MSEC) >= 0);
+        return 0;
+}
+
+TEST(statistics) {
+        _cleanup_(sd_event_unrefp) sd_event *e = NULL;
+        _cleanup_(sd_event_source_unrefp) sd_event_source *s = NULL;
+        uint64_t n, total, max, pending;
+
+        assert_se(sd_event_new(&e) >= 0);
+        assert_se(sd_event_add_defer(e, &s, statistics_handler, NULL) >= 0);
+
+        assert_se(sd_event_source_get_statistics(s, &n, &total, &max, &pending) >= 0);
+        assert_se(n == 0 && total == 0 && max == 0 && pending == 0);
+
+        assert_se(sd_event_source_set_enabled(s, SD_EVENT_ON) >= 0);
+        for (unsigned i = 0; i < 3; i++)
+                assert_se(sd_event_run(e, 0) > 0);
+
+        assert_se(sd_event_source_get_statistics(s, &n, &total, &max, NULL) >= 0);
+        assert_se(n == 3);
+        assert_se(total >= 30 * USEC_PER_MSEC);
+        assert_se(max >= 10 * USEC_PER_MSEC);
+        assert_se(max <= total);
+}
+
 static int inotify_self_destroy_handler(sd_event_source *s, const struct inotify_event *ev, void *userdata) {
         sd_event_source **p = userdata;
 
@@ -864,6 +928,67 @@ TEST(sd_event_source_set_io_fd) {
         TAKE_FD(pfd_b[0]);
 }
 
+static int io_events_handler(sd_event_source *s, int fd, uint32_t revents, void *userdata) {
+        uint32_t *r = ASSERT_PTR(userdata);
+
+        *r |= revents;
+        return 0;
+}
+
+TEST(sd_event_source_set_io_events) {
+        _cleanup_close_pair_ int pfd[2] = EBADF_PAIR;
+        _cleanup_(sd_event_unrefp) sd_event *e = NULL;
+        _cleanup_(sd_event_source_unrefp) sd_event_source *s = NULL;
+        uint32_t revents = 0, events;
+
+        assert_se(sd_event_new(&e) >= 0);
+        assert_se(pipe2(pfd, O_CLOEXEC|O_NONBLOCK) >= 0);
+
+        /* The write end of an empty pipe is always writable, but never readable */
+        assert_se(sd_event_add_io(e, &s, pfd[1], EPOLLIN, io_events_handler, &revents) >= 0);
+        assert_se(sd_event_run(e, 0) == 0);
+        assert_se(revents == 0);
+
+        /* Flip the mask back and forth before running the loop, the last setting must win */
+        assert_se(sd_event_source_set_io_events(s, EPOLLOUT) >= 0);
+        assert_se(sd_event_source_set_io_events(s, EPOLLIN) >= 0);
+        assert_se(sd_event_source_set_io_events(s, EPOLLIN|EPOLLOUT) >= 0);
+        assert_se(sd_event_source_get_io_events(s, &events) >= 0);
+        assert_se(events == (EPOLLIN|EPOLLOUT));
+        assert_se(sd_event_run(e, 0) > 0);
+        assert_se(revents == EPOLLOUT);
+
+        revents = 0;
+        assert_se(sd_event_source_set_io_events(s, EPOLLIN) >= 0);
+        assert_se(sd_event_run(e, 0) == 0);
+        assert_se(revents == 0);
+
+        /* Changing the mask of a disabled source must not bring it online */
+        assert_se(sd_event_source_set_enabled(s, SD_EVENT_OFF) >= 0);
+        assert_se(sd_event_source_set_io_events(s, EPOLLOUT) >= 0);
+        assert_se(sd_event_run(e, 0) == 0);
+        assert_se(revents == 0);
+
+        assert_se(sd_event_source_set_enabled(s, SD_EVENT_ON) >= 0);
+        assert_se(sd_event_run(e, 0) > 0);
+        assert_se(revents == EPOLLOUT);
+
+        /* A change that cannot be applied anymore fails the source, and the mask in effect is kept */
+        _cleanup_close_ int fd = -EBADF;
+        _cleanup_(sd_event_source_unrefp) sd_event_source *t = NULL;
+        int enabled;
+
+        assert_se((fd = fcntl(pfd[1], F_DUPFD_CLOEXEC, 3)) >= 0);
+        assert_se(sd_event_add_io(e, &t, fd, EPOLLIN, io_events_handler, &revents) >= 0);
+        assert_se(sd_event_source_set_io_events(t, EPOLLOUT) >= 0);
+        fd = safe_close(fd);
+        assert_se(sd_event_prepare(e) >= 0);
+        assert_se(sd_event_source_get_enabled(t, &enabled) == 0);
+        assert_se(enabled == SD_EVENT_OFF);
+        assert_se(sd_event_source_get_io_events(t, &events) >= 0);
+        assert_se(events == EPOLLIN);
+}
+
 static int hup_callback(sd_event_source *s, int fd, uint32_t revents, void *userdata) {
         unsigned *c = userdata;
 
@@ -23,6 +23,7 @@ struct sd_hwdb {
         OrderedHashmap *properties;
         Iterator properties_iterator;
         bool properties_modified;
+        char *properties_modalias;
 };
 
 /* on-disk trie objects */
@@ -301,6 +301,11 @@ int journal_file_hmac_put_object(JournalFile *f, ObjectType type, Object *o, uin
                 sym_gcry_md_write(f->hmac, &o->tag.seqnum, sizeof(o->tag.seqnum));
                 sym_gcry_md_write(f->hmac, &o->tag.epoch, sizeof(o->tag.epoch));
                 break;
+
+        case OBJECT_BLOOM_FILTER:
+                /* All */
+                sym_gcry_md_write(f->hmac, &o->bloom_filter.n_hash_functions, le64toh(o->object.size) - offsetof(Object, bloom_filter.n_hash_functions));
+                break;
         default:
                 return -EINVAL;
         }
@@ -23,6 +23,7 @@ typedef struct EntryObject EntryObject;
 typedef struct HashTableObject HashTableObject;
 typedef struct EntryArrayObject EntryArrayObject;
 typedef struct TagObject TagObject;
+typedef struct BloomFilterObject BloomFilterObject;
 
 typedef struct HashItem HashItem;
 
@@ -38,6 +39,7 @@ typedef enum ObjectType {
         OBJECT_FIELD_HASH_TABLE,
         OBJECT_ENTRY_ARRAY,
         OBJECT_TAG,
+        OBJECT_BLOOM_FILTER,
         _OBJECT_TYPE_MAX,
         _OBJECT_TYPE_INVALID = -EINVAL,
 } ObjectType;
@@ -150,6 +152,12 @@ struct TagObject {
         uint8_t tag[TAG_LENGTH]; /* SHA-256 HMAC */
 } _packed_;
 
+struct BloomFilterObject {
+        ObjectHeader object;
+        le64_t n_hash_functions;
+        uint8_t bits[];
+} _packed_;
+
 union Object {
         ObjectHeader object;
         DataObject data;
@@ -158,6 +166,7 @@ union Object {
         HashTableObject hash_table;
         EntryArrayObject entry_array;
         TagObject tag;
+        BloomFilterObject bloom_filter;
 };
 
 enum {
@@ -192,12 +201,15 @@ enum {
         HEADER_COMPATIBLE_SEALED             = 1 << 0,
         HEADER_COMPATIBLE_TAIL_ENTRY_BOOT_ID = 1 << 1, /* if set, the last_entry_boot_id field in the header is exclusively refreshed when an entry is appended */
         HEADER_COMPATIBLE_SEALED_CONTINUOUS  = 1 << 2,
+        HEADER_COMPATIBLE_DATA_BLOOM_FILTER  = 1 << 3, /* if set, data_bloom_filter_offset points to a complete filter over all DATA objects */
         HEADER_COMPATIBLE_ANY                = HEADER_COMPATIBLE_SEALED |
                                                HEADER_COMPATIBLE_TAIL_ENTRY_BOOT_ID |
-                                               HEADER_COMPATIBLE_SEALED_CONTINUOUS,
+                                               HEADER_COMPATIBLE_SEALED_CONTINUOUS |
+                                               HEADER_COMPATIBLE_DATA_BLOOM_FILTER,
 
         HEADER_COMPATIBLE_SUPPORTED          = (HAVE_GCRYPT ? HEADER_COMPATIBLE_SEALED | HEADER_COMPATIBLE_SEALED_CONTINUOUS : 0) |
-                                               HEADER_COMPATIBLE_TAIL_ENTRY_BOOT_ID,
+                                               HEADER_COMPATIBLE_TAIL_ENTRY_BOOT_ID |
+                                               HEADER_COMPATIBLE_DATA_BLOOM_FILTER,
 };
 
 #define HEADER_SIGNATURE                                                \
@@ -242,12 +254,14 @@ enum {
         le32_t tail_entry_array_n_entries;              \
         /* Added in 254 */                              \
         le64_t tail_entry_offset;                       \
+        /* Added in 257 */                              \
+        le64_t data_bloom_filter_offset;                \
         }
 
 struct Header struct_Header__contents;
 struct Header__packed struct_Header__contents _packed_;
 assert_cc(sizeof(struct Header) == sizeof(struct Header__packed));
-assert_cc(sizeof(struct Header) == 272);
+assert_cc(sizeof(struct Header) == 280);
 
 #define FSS_HEADER_SIGNATURE                                            \
         ((const char[]) { 'K', 'S', 'H', 'H', 'R', 'H', 'L', 'P' })
@@ -48,6 +48,14 @@
 #define DEFAULT_COMPRESS_THRESHOLD (512ULL)
 #define MIN_COMPRESS_THRESHOLD (8ULL)
 
+/* Number of slots of the cache of recently used DATA objects, must be a power of two */
+#define DATA_CACHE_SIZE 256U
+
+/* Ten bits per DATA object and seven hash functions give a false positive rate of about 1% */
+#define DATA_BLOOM_FILTER_BITS_PER_ITEM 10U
+#define DATA_BLOOM_FILTER_N_HASH_FUNCTIONS 7U
+#define DATA_BLOOM_FILTER_N_HASH_FUNCTIONS_MAX 32U
+
 /* This is the minimum journal file size */
 #define JOURNAL_FILE_SIZE_MIN (512 * U64_KB)             /* 512 KiB */
 #define JOURNAL_COMPACT_SIZE_MAX ((uint64_t) UINT32_MAX) /* 4 GiB */
@@ -82,6 +90,9 @@
 /* How much to increase the journal file size at once each time we allocate something new. */
 #define FILE_SIZE_INCREASE (8 * U64_MB)                  /* 8MB */
 
+/* But at least by 1/8th of the current size */
+#define FILE_SIZE_INCREASE_RATIO 8U
+
 /* Reread fstat() of the file for detecting deletions at least this often */
 #define LAST_STAT_REFRESH_USEC (5*USEC_PER_SEC)
 
@@ -292,9 +303,11 @@ JournalFile* journal_file_close(JournalFile *f) {
         free(f->path);
 
         ordered_hashmap_free_free(f->chain_cache);
+        free(f->data_cache);
 
 #if HAVE_COMPRESSION
         free(f->compress_buffer);
+        decompress_context_free(f->decompress_context);
 #endif
 
 #if HAVE_GCRYPT
@@ -654,6 +667,10 @@ static int journal_file_verify_header(JournalFile *f) {
                 }
         }
 
+        if (JOURNAL_HEADER_CONTAINS(f->header, data_bloom_filter_offset) &&
+            !offset_is_valid(le64toh(f->header->data_bloom_filter_offset), header_size, tail_object_offset))
+                return -ENODATA;
+
         /* Verify number of objects */
         uint64_t n_objects = le64toh(f->header->n_objects);
         if (n_objects > arena_size / sizeof(ObjectHeader))
@@ -743,7 +760,7 @@ int journal_file_fstat(JournalFile *f) {
 }
 
 static int journal_file_allocate(JournalFile *f, uint64_t offset, uint64_t size) {
-        uint64_t old_size, new_size, old_header_size, old_arena_size;
+        uint64_t old_size, new_size, grow_size, old_header_size, old_arena_size;
         int r;
 
         assert(f);
@@ -790,6 +807,15 @@ static int journal_file_allocate(JournalFile *f, uint64_t offset, uint64_t size)
         if (JOURNAL_HEADER_COMPACT(f->header) && new_size > UINT32_MAX)
                 return -E2BIG;
 
+        /* Increase by larger blocks at once. The larger the file is already, the more we add, so that
+         * large files grow in fewer and larger extents (which matters in particular on COW file systems),
+         * and appending has to take this path less often. */
+        grow_size = ROUND_UP(MAX(new_size, old_size + old_size / FILE_SIZE_INCREASE_RATIO), FILE_SIZE_INCREASE);
+        if (f->metrics.max_size > 0 && grow_size > f->metrics.max_size)
+                grow_size = f->metrics.max_size;
+        if (JOURNAL_HEADER_COMPACT(f->header) && grow_size > UINT32_MAX)
+                grow_size = MAX(PAGE_ALIGN_DOWN_U64(UINT32_MAX), new_size);
+
         if (new_size > f->metrics.min_size && f->metrics.keep_free > 0) {
                 struct statvfs svfs;
 
@@ -800,13 +826,14 @@ static int journal_file_allocate(JournalFile *f, uint64_t offset, uint64_t size)
 
                         if (new_size - old_size > available)
                                 return -E2BIG;
+
+                        /* Don't let the extra space we add on top eat into the space to keep free */
+                        if (grow_size - old_size > available)
+                                grow_size = MAX(PAGE_ALIGN_DOWN_U64(old_size + available), new_size);
                 }
         }
 
-        /* Increase by larger blocks at once */
-        new_size = ROUND_UP(new_size, FILE_SIZE_INCREASE);
-        if (f->metrics.max_size > 0 && new_size > f->metrics.max_size)
-                new_size = f->metrics.max_size;
+        new_size = grow_size;
 
         /* Note that the glibc fallocate() fallback is very
            inefficient, hence we try to minimize the allocation area
@@ -869,6 +896,7 @@ static uint64_t minimum_header_size(JournalFile *f, Object *o) {
                 [OBJECT_FIELD_HASH_TABLE] = sizeof(HashTableObject),
                 [OBJECT_ENTRY_ARRAY]      = sizeof(EntryArrayObject),
                 [OBJECT_TAG]              = sizeof(TagObject),
+                [OBJECT_BLOOM_FILTER]     = sizeof(BloomFilterObject),
         };
 
         assert(f);
@@ -1072,6 +1100,25 @@ static int check_object(JournalFile *f, Object *o, uint64_t offset) {
                                                le64toh(o->tag.epoch), offset);
 
                 break;
+
+        case OBJECT_BLOOM_FILTER: {
+                uint64_t k;
+
+                if (le64toh(o->object.size) <= offsetof(Object, bloom_filter.bits))
+                        return log_debug_errno(SYNTHETIC_ERRNO(EBADMSG),
+                                               "Invalid object bloom filter size: %" PRIu64 ": %" PRIu64,
+                                               le64toh(o->object.size),
+                                               offset);
+
+                k = le64toh(o->bloom_filter.n_hash_functions);
+                if (k <= 0 || k > DATA_BLOOM_FILTER_N_HASH_FUNCTIONS_MAX)
+                        return log_debug_errno(SYNTHETIC_ERRNO(EBADMSG),
+                                               "Invalid object bloom filter number of hash functions: %" PRIu64 ": %" PRIu64,
+                                               k,
+                                               offset);
+
+                break;
+        }
         }
 
         return 0;
@@ -1357,6 +1404,183 @@ int journal_file_map_data_hash_table(JournalFile *f) {
         return 0;
 }
 
+static uint64_t data_bloom_filter_bit(uint64_t hash, uint64_t i, uint64_t n_bits) {
+        assert(n_bits > 0);
+
+        /* Derives the i-th bit position from the two halves of the 64-bit hash of a DATA object, so that we
+         * don't have to calculate any additional hashes. */
+        return ((hash & UINT32_MAX) + i * ((hash >> 32) | 1)) % n_bits;
+}
+
+int journal_file_append_data_bloom_filter(JournalFile *f) {
+        _cleanup_free_ BloomFilterObject *o = NULL;
+        HashItem items[512];
+        uint64_t n_data, n_bits, size, p, q, max_size;
+        ssize_t n;
+        int r;
+
+        assert(f);
+        assert(f->header);
+
+        /* Adds a bloom filter over the hashes of all DATA objects to the file. This is supposed to be called
+         * once nothing is going to be appended to the file anymore, i.e. when it is archived. Walking the
+         * hash table takes a while for large files, hence this is done from the offline thread, and only uses
+         * pread()/pwrite() rather than the mmap cache. */
+
+        if (!journal_file_writable(f))
+                return -EPERM;
+
+        if (!JOURNAL_HEADER_CONTAINS(f->header, data_bloom_filter_offset) ||
+            !JOURNAL_HEADER_CONTAINS(f->header, n_data))
+                return -EOPNOTSUPP;
+
+        /* Objects appended after the final tag would not be covered by the seal. */
+        if (JOURNAL_HEADER_SEALED(f->header))
+                return -EOPNOTSUPP;
+
+        if (JOURNAL_HEADER_DATA_BLOOM_FILTER(f->header))
+                return 0;
+
+        n_data = le64toh(f->header->n_data);
+        if (n_data == 0)
+                return 0;
+
+        if (n_data > UINT64_MAX / DATA_BLOOM_FILTER_BITS_PER_ITEM / 2)
+                return -EFBIG;
+
+        n_bits = ALIGN_TO(n_data * DATA_BLOOM_FILTER_BITS_PER_ITEM, 64U);
+        size = offsetof(Object, bloom_filter.bits) + n_bits / 8;
+
+        o = malloc0(size);
+        if (!o)
+                return -ENOMEM;
+
+        p = le64toh(f->header->data_hash_table_offset);
+        q = le64toh(f->header->data_hash_table_size);
+
+        for (uint64_t i = p; i < p + q; i += n) {
+                n = pread(f->fd, items, MIN(sizeof(items), p + q - i), i);
+                if (n < 0)
+                        return -errno;
+
+                /* Let's ignore any partial hash items by rounding down to the nearest multiple of HashItem. */
+                n -= n % sizeof(HashItem);
+                if (n == 0)
+                        return -EIO;
+
+                FOREACH_ARRAY(item, items, (size_t) n / sizeof(HashItem)) {
+                        Object d;
+
+                        for (uint64_t offset = le64toh(item->head_hash_offset); offset != 0;
+                             offset = le64toh(d.data.next_hash_offset)) {
+
+                                r = journal_file_read_object_header(f, OBJECT_DATA, offset, &d);
+                                if (r < 0)
+                                        return r;
+
+                                for (uint64_t k = 0; k < DATA_BLOOM_FILTER_N_HASH_FUNCTIONS; k++) {
+                                        uint64_t b = data_bloom_filter_bit(le64toh(d.data.hash), k, n_bits);
+
+                                        o->bits[b / 8] |= 1U << (b % 8);
+                                }
+                        }
+                }
+        }
+
+        o->object = (ObjectHeader) {
+                .type = OBJECT_BLOOM_FILTER,
+                .size = htole64(size),
+        };
+        o->n_hash_functions = htole64(DATA_BLOOM_FILTER_N_HASH_FUNCTIONS);
+
+        r = journal_file_tail_end_by_pread(f, &p);
+        if (r < 0)
+                return r;
+
+        /* Files are usually archived because they reached their maximum size. The filter is small compared
+         * to the rest of the file, hence allow it to exceed that limit. */
+        max_size = f->metrics.max_size;
+        f->metrics.max_size = 0;
+        r = journal_file_allocate(f, p, size);
+        f->metrics.max_size = max_size;
+        if (r < 0)
+                return r;
+
+        n = pwrite(f->fd, o, size, p);
+        if (n < 0)
+                return -errno;
+        if ((uint64_t) n != size)
+                return -EIO;
+
+        /* Only link it up once it is written, the flag tells readers that the filter is complete. */
+        f->header->tail_object_offset = htole64(p);
+        f->header->n_objects = htole64(le64toh(f->header->n_objects) + 1);
+        f->header->data_bloom_filter_offset = htole64(p);
+        f->header->compatible_flags = htole32(le32toh(f->header->compatible_flags) | HEADER_COMPATIBLE_DATA_BLOOM_FILTER);
+
+        return 1;
+}
+
+static int journal_file_map_data_bloom_filter(JournalFile *f) {
+        uint64_t p;
+        Object *o;
+        void *t;
+        int r;
+
+        assert(f);
+        assert(f->header);
+
+        if (f->data_bloom_filter)
+                return 1;
+
+        /* The filter is only complete once the file isn't written to anymore, and the flag is only set once
+         * it has been written in full. */
+        if (!JOURNAL_HEADER_DATA_BLOOM_FILTER(f->header) || f->header->state != STATE_ARCHIVED)
+                return 0;
+
+        if (!JOURNAL_HEADER_CONTAINS(f->header, data_bloom_filter_offset))
+                return 0;
+
+        p = le64toh(f->header->data_bloom_filter_offset);
+        if (p == 0)
+                return 0;
+
+        r = journal_file_move_to_object(f, OBJECT_BLOOM_FILTER, p, &o);
+        if (r < 0)
+                return r;
+
+        /* Map it once more, this time permanently, like the hash tables. */
+        r = journal_file_move_to(f, OBJECT_BLOOM_FILTER, true, p, le64toh(o->object.size), &t);
+        if (r < 0)
+                return r;
+
+        f->data_bloom_filter = t;
+        return 1;
+}
+
+bool journal_file_data_maybe_present(JournalFile *f, uint64_t hash) {
+        uint64_t n_bits, n;
+        const uint8_t *bits;
+
+        assert(f);
+
+        if (journal_file_map_data_bloom_filter(f) <= 0)
+                return true;
+
+        n_bits = (le64toh(f->data_bloom_filter->object.size) - offsetof(Object, bloom_filter.bits)) * 8;
+        n = le64toh(f->data_bloom_filter->n_hash_functions);
+        bits = f->data_bloom_filter->bits;
+
+        for (uint64_t k = 0; k < n; k++) {
+                uint64_t b = data_bloom_filter_bit(hash, k, n_bits);
+
+                if (!(bits[b / 8] & (1U << (b % 8))))
+                        return false;
+        }
+
+        return true;
+}
+
 int journal_file_map_field_hash_table(JournalFile *f) {
         uint64_t s, p;
         void *t;
@@ -1630,6 +1854,11 @@ int journal_file_find_data_object_with_hash(
         if (le64toh(f->header->data_hash_table_size) <= 0)
                 return 0;
 
+        /* Archived files might come with a bloom filter, which is much cheaper to look at than the hash
+         * table and the hash chain. */
+        if (!journal_file_data_maybe_present(f, hash))
+                return 0;
+
         /* Map the data hash table, if it isn't mapped yet. */
         r = journal_file_map_data_hash_table(f);
         if (r < 0)
@@ -1822,6 +2051,84 @@ static int maybe_compress_payload(JournalFile *f, uint8_t *dst, const uint8_t *s
 #endif
 }
 
+static DataCacheItem* journal_file_data_cache_slot(JournalFile *f, uint64_t hash) {
+        assert(f);
+
+        if (!f->data_cache) {
+                f->data_cache = new0(DataCacheItem, DATA_CACHE_SIZE);
+                if (!f->data_cache)
+                        return NULL; /* The cache is just an optimization, continue without it. */
+        }
+
+        return f->data_cache + (hash & (DATA_CACHE_SIZE - 1));
+}
+
+static int journal_file_find_data_object_cached(
+                JournalFile *f,
+                const void *data,
+                uint64_t size,
+                uint64_t hash,
+                Object **ret_object,
+                uint64_t *ret_offset) {
+
+        DataCacheItem *i;
+        uint64_t p;
+        Object *o;
+        int r;
+
+        assert(f);
+
+        i = journal_file_data_cache_slot(f, hash);
+        if (i && i->offset > 0 && i->hash == hash) {
+                size_t rsize;
+                void *d;
+
+                /* The hash matches, but let's verify the payload anyway, as the slot might have been
+                 * taken by another object with a colliding hash since. */
+
+                r = journal_file_move_to_object(f, OBJECT_DATA, i->offset, &o);
+                if (r < 0)
+                        return r;
+
+                r = journal_file_data_payload(f, o, i->offset, NULL, 0, 0, &d, &rsize);
+                if (r < 0)
+                        return r;
+                assert(r > 0);
+
+                if (memcmp_nn(data, size, d, rsize) == 0) {
+                        f->n_data_cache_hit++;
+
+                        if (ret_object)
+                                *ret_object = o;
+
+                        if (ret_offset)
+                                *ret_offset = i->offset;
+
+                        return 1;
+                }
+        }
+
+        f->n_data_cache_miss++;
+
+        r = journal_file_find_data_object_with_hash(f, data, size, hash, &o, &p);
+        if (r <= 0)
+                return r;
+
+        if (i)
+                *i = (DataCacheItem) {
+                        .hash = hash,
+                        .offset = p,
+                };
+
+        if (ret_object)
+                *ret_object = o;
+
+        if (ret_offset)
+                *ret_offset = p;
+
+        return 1;
+}
+
 static int journal_file_append_data(
                 JournalFile *f,
                 const void *data,
@@ -1831,6 +2138,7 @@ static int journal_file_append_data(
 
         uint64_t hash, p, osize;
         Object *o, *fo;
+        DataCacheItem *i;
         size_t rsize = 0;
         const void *eq;
         int r;
@@ -1842,7 +2150,7 @@ static int journal_file_append_data(
 
         hash = journal_file_hash_data(f, data, size);
 
-        r = journal_file_find_data_object_with_hash(f, data, size, hash, ret_object, ret_offset);
+        r = journal_file_find_data_object_cached(f, data, size, hash, ret_object, ret_offset);
         if (r < 0)
                 return r;
         if (r > 0)
@@ -1896,6 +2204,13 @@ static int journal_file_append_data(
         o->data.next_field_offset = fo->field.head_data_offset;
         fo->field.head_data_offset = le64toh(p);
 
+        i = journal_file_data_cache_slot(f, hash);
+        if (i)
+                *i = (DataCacheItem) {
+                        .hash = hash,
+                        .offset = p,
+                };
+
         if (ret_object)
                 *ret_object = o;
 
@@ -1928,8 +2243,8 @@ static int maybe_decompress_payload(
                 int r;
 
                 if (field) {
-                        r = decompress_startswith(compression, payload, size, &f->compress_buffer, field,
-                                                  field_length, '=');
+                        r = decompress_startswith_full(compression, payload, size, &f->decompress_context,
+                                                       &f->compress_buffer, field, field_length, '=');
                         if (r < 0)
                                 return log_debug_errno(r,
                                                        "Cannot decompress %s object of length %" PRIu64 ": %m",
@@ -1944,7 +2259,8 @@ static int maybe_decompress_payload(
                         }
                 }
 
-                r = decompress_blob(compression, payload, size, &f->compress_buffer, &rsize, 0);
+                r = decompress_blob_full(compression, payload, size, &f->decompress_context,
+                                         &f->compress_buffer, &rsize, 0);
                 if (r < 0)
                         return r;
 
@@ -3344,6 +3660,34 @@ static int test_object_seqnum(JournalFile *f, uint64_t p, uint64_t needle) {
                 return TEST_RIGHT;
 }
 
+static bool needle_in_range(uint64_t head, uint64_t tail, uint64_t needle, direction_t direction) {
+        /* Returns false if there can't be any entry at or beyond the needle in the specified direction,
+         * judging by the values of the first and the last entry of the file. */
+
+        if (head == 0 && tail == 0)
+                return false; /* No entries */
+
+        return direction == DIRECTION_DOWN ? needle <= tail : needle >= head;
+}
+
+bool journal_file_seqnum_in_range(JournalFile *f, uint64_t seqnum, direction_t direction) {
+        assert(f);
+        assert(f->header);
+
+        return needle_in_range(le64toh(READ_NOW(f->header->head_entry_seqnum)),
+                               le64toh(READ_NOW(f->header->tail_entry_seqnum)),
+                               seqnum, direction);
+}
+
+bool journal_file_realtime_in_range(JournalFile *f, uint64_t realtime, direction_t direction) {
+        assert(f);
+        assert(f->header);
+
+        return needle_in_range(le64toh(READ_NOW(f->header->head_entry_realtime)),
+                               le64toh(READ_NOW(f->header->tail_entry_realtime)),
+                               realtime, direction);
+}
+
 int journal_file_move_to_entry_by_seqnum(
                 JournalFile *f,
                 uint64_t seqnum,
@@ -3354,6 +3698,11 @@ int journal_file_move_to_entry_by_seqnum(
         assert(f);
         assert(f->header);
 
+        /* Check the header first, so that we don't have to look at any entry arrays of files that don't
+         * contain the entry anyway. */
+        if (!journal_file_seqnum_in_range(f, seqnum, direction))
+                return 0;
+
         return generic_array_bisect(
                         f,
                         le64toh(f->header->entry_array_offset),
@@ -3395,6 +3744,9 @@ int journal_file_move_to_entry_by_realtime(
         assert(f);
         assert(f->header);
 
+        if (!journal_file_realtime_in_range(f, realtime, direction))
+                return 0;
+
         return generic_array_bisect(
                         f,
                         le64toh(f->header->entry_array_offset),
@@ -3746,6 +4098,9 @@ int journal_file_move_to_entry_by_seqnum_for_data(
         assert(d);
         assert(d->object.type == OBJECT_DATA);
 
+        if (!journal_file_seqnum_in_range(f, seqnum, direction))
+                return 0;
+
         return generic_array_bisect_for_data(
                         f,
                         d,
@@ -3766,6 +4121,9 @@ int journal_file_move_to_entry_by_realtime_for_data(
         assert(d);
         assert(d->object.type == OBJECT_DATA);
 
+        if (!journal_file_realtime_in_range(f, realtime, direction))
+                return 0;
+
         return generic_array_bisect_for_data(
                         f,
                         d,
@@ -3817,6 +4175,14 @@ void journal_file_dump(JournalFile *f) {
                                  le64toh(o->tag.epoch));
                         break;
 
+                case OBJECT_BLOOM_FILTER:
+                        assert(s);
+
+                        log_info("Type: %s n_hash_functions=%"PRIu64"\n",
+                                 s,
+                                 le64toh(o->bloom_filter.n_hash_functions));
+                        break;
+
                 default:
                         if (s)
                                 log_info("Type: %s \n", s);
@@ -3857,7 +4223,7 @@ void journal_file_print_header(JournalFile *f) {
                "Boot ID: %s\n"
                "Sequential number ID: %s\n"
                "State: %s\n"
-               "Compatible flags:%s%s%s%s\n"
+               "Compatible flags:%s%s%s%s%s\n"
                "Incompatible flags:%s%s%s%s%s%s\n"
                "Header size: %"PRIu64"\n"
                "Arena size: %"PRIu64"\n"
@@ -3882,6 +4248,7 @@ void journal_file_print_header(JournalFile *f) {
                JOURNAL_HEADER_SEALED(f->header) ? " SEALED" : "",
                JOURNAL_HEADER_SEALED_CONTINUOUS(f->header) ? " SEALED_CONTINUOUS" : "",
                JOURNAL_HEADER_TAIL_ENTRY_BOOT_ID(f->header) ? " TAIL_ENTRY_BOOT_ID" : "",
+               JOURNAL_HEADER_DATA_BLOOM_FILTER(f->header) ? " DATA_BLOOM_FILTER" : "",
                (le32toh(f->header->compatible_flags) & ~HEADER_COMPATIBLE_ANY) ? " ???" : "",
                JOURNAL_HEADER_COMPRESSED_XZ(f->header) ? " COMPRESSED-XZ" : "",
                JOURNAL_HEADER_COMPRESSED_LZ4(f->header) ? " COMPRESSED-LZ4" : "",
@@ -3929,6 +4296,11 @@ void journal_file_print_header(JournalFile *f) {
                 printf("Deepest data hash chain: %" PRIu64"\n",
                        f->header->data_hash_chain_depth);
 
+
+        if (f->n_data_cache_hit + f->n_data_cache_miss > 0)
+                printf("Data object cache: %"PRIu64" hits, %"PRIu64" misses\n",
+                       f->n_data_cache_hit, f->n_data_cache_miss);
+
         if (fstat(f->fd, &st) >= 0)
                 printf("Disk usage: %s\n", FORMAT_BYTES((uint64_t) st.st_blocks * 512ULL));
 }
@@ -4500,6 +4872,147 @@ int journal_file_copy_entry(
         return r;
 }
 
+static int journal_file_rewrite_data(JournalFile *from, JournalFile *to) {
+        uint64_t m;
+        int r;
+
+        assert(from);
+        assert(to);
+
+        /* Appends all DATA objects of the source file that are referenced by entries to the target file,
+         * ordered by the field they belong to, so that they end up next to each other. */
+
+        r = journal_file_map_field_hash_table(from);
+        if (r < 0)
+                return r;
+
+        m = le64toh(from->header->field_hash_table_size) / sizeof(HashItem);
+        for (uint64_t i = 0; i < m; i++)
+                for (uint64_t q = le64toh(from->field_hash_table[i].head_hash_offset); q > 0;) {
+                        uint64_t d;
+                        Object *o;
+
+                        r = journal_file_move_to_object(from, OBJECT_FIELD, q, &o);
+                        if (r < 0)
+                                return r;
+
+                        q = le64toh(o->field.next_hash_offset);
+                        d = le64toh(o->field.head_data_offset);
+
+                        while (d > 0) {
+                                void *data;
+                                size_t l;
+
+                                r = journal_file_move_to_object(from, OBJECT_DATA, d, &o);
+                                if (r < 0)
+                                        return r;
+
+                                if (le64toh(o->data.n_entries) == 0) {
+                                        d = le64toh(o->data.next_field_offset);
+                                        continue;
+                                }
+
+                                r = journal_file_data_payload(from, o, d, NULL, 0, 0, &data, &l);
+                                if (r < 0)
+                                        return r;
+                                assert(r > 0);
+
+                                r = journal_file_append_data(to, data, l, NULL, NULL);
+                                if (r < 0)
+                                        return r;
+
+                                /* Appending might have unmapped the source object, hence look at it again. */
+                                r = journal_file_move_to_object(from, OBJECT_DATA, d, &o);
+                                if (r < 0)
+                                        return r;
+
+                                d = le64toh(o->data.next_field_offset);
+                        }
+                }
+
+        return 0;
+}
+
+int journal_file_rewrite(
+                JournalFile *from,
+                const char *fname,
+                MMapCache *mmap_cache,
+                JournalFile **ret) {
+
+        _cleanup_(journal_file_closep) JournalFile *to = NULL;
+        JournalMetrics metrics;
+        uint64_t size, p = 0;
+        Object *o;
+        int r;
+
+        assert(from);
+        assert(from->header);
+        assert(fname);
+        assert(mmap_cache);
+        assert(ret);
+
+        /* Copies all entries of the specified file into a new file, which is laid out for reading: all DATA
+         * objects are clustered by field, followed by the entries and entry arrays, and the hash tables are
+         * sized after the contents of the source file rather than the configured maximum file size. The
+         * sequence numbers of all entries are retained. */
+
+        if (JOURNAL_HEADER_SEALED(from->header))
+                return -EPERM; /* We can't reseal the copy */
+
+        /* Size the data hash table after the file we copy from, with some headroom for the different
+         * layout, instead of the usually much larger configured maximum. */
+        size = le64toh(from->header->header_size) + le64toh(from->header->arena_size);
+        journal_reset_metrics(&metrics);
+        metrics.max_size = MAX(size + size / 4, JOURNAL_FILE_SIZE_MIN);
+        metrics.min_size = JOURNAL_FILE_SIZE_MIN;
+
+        r = journal_file_open(
+                        /* fd= */ -EBADF,
+                        fname,
+                        O_RDWR|O_CREAT|O_EXCL|O_CLOEXEC,
+                        JOURNAL_COMPRESS,
+                        0640,
+                        /* compress_threshold_bytes= */ UINT64_MAX,
+                        &metrics,
+                        mmap_cache,
+                        /* template= */ NULL,
+                        &to);
+        if (r < 0)
+                return r;
+
+        /* The copy stands in for the original, hence it carries over its identity rather than ours. */
+        to->header->seqnum_id = from->header->seqnum_id;
+        to->header->machine_id = from->header->machine_id;
+
+        r = journal_file_rewrite_data(from, to);
+        if (r < 0)
+                return r;
+
+        for (;;) {
+                uint64_t seqnum;
+
+                r = journal_file_next_entry(from, p, DIRECTION_DOWN, &o, &p);
+                if (r < 0)
+                        return r;
+                if (r == 0)
+                        break;
+
+                /* Make sure the copied entry gets the same sequence number as the original. */
+                seqnum = le64toh(o->entry.seqnum) - 1;
+
+                r = journal_file_copy_entry(from, to, o, p, &seqnum, NULL);
+                if (r < 0)
+                        return r;
+        }
+
+        r = journal_file_append_data_bloom_filter(to);
+        if (r < 0)
+                return r;
+
+        *ret = TAKE_PTR(to);
+        return 0;
+}
+
 void journal_reset_metrics(JournalMetrics *m) {
         assert(m);
 
@@ -4678,6 +5191,7 @@ static const char * const journal_object_type_table[] = {
         [OBJECT_FIELD_HASH_TABLE] = "field hash table",
         [OBJECT_ENTRY_ARRAY]      = "entry array",
         [OBJECT_TAG]              = "tag",
+        [OBJECT_BLOOM_FILTER]     = "bloom filter",
 };
 
 DEFINE_STRING_TABLE_LOOKUP_TO_STRING(journal_object_type, ObjectType);
@@ -59,6 +59,11 @@ typedef enum OfflineState {
         OFFLINE_DONE,
 } OfflineState;
 
+typedef struct DataCacheItem {
+        uint64_t hash;
+        uint64_t offset;
+} DataCacheItem;
+
 typedef struct JournalFile {
         int fd;
         MMapFileDescriptor *cache_fd;
@@ -81,6 +86,7 @@ typedef struct JournalFile {
         Header *header;
         HashItem *data_hash_table;
         HashItem *field_hash_table;
+        BloomFilterObject *data_bloom_filter;
 
         uint64_t current_offset;
         uint64_t current_seqnum;
@@ -96,6 +102,12 @@ typedef struct JournalFile {
 
         OrderedHashmap *chain_cache;
 
+        /* Recently looked up or written DATA objects, indexed by their hash, so that values that are
+         * appended over and over again (e.g. trusted fields) don't need a walk of the data hash table. */
+        DataCacheItem *data_cache;
+        uint64_t n_data_cache_hit;
+        uint64_t n_data_cache_miss;
+
         pthread_t offline_thread;
         volatile OfflineState offline_state;
 
@@ -104,6 +116,7 @@ typedef struct JournalFile {
         uint64_t compress_threshold_bytes;
 #if HAVE_COMPRESSION
         void *compress_buffer;
+        DecompressContext *decompress_context;
 #endif
 
 #if HAVE_GCRYPT
@@ -196,6 +209,9 @@ static inline bool VALID_EPOCH(uint64_t u) {
 #define JOURNAL_HEADER_TAIL_ENTRY_BOOT_ID(h) \
         FLAGS_SET(le32toh((h)->compatible_flags), HEADER_COMPATIBLE_TAIL_ENTRY_BOOT_ID)
 
+#define JOURNAL_HEADER_DATA_BLOOM_FILTER(h) \
+        FLAGS_SET(le32toh((h)->compatible_flags), HEADER_COMPATIBLE_DATA_BLOOM_FILTER)
+
 #define JOURNAL_HEADER_COMPRESSED_XZ(h) \
         FLAGS_SET(le32toh((h)->incompatible_flags), HEADER_INCOMPATIBLE_COMPRESSED_XZ)
 
@@ -292,6 +308,8 @@ void journal_file_save_location(JournalFile *f, Object *o, uint64_t offset);
 int journal_file_next_entry(JournalFile *f, uint64_t p, direction_t direction, Object **ret_object, uint64_t *ret_offset);
 
 int journal_file_move_to_entry_by_offset(JournalFile *f, uint64_t p, direction_t direction, Object **ret_object, uint64_t *ret_offset);
+bool journal_file_seqnum_in_range(JournalFile *f, uint64_t seqnum, direction_t direction);
+bool journal_file_realtime_in_range(JournalFile *f, uint64_t realtime, direction_t direction);
 int journal_file_move_to_entry_by_seqnum(JournalFile *f, uint64_t seqnum, direction_t direction, Object **ret_object, uint64_t *ret_offset);
 int journal_file_move_to_entry_by_realtime(JournalFile *f, uint64_t realtime, direction_t direction, Object **ret_object, uint64_t *ret_offset);
 int journal_file_move_to_entry_by_monotonic(JournalFile *f, sd_id128_t boot_id, uint64_t monotonic, direction_t direction, Object **ret_object, uint64_t *ret_offset);
@@ -304,6 +322,7 @@ int journal_file_move_to_entry_by_realtime_for_data(JournalFile *f, Object *d, u
 int journal_file_move_to_entry_by_monotonic_for_data(JournalFile *f, Object *d, sd_id128_t boot_id, uint64_t monotonic, direction_t direction, Object **ret_object, uint64_t *ret_offset);
 
 int journal_file_copy_entry(JournalFile *from, JournalFile *to, Object *o, uint64_t p, uint64_t *seqnum, sd_id128_t *seqnum_id);
+int journal_file_rewrite(JournalFile *from, const char *fname, MMapCache *mmap_cache, JournalFile **ret);
 
 void journal_file_dump(JournalFile *f);
 void journal_file_print_header(JournalFile *f);
@@ -325,6 +344,8 @@ bool journal_file_rotate_suggested(JournalFile *f, usec_t max_file_usec, int log
 
 int journal_file_map_data_hash_table(JournalFile *f);
 int journal_file_map_field_hash_table(JournalFile *f);
+int journal_file_append_data_bloom_filter(JournalFile *f);
+bool journal_file_data_maybe_present(JournalFile *f, uint64_t hash);
 
 static inline Compression JOURNAL_FILE_COMPRESSION(JournalFile *f) {
         assert(f);
@@ -37,6 +37,7 @@ struct Match {
         char *data;
         size_t size;
         uint64_t hash; /* old-style jenkins hash. New-style siphash is different per file, hence won't be cached here */
+        Hashmap *data_offsets; /* JournalFile* → offset of the matching DATA object in that file */
 
         /* For terms */
         LIST_HEAD(Match, matches);
@@ -94,6 +95,14 @@ struct sd_journal {
         JournalFile *current_file;
         uint64_t current_field;
 
+        /* Files with a pending candidate entry, as a binary heap ordered by compare_locations(). Only
+         * maintained for SD_JOURNAL_ASSUME_IMMUTABLE, see real_journal_next(). */
+        JournalFile **merge_heap;
+        size_t n_merge_heap;
+        direction_t merge_direction;
+        unsigned merge_invalidate_counter;
+        bool merge_heap_valid;
+
         Match *level0, *level1, *level2;
         Set *exclude_syslog_identifiers;
 
@@ -108,6 +117,9 @@ struct sd_journal {
         char *unique_field;
         JournalFile *unique_file;
         uint64_t unique_offset;
+        Set *unique_values;          /* Values returned so far, so that we don't have to look for them in
+                                      * all previously traversed files */
+        size_t unique_values_size;
 
         /* Iterating through known fields */
         JournalFile *fields_file;
@@ -124,6 +136,7 @@ struct sd_journal {
                                     removed, and there were no more
                                     files, so sd_j_enumerate_unique
                                     will return a value equal to 0. */
+        bool unique_values_overflow:1;
         bool fields_file_lost:1;
         bool has_runtime_files:1;
         bool has_persistent_files:1;
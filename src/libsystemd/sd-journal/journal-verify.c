@@ -378,6 +378,23 @@ static int journal_file_object_verify(JournalFile *f, uint64_t offset, Object *o
                         return -EBADMSG;
                 }
 
+                break;
+
+        case OBJECT_BLOOM_FILTER:
+                if (le64toh(o->object.size) <= offsetof(Object, bloom_filter.bits)) {
+                        error(offset,
+                              "Invalid object bloom filter size: %"PRIu64,
+                              le64toh(o->object.size));
+                        return -EBADMSG;
+                }
+
+                if (le64toh(o->bloom_filter.n_hash_functions) <= 0) {
+                        error(offset,
+                              "Invalid object bloom filter number of hash functions: %"PRIu64,
+                              le64toh(o->bloom_filter.n_hash_functions));
+                        return -EBADMSG;
+                }
+
                 break;
         }
 
@@ -453,20 +470,18 @@ static int verify_data(
         /* We already checked that earlier */
         assert(o->data.entry_offset);
 
+        /* Note that we only check that the referenced entries are valid entry objects here, but not that
+         * they are also listed in the main entry array: verify_entry_array() ran before us and made sure
+         * the main entry array is a strictly ordered list of n_entries valid entry objects, i.e. that it
+         * contains every entry object of the file. Looking each reference up in it again would bisect the
+         * whole entry array chain for every single entry of every data object. */
+
         last = q = le64toh(o->data.entry_offset);
         if (!contains_uint64(cache_entry_fd, n_entries, q)) {
                 error(p, "Data object references invalid entry at "OFSfmt, q);
                 return -EBADMSG;
         }
 
-        r = journal_file_move_to_entry_by_offset(f, q, DIRECTION_DOWN, NULL, NULL);
-        if (r < 0)
-                return r;
-        if (r == 0) {
-                error(q, "Entry object doesn't exist in the main entry array");
-                return -EBADMSG;
-        }
-
         i = 1;
         while (i < n) {
                 uint64_t next, m, j;
@@ -506,14 +521,6 @@ static int verify_data(
                                 return -EBADMSG;
                         }
 
-                        r = journal_file_move_to_entry_by_offset(f, q, DIRECTION_DOWN, NULL, NULL);
-                        if (r < 0)
-                                return r;
-                        if (r == 0) {
-                                error(q, "Entry object doesn't exist in the main entry array");
-                                return -EBADMSG;
-                        }
-
                         /* Pointer might have moved, reposition */
                         r = journal_file_move_to_object(f, OBJECT_ENTRY_ARRAY, a, &o);
                         if (r < 0)
@@ -823,7 +830,7 @@ int journal_file_verify(
         uint64_t entry_seqnum = 0, entry_monotonic = 0, entry_realtime = 0;
         usec_t min_entry_realtime = USEC_INFINITY, max_entry_realtime = 0;
         sd_id128_t entry_boot_id = {};  /* Unnecessary initialization to appease gcc */
-        bool entry_seqnum_set = false, entry_monotonic_set = false, entry_realtime_set = false, found_main_entry_array = false;
+        bool entry_seqnum_set = false, entry_monotonic_set = false, entry_realtime_set = false, found_main_entry_array = false, found_bloom_filter = false;
         uint64_t n_objects = 0, n_entries = 0, n_data = 0, n_fields = 0, n_data_hash_tables = 0, n_field_hash_tables = 0, n_entry_arrays = 0, n_tags = 0;
         usec_t last_usec = 0;
         _cleanup_close_ int data_fd = -EBADF, entry_fd = -EBADF, entry_array_fd = -EBADF;
@@ -999,6 +1006,12 @@ int journal_file_verify(
                         if (r < 0)
                                 goto fail;
 
+                        if (!journal_file_data_maybe_present(f, le64toh(o->data.hash))) {
+                                error(p, "Data object missing in bloom filter");
+                                r = -EBADMSG;
+                                goto fail;
+                        }
+
                         n_data++;
                         break;
 
@@ -1243,6 +1256,18 @@ int journal_file_verify(
 
                         n_tags++;
                         break;
+
+                case OBJECT_BLOOM_FILTER:
+                        if (found_bloom_filter ||
+                            !JOURNAL_HEADER_CONTAINS(f->header, data_bloom_filter_offset) ||
+                            p != le64toh(f->header->data_bloom_filter_offset)) {
+                                error(p, "Unreferenced or duplicate bloom filter");
+                                r = -EBADMSG;
+                                goto fail;
+                        }
+
+                        found_bloom_filter = true;
+                        break;
                 }
 
                 if (p == le64toh(f->header->tail_object_offset)) {
@@ -1325,6 +1350,12 @@ int journal_file_verify(
                 goto fail;
         }
 
+        if (!found_bloom_filter && JOURNAL_HEADER_DATA_BLOOM_FILTER(f->header)) {
+                error(0, "Missing bloom filter");
+                r = -EBADMSG;
+                goto fail;
+        }
+
         if (entry_seqnum_set &&
             entry_seqnum != le64toh(f->header->tail_entry_seqnum)) {
                 error(offsetof(Header, tail_entry_seqnum),
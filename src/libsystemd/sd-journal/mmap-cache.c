@@ -7,6 +7,7 @@
 #include "alloc-util.h"
 #include "errno-util.h"
 #include "fd-util.h"
+#include "format-util.h"
 #include "hashmap.h"
 #include "list.h"
 #include "log.h"
@@ -42,6 +43,14 @@ struct Window {
         LIST_FIELDS(Window, unused);
 };
 
+typedef struct AccessPattern {
+        /* The range of the window most recently mapped for a category, used to detect sequential walks
+         * through the file. */
+        uint64_t offset;
+        size_t size;
+        unsigned n_sequential;
+} AccessPattern;
+
 struct MMapFileDescriptor {
         MMapCache *cache;
 
@@ -50,6 +59,8 @@ struct MMapFileDescriptor {
         bool sigbus;
 
         LIST_HEAD(Window, windows);
+
+        AccessPattern access_by_category[_MMAP_CACHE_CATEGORY_MAX];
 };
 
 struct MMapCache {
@@ -59,6 +70,11 @@ struct MMapCache {
         unsigned n_category_cache_hit;
         unsigned n_window_list_hit;
         unsigned n_missed;
+        unsigned n_sequential;
+        unsigned n_reused;
+
+        uint64_t n_bytes_mapped;
+        uint64_t n_bytes_mapped_max;
 
         Hashmap *fds;
 
@@ -79,6 +95,12 @@ struct MMapCache {
 # define WINDOW_SIZE ((size_t) (UINT64_C(8) * UINT64_C(1024) * UINT64_C(1024)))
 #endif
 
+/* When a category keeps missing right next to the window it mapped last, it's walking through the file
+ * sequentially (e.g. entry array chains while iterating), hence map larger windows ahead of the access and
+ * ask the kernel to read ahead accordingly. */
+#define WINDOW_SIZE_SEQUENTIAL (4 * WINDOW_SIZE)
+#define SEQUENTIAL_MIN 2
+
 MMapCache* mmap_cache_new(void) {
         MMapCache *m;
 
@@ -98,8 +120,10 @@ static Window* window_unlink(Window *w) {
 
         MMapCache *m = mmap_cache_fd_cache(w->fd);
 
-        if (w->ptr)
+        if (w->ptr) {
                 munmap(w->ptr, w->size);
+                m->n_bytes_mapped -= w->size;
+        }
 
         if (FLAGS_SET(w->flags, WINDOW_IN_UNUSED)) {
                 if (m->last_unused == w)
@@ -169,9 +193,14 @@ static Window* window_add(MMapFileDescriptor *f, uint64_t offset, size_t size, v
                 if (!w)
                         return NULL;
                 m->n_windows++;
-        } else
+        } else {
                 /* Reuse an existing one */
                 w = window_unlink(m->last_unused);
+                m->n_reused++;
+        }
+
+        m->n_bytes_mapped += size;
+        m->n_bytes_mapped_max = MAX(m->n_bytes_mapped_max, m->n_bytes_mapped);
 
         *w = (Window) {
                 .fd = f,
@@ -277,16 +306,44 @@ static int mmap_try_harder(MMapFileDescriptor *f, void *addr, int flags, uint64_
         }
 }
 
+static int access_pattern_update(MMapFileDescriptor *f, MMapCacheCategory c, uint64_t offset, size_t size) {
+        AccessPattern *a;
+
+        assert(f);
+        assert(c >= 0 && c < _MMAP_CACHE_CATEGORY_MAX);
+
+        /* Returns > 0 if we are walking upwards through the file, < 0 if downwards, and 0 otherwise. */
+
+        a = f->access_by_category + c;
+        if (a->size == 0)
+                return 0;
+
+        if (offset >= a->offset + a->size && offset - (a->offset + a->size) < WINDOW_SIZE) {
+                a->n_sequential++;
+                return a->n_sequential >= SEQUENTIAL_MIN ? 1 : 0;
+        }
+
+        if (offset + size <= a->offset && a->offset - (offset + size) < WINDOW_SIZE) {
+                a->n_sequential++;
+                return a->n_sequential >= SEQUENTIAL_MIN ? -1 : 0;
+        }
+
+        a->n_sequential = 0;
+        return 0;
+}
+
 static int add_mmap(
                 MMapFileDescriptor *f,
+                MMapCacheCategory c,
                 uint64_t offset,
                 size_t size,
                 struct stat *st,
                 Window **ret) {
 
+        MMapCache *m = mmap_cache_fd_cache(f);
         Window *w;
         void *d;
-        int r;
+        int r, sequential;
 
         assert(f);
         assert(size > 0);
@@ -299,7 +356,16 @@ static int add_mmap(
         size = PAGE_ALIGN(size + PAGE_OFFSET_U64(offset));
         offset = PAGE_ALIGN_DOWN_U64(offset);
 
-        if (size < WINDOW_SIZE) {
+        sequential = access_pattern_update(f, c, offset, size);
+
+        if (sequential > 0 && size < WINDOW_SIZE_SEQUENTIAL)
+                /* Map ahead of the access, as that's where the next ones will be. */
+                size = WINDOW_SIZE_SEQUENTIAL;
+        else if (sequential < 0 && size < WINDOW_SIZE_SEQUENTIAL) {
+                /* Map behind the access. */
+                offset = LESS_BY(offset, WINDOW_SIZE_SEQUENTIAL - size);
+                size = WINDOW_SIZE_SEQUENTIAL;
+        } else if (size < WINDOW_SIZE) {
                 uint64_t delta;
 
                 delta = PAGE_ALIGN((WINDOW_SIZE - size) / 2);
@@ -325,12 +391,22 @@ static int add_mmap(
         if (r < 0)
                 return r;
 
+        if (sequential != 0) {
+                m->n_sequential++;
+
+                /* This is merely a hint, hence ignore failures. */
+                (void) madvise(d, size, sequential > 0 ? MADV_SEQUENTIAL : MADV_WILLNEED);
+        }
+
         w = window_add(f, offset, size, d);
         if (!w) {
                 (void) munmap(d, size);
                 return -ENOMEM;
         }
 
+        f->access_by_category[c].offset = offset;
+        f->access_by_category[c].size = size;
+
         *ret = w;
         return 0;
 }
@@ -376,7 +452,7 @@ int mmap_cache_fd_get(
         m->n_missed++;
 
         /* Create a new mmap */
-        r = add_mmap(f, offset, size, st, &w);
+        r = add_mmap(f, c, offset, size, st, &w);
         if (r < 0)
                 return r;
 
@@ -433,10 +509,19 @@ found:
 }
 
 void mmap_cache_stats_log_debug(MMapCache *m) {
+        unsigned n_total;
+
         assert(m);
 
-        log_debug("mmap cache statistics: %u category cache hit, %u window list hit, %u miss, %u files, %u windows, %u unused",
-                  m->n_category_cache_hit, m->n_window_list_hit, m->n_missed, hashmap_size(m->fds), m->n_windows, m->n_unused);
+        n_total = m->n_category_cache_hit + m->n_window_list_hit + m->n_missed;
+
+        log_debug("mmap cache statistics: %u category cache hit, %u window list hit, %u miss (%u.%u%% hit rate), "
+                  "%u sequential, %u reused windows, %u files, %u windows, %u unused, %s mapped (%s max)",
+                  m->n_category_cache_hit, m->n_window_list_hit, m->n_missed,
+                  n_total > 0 ? (unsigned) ((uint64_t) (n_total - m->n_missed) * 100 / n_total) : 100,
+                  n_total > 0 ? (unsigned) ((uint64_t) (n_total - m->n_missed) * 1000 / n_total % 10) : 0,
+                  m->n_sequential, m->n_reused, hashmap_size(m->fds), m->n_windows, m->n_unused,
+                  FORMAT_BYTES(m->n_bytes_mapped), FORMAT_BYTES(m->n_bytes_mapped_max));
 }
 
 static void mmap_cache_process_sigbus(MMapCache *m) {
@@ -38,6 +38,8 @@
 #include "prioq.h"
 #include "process-util.h"
 #include "replace-var.h"
+#include "set.h"
+#include "siphash24.h"
 #include "sort-util.h"
 #include "stat-util.h"
 #include "stdio-util.h"
@@ -54,6 +56,12 @@
 
 #define DEFAULT_DATA_THRESHOLD (64*1024)
 
+/* The maximum number of values and bytes we remember while enumerating unique field values. As long as we
+ * stay below these every value is checked against this set only, without looking it up in all previously
+ * traversed files. Beyond them we fall back to the latter. */
+#define UNIQUE_VALUES_MAX 65536U
+#define UNIQUE_VALUES_BYTES_MAX (64U*1024U*1024U)
+
 DEFINE_PRIVATE_ORIGIN_ID_HELPERS(sd_journal, journal);
 
 static void remove_file_real(sd_journal *j, JournalFile *f);
@@ -100,6 +108,7 @@ static void detach_location(sd_journal *j) {
 
         j->current_file = NULL;
         j->current_field = 0;
+        j->merge_heap_valid = false;
 
         ORDERED_HASHMAP_FOREACH(f, j->files)
                 journal_file_reset_location(f);
@@ -211,10 +220,24 @@ static Match *match_free(Match *m) {
         if (m->parent)
                 LIST_REMOVE(matches, m->parent->matches, m);
 
+        hashmap_free(m->data_offsets);
         free(m->data);
         return mfree(m);
 }
 
+static void match_forget_file(Match *m, JournalFile *f) {
+        if (!m)
+                return;
+
+        /* The cached DATA object offsets are keyed by the JournalFile pointer, hence drop them before the
+         * file object is freed, so that a new file allocated at the same address won't pick them up. */
+
+        (void) hashmap_remove(m->data_offsets, f);
+
+        LIST_FOREACH(matches, i, m->matches)
+                match_forget_file(i, f);
+}
+
 static Match *match_free_if_empty(Match *m) {
         if (!m || m->matches)
                 return m;
@@ -665,6 +688,74 @@ static int compare_with_location(
         return 0;
 }
 
+#define MATCH_DATA_ABSENT ((void*) UINTPTR_MAX)
+
+static int match_find_data_object(
+                Match *m,
+                JournalFile *f,
+                Object **ret_object,
+                uint64_t *ret_offset) {
+
+        uint64_t hash, p;
+        void *v;
+        int r;
+
+        assert(m);
+        assert(m->type == MATCH_DISCRETE);
+        assert(f);
+        assert(f->header);
+
+        /* Resolving a match to its DATA object means hashing the payload and walking the hash chain, which
+         * possibly involves decompressing every candidate on the way. As this is done on every single
+         * iteration step, memoize the result per file. DATA objects never move once they are written, hence
+         * positive results may be cached for any file. Negative results are only cached for archived files,
+         * as online files may still gain the object later on. */
+
+        v = hashmap_get(m->data_offsets, f);
+        if (v == MATCH_DATA_ABSENT)
+                return 0;
+        if (v) {
+                p = PTR_TO_UINT64(v);
+
+                if (ret_object) {
+                        r = journal_file_move_to_object(f, OBJECT_DATA, p, ret_object);
+                        if (r < 0)
+                                return r;
+                }
+
+                if (ret_offset)
+                        *ret_offset = p;
+
+                return 1;
+        }
+
+        /* If the keyed hash logic is used, we need to calculate the hash fresh per file. Otherwise we can
+         * use what we pre-calculated. */
+        if (JOURNAL_HEADER_KEYED_HASH(f->header))
+                hash = journal_file_hash_data(f, m->data, m->size);
+        else
+                hash = m->hash;
+
+        r = journal_file_find_data_object_with_hash(f, m->data, m->size, hash, ret_object, &p);
+        if (r < 0)
+                return r;
+        if (r == 0) {
+                if (f->header->state == STATE_ARCHIVED)
+                        (void) hashmap_ensure_put(&m->data_offsets, NULL, f, MATCH_DATA_ABSENT);
+
+                return 0;
+        }
+
+        /* Offsets beyond what fits into a pointer (i.e. on 32-bit archs) are simply not cached. */
+        if ((uint64_t) (uintptr_t) p == p)
+                (void) hashmap_ensure_put(&m->data_offsets, NULL, f, UINT64_TO_PTR(p));
+
+        if (ret_offset)
+                *ret_offset = p;
+
+        return 1;
+}
+
 static int next_for_match(
                 sd_journal *j,
                 Match *m,
@@ -683,16 +774,8 @@ static int next_for_match(
 
         if (m->type == MATCH_DISCRETE) {
                 Object *d;
-                uint64_t hash;
-
-                /* If the keyed hash logic is used, we need to calculate the hash fresh per file. Otherwise
-                 * we can use what we pre-calculated. */
-                if (JOURNAL_HEADER_KEYED_HASH(f->header))
-                        hash = journal_file_hash_data(f, m->data, m->size);
-                else
-                        hash = m->hash;
 
-                r = journal_file_find_data_object_with_hash(f, m->data, m->size, hash, &d, NULL);
+                r = match_find_data_object(m, f, &d, NULL);
                 if (r <= 0)
                         return r;
 
@@ -828,14 +911,9 @@ static int find_location_for_match(
 
         if (m->type == MATCH_DISCRETE) {
                 Object *d;
-                uint64_t dp, hash;
-
-                if (JOURNAL_HEADER_KEYED_HASH(f->header))
-                        hash = journal_file_hash_data(f, m->data, m->size);
-                else
-                        hash = m->hash;
+                uint64_t dp;
 
-                r = journal_file_find_data_object_with_hash(f, m->data, m->size, hash, &d, &dp);
+                r = match_find_data_object(m, f, &d, &dp);
                 if (r <= 0)
                         return r;
 
@@ -935,6 +1013,16 @@ static int find_location_with_matches(
         assert(j);
         assert(f);
 
+        /* When seeking by wallclock time only, files without any entries beyond the seek position can be
+         * skipped by looking at their header, without touching their hash tables or entry arrays. This
+         * makes time-bounded queries cheap even if there are many archived files. */
+        if (j->current_location.type == LOCATION_SEEK &&
+            j->current_location.realtime_set &&
+            !j->current_location.monotonic_set &&
+            !(j->current_location.seqnum_set && sd_id128_equal(j->current_location.seqnum_id, f->header->seqnum_id)) &&
+            !journal_file_realtime_in_range(f, j->current_location.realtime, direction))
+                return 0;
+
         if (j->level0)
                 return find_location_for_match(j, j->level0, f, direction, ret, ret_offset);
 
@@ -1123,20 +1211,114 @@ static int compare_locations(sd_journal *j, JournalFile *af, JournalFile *bf) {
         return CMP(af->current_xor_hash, bf->current_xor_hash);
 }
 
+static bool merge_heap_less(sd_journal *j, direction_t direction, JournalFile *a, JournalFile *b) {
+        int r;
+
+        r = compare_locations(j, a, b);
+        return direction == DIRECTION_DOWN ? r < 0 : r > 0;
+}
+
+static void merge_heap_sift_down(sd_journal *j, direction_t direction, size_t i) {
+        assert(j);
+
+        for (;;) {
+                size_t k = i, l = 2 * i + 1, r = 2 * i + 2;
+
+                if (l < j->n_merge_heap && merge_heap_less(j, direction, j->merge_heap[l], j->merge_heap[k]))
+                        k = l;
+                if (r < j->n_merge_heap && merge_heap_less(j, direction, j->merge_heap[r], j->merge_heap[k]))
+                        k = r;
+                if (k == i)
+                        return;
+
+                SWAP_TWO(j->merge_heap[i], j->merge_heap[k]);
+                i = k;
+        }
+}
+
+static int merge_heap_next(sd_journal *j, direction_t direction, JournalFile **ret) {
+        int r;
+
+        assert(j);
+        assert(ret);
+
+        /* All files in the heap already have a candidate entry beyond the current location, except for the
+         * one we picked last time, which sits at the top. Keep advancing the top until it holds a candidate
+         * which did not move, which then is the next entry to return. */
+
+        while (j->n_merge_heap > 0) {
+                JournalFile *f = j->merge_heap[0];
+                LocationType t = f->location_type;
+                uint64_t p = f->current_offset;
+
+                r = next_beyond_location(j, f, direction);
+                if (r < 0) {
+                        *ret = f;
+                        return r;
+                }
+                if (r == 0) {
+                        f->location_type = direction == DIRECTION_DOWN ? LOCATION_TAIL : LOCATION_HEAD;
+                        j->merge_heap[0] = j->merge_heap[--j->n_merge_heap];
+                        merge_heap_sift_down(j, direction, 0);
+                        continue;
+                }
+
+                if (t == LOCATION_SEEK && f->current_offset == p) {
+                        *ret = f;
+                        return 1;
+                }
+
+                merge_heap_sift_down(j, direction, 0);
+        }
+
+        *ret = NULL;
+        return 0;
+}
+
 static int real_journal_next(sd_journal *j, direction_t direction) {
         JournalFile *new_file = NULL;
         unsigned n_files;
         const void **files;
+        bool build_heap;
         Object *o;
         int r;
 
         assert_return(j, -EINVAL);
         assert_return(!journal_origin_changed(j), -ECHILD);
 
+        /* If the files are immutable, then the relative order of the candidate entries of all files other
+         * than the one we picked last never changes, hence we keep them in a heap and only need to move the
+         * file we picked last, instead of comparing the candidates of all files with each other for every
+         * single step. */
+        if (FLAGS_SET(j->flags, SD_JOURNAL_ASSUME_IMMUTABLE) &&
+            j->merge_heap_valid &&
+            j->merge_direction == direction &&
+            j->merge_invalidate_counter == j->current_invalidate_counter) {
+
+                r = merge_heap_next(j, direction, &new_file);
+                if (r > 0)
+                        goto found;
+                if (r == 0)
+                        return 0;
+
+                log_debug_errno(r, "Can't iterate through %s, ignoring: %m", new_file->path);
+                remove_file_real(j, new_file);
+                new_file = NULL;
+        }
+
+        j->merge_heap_valid = false;
+        j->n_merge_heap = 0;
+
         r = iterated_cache_get(j->files_cache, NULL, &files, &n_files);
         if (r < 0)
                 return r;
 
+        /* Right after a seek, files without an entry at the sought location are looked at again on the
+         * next step (see next_beyond_location()), hence build the heap only after that. */
+        build_heap = FLAGS_SET(j->flags, SD_JOURNAL_ASSUME_IMMUTABLE) &&
+                j->current_location.type != LOCATION_SEEK &&
+                GREEDY_REALLOC(j->merge_heap, n_files);
+
         FOREACH_ARRAY(_f, files, n_files) {
                 JournalFile *f = (JournalFile*) *_f;
                 bool found;
@@ -1151,6 +1333,9 @@ static int real_journal_next(sd_journal *j, direction_t direction) {
                         continue;
                 }
 
+                if (build_heap)
+                        j->merge_heap[j->n_merge_heap++] = f;
+
                 if (!new_file)
                         found = true;
                 else {
@@ -1165,6 +1350,23 @@ static int real_journal_next(sd_journal *j, direction_t direction) {
         if (!new_file)
                 return 0;
 
+        if (build_heap) {
+                /* Put the file we picked at the top, and establish the heap property for the rest. */
+                for (size_t i = 0; i < j->n_merge_heap; i++)
+                        if (j->merge_heap[i] == new_file) {
+                                SWAP_TWO(j->merge_heap[0], j->merge_heap[i]);
+                                break;
+                        }
+
+                for (size_t i = j->n_merge_heap / 2; i > 1; i--)
+                        merge_heap_sift_down(j, direction, i - 1);
+
+                j->merge_heap_valid = true;
+                j->merge_direction = direction;
+                j->merge_invalidate_counter = j->current_invalidate_counter;
+        }
+
+found:
         r = journal_file_move_to_object(new_file, OBJECT_ENTRY, new_file->current_offset, &o);
         if (r < 0)
                 return r;
@@ -1796,6 +1998,7 @@ static void remove_file_real(sd_journal *j, JournalFile *f) {
         }
 
         journal_file_unlink_newest_by_boot_id(j, f);
+        match_forget_file(j->level0, f);
         (void) journal_file_close(f);
 
         j->current_invalidate_counter++;
@@ -2548,6 +2751,7 @@ _public_ void sd_journal_close(sd_journal *j) {
 
         ordered_hashmap_free_with_destructor(j->files, journal_file_close);
         iterated_cache_free(j->files_cache);
+        free(j->merge_heap);
 
         hashmap_free(j->directories_by_path);
         hashmap_free(j->directories_by_wd);
@@ -2568,6 +2772,7 @@ _public_ void sd_journal_close(sd_journal *j) {
         free(j->prefix);
         free(j->namespace);
         free(j->unique_field);
+        set_free(j->unique_values);
         free(j->fields_buffer);
         free(j);
 }
@@ -3320,6 +3525,80 @@ _public_ int sd_journal_get_usage(sd_journal *j, uint64_t *ret) {
         return 0;
 }
 
+typedef struct UniqueValue {
+        size_t size;
+        uint8_t data[];
+} UniqueValue;
+
+static void unique_value_hash_func(const UniqueValue *v, struct siphash *state) {
+        siphash24_compress_typesafe(v->size, state);
+        siphash24_compress(v->data, v->size, state);
+}
+
+static int unique_value_compare_func(const UniqueValue *a, const UniqueValue *b) {
+        int r;
+
+        r = CMP(a->size, b->size);
+        if (r != 0)
+                return r;
+
+        return memcmp(a->data, b->data, a->size);
+}
+
+DEFINE_PRIVATE_HASH_OPS_WITH_KEY_DESTRUCTOR(
+        unique_value_hash_ops,
+        UniqueValue,
+        unique_value_hash_func,
+        unique_value_compare_func,
+        free);
+
+static void journal_reset_unique_values(sd_journal *j) {
+        assert(j);
+
+        j->unique_values = set_free(j->unique_values);
+        j->unique_values_size = 0;
+        j->unique_values_overflow = false;
+}
+
+static int journal_unique_value_seen(sd_journal *j, const void *data, size_t size) {
+        _cleanup_free_ UniqueValue *v = NULL;
+        int r;
+
+        assert(j);
+        assert(data || size == 0);
+
+        /* Returns > 0 if the value was returned before, 0 if it is new and got remembered, and -ENOBUFS if
+         * it is not known, but we gave up remembering values, and hence cannot tell. */
+
+        v = malloc(offsetof(UniqueValue, data) + size);
+        if (!v)
+                return -ENOMEM;
+
+        v->size = size;
+        memcpy_safe(v->data, data, size);
+
+        if (set_contains(j->unique_values, v))
+                return 1;
+
+        if (j->unique_values_overflow)
+                return -ENOBUFS;
+
+        if (set_size(j->unique_values) >= UNIQUE_VALUES_MAX ||
+            j->unique_values_size + size > UNIQUE_VALUES_BYTES_MAX) {
+                log_debug("Enumerated more unique values of field %s than we are willing to remember, "
+                          "looking up further values in previously traversed files.", j->unique_field);
+                j->unique_values_overflow = true;
+                return -ENOBUFS;
+        }
+
+        r = set_ensure_consume(&j->unique_values, &unique_value_hash_ops, TAKE_PTR(v));
+        if (r < 0)
+                return r;
+
+        j->unique_values_size += size;
+        return 0;
+}
+
 _public_ int sd_journal_query_unique(sd_journal *j, const char *field) {
         int r;
 
@@ -3336,6 +3615,7 @@ _public_ int sd_journal_query_unique(sd_journal *j, const char *field) {
         j->unique_file = NULL;
         j->unique_offset = 0;
         j->unique_file_lost = false;
+        journal_reset_unique_values(j);
 
         return 0;
 }
@@ -3424,8 +3704,22 @@ _public_ int sd_journal_enumerate_unique(
                                                j->unique_offset,
                                                j->unique_field);
 
-                /* OK, now let's see if we already returned this data object by checking if it exists in the
-                 * earlier traversed files. */
+                /* OK, now let's see if we already returned this data object. Every value we returned so far
+                 * is remembered, so as long as we didn't give up on that, this is all we need to check. */
+                r = journal_unique_value_seen(j, odata, ol);
+                if (r > 0)
+                        continue;
+                if (r == 0) {
+                        *ret_data = odata;
+                        *ret_size = ol;
+
+                        return 1;
+                }
+                if (r != -ENOBUFS)
+                        return r;
+
+                /* Too many values to remember them all, check if it exists in the earlier traversed files
+                 * instead. */
                 found = false;
                 ORDERED_HASHMAP_FOREACH(of, j->files) {
                         if (of == j->unique_file)
@@ -3481,6 +3775,7 @@ _public_ void sd_journal_restart_unique(sd_journal *j) {
         j->unique_file = NULL;
         j->unique_offset = 0;
         j->unique_file_lost = false;
+        journal_reset_unique_values(j);
 }
 
 _public_ int sd_journal_enumerate_fields(sd_journal *j, const char **field) {
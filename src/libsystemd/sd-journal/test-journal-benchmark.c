@@ -0,0 +1,245 @@
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "sd-journal.h"
+
+#include "alloc-util.h"
+#include "chattr-util.h"
+#include "iovec-util.h"
+#include "journal-file-util.h"
+#include "log.h"
+#include "mmap-cache.h"
+#include "random-util.h"
+#include "rm-rf.h"
+#include "stdio-util.h"
+#include "string-util.h"
+#include "tests.h"
+#include "time-util.h"
+#include "tmpfile-util.h"
+
+/* Journal write and read benchmarks on a synthetic but realistic workload: entries from many units with
+ * the usual mix of low, medium and high cardinality fields and a message size distribution with a long tail,
+ * so that some of the payload ends up compressed. See benchmark_run() for the output format. */
+
+#define N_UNITS 32U
+#define N_FIELDS 8U
+
+static usec_t arg_duration;
+static unsigned arg_entries;
+static sd_journal *j = NULL;
+
+static const char filler[] =
+        "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor incididunt ut labore "
+        "et dolore magna aliqua. Ut enim ad minim veniam, quis nostrud exercitation ullamco laboris nisi ut "
+        "aliquip ex ea commodo consequat. Duis aute irure dolor in reprehenderit in voluptate velit esse cillum "
+        "dolore eu fugiat nulla pariatur. Excepteur sint occaecat cupidatat non proident, sunt in culpa qui "
+        "officia deserunt mollit anim id est laborum. ";
+
+static size_t message_size(void) {
+        unsigned p = random_u64_range(100);
+
+        /* Mostly short messages, some medium sized ones that cross the compression threshold, and a few
+         * large ones, e.g. backtraces or dumped configuration */
+        if (p < 70)
+                return 40 + random_u64_range(80);
+        if (p < 95)
+                return 200 + random_u64_range(800);
+        return 2000 + random_u64_range(6000);
+}
+
+static unsigned message_priority(void) {
+        unsigned p = random_u64_range(100);
+
+        if (p < 1)
+                return 3;
+        if (p < 5)
+                return 4;
+        if (p < 15)
+                return 5;
+        if (p < 90)
+                return 6;
+        return 7;
+}
+
+static char* make_message(unsigned unit, unsigned i) {
+        _cleanup_free_ char *m = NULL;
+        size_t n;
+
+        if (asprintf(&m, "MESSAGE=unit-%u: request %u completed: ", unit, i) < 0)
+                return NULL;
+
+        n = message_size();
+        while (strlen(m) < n)
+                if (!strextend(&m, filler))
+                        return NULL;
+
+        m[n] = 0;
+        return TAKE_PTR(m);
+}
+
+static uint64_t append_entries(JournalFile *f) {
+        uint64_t payload = 0;
+
+        for (unsigned i = 0; i < arg_entries; i++) {
+                char *fields[N_FIELDS] = {};
+                struct iovec iovec[N_FIELDS];
+                unsigned unit = random_u64_range(N_UNITS);
+                dual_timestamp ts;
+
+                assert_se(fields[0] = make_message(unit, i));
+                assert_se(asprintf(&fields[1], "PRIORITY=%u", message_priority()) >= 0);
+                assert_se(asprintf(&fields[2], "SYSLOG_IDENTIFIER=unit-%u", unit) >= 0);
+                assert_se(asprintf(&fields[3], "_SYSTEMD_UNIT=unit-%u.service", unit) >= 0);
+                assert_se(asprintf(&fields[4], "_PID=%u", 1000 + unit * 16 + (unsigned) random_u64_range(16)) >= 0);
+                assert_se(fields[5] = strdup(unit % 4 == 0 ? "_TRANSPORT=journal" : "_TRANSPORT=stdout"));
+                assert_se(fields[6] = strdup("_HOSTNAME=benchmark"));
+                assert_se(asprintf(&fields[7], "CODE_LINE=%u", (unsigned) random_u64_range(10000)) >= 0);
+
+                for (unsigned k = 0; k < N_FIELDS; k++) {
+                        iovec[k] = IOVEC_MAKE_STRING(fields[k]);
+                        payload += iovec[k].iov_len;
+                }
+
+                assert_se(dual_timestamp_now(&ts));
+                assert_se(journal_file_append_entry(f, &ts, NULL, iovec, N_FIELDS, NULL, NULL, NULL, NULL) >= 0);
+
+                free_many_charp(fields, N_FIELDS);
+        }
+
+        return payload;
+}
+
+static uint64_t read_all(unsigned batch, void *userdata) {
+        unsigned n = 0;
+
+        sd_journal_flush_matches(j);
+        assert_se(sd_journal_seek_head(j) >= 0);
+        while (sd_journal_next(j) > 0) {
+                const void *d;
+                size_t l;
+
+                assert_se(sd_journal_get_data(j, "MESSAGE", &d, &l) >= 0);
+                n++;
+        }
+
+        assert_se(n == arg_entries);
+        return n; /* one operation per entry read */
+}
+
+static unsigned count_forward(void) {
+        unsigned n = 0;
+
+        assert_se(sd_journal_seek_head(j) >= 0);
+        while (sd_journal_next(j) > 0)
+                n++;
+
+        return n;
+}
+
+static unsigned count_backward(unsigned max) {
+        unsigned n = 0;
+
+        assert_se(sd_journal_seek_tail(j) >= 0);
+        while (n < max && sd_journal_previous(j) > 0)
+                n++;
+
+        return n;
+}
+
+static uint64_t match_unit(unsigned batch, void *userdata) {
+        /* journalctl -u unit-7.service */
+        sd_journal_flush_matches(j);
+        assert_se(sd_journal_add_match(j, "_SYSTEMD_UNIT=unit-7.service", SIZE_MAX) >= 0);
+
+        (void) count_forward();
+        return 1; /* one operation per query */
+}
+
+static uint64_t match_unit_priority(unsigned batch, void *userdata) {
+        /* journalctl -u unit-7.service -p err */
+        sd_journal_flush_matches(j);
+        assert_se(sd_journal_add_match(j, "_SYSTEMD_UNIT=unit-7.service", SIZE_MAX) >= 0);
+        for (unsigned p = 0; p <= 3; p++) {
+                char s[STRLEN("PRIORITY=") + DECIMAL_STR_MAX(unsigned)];
+
+                xsprintf(s, "PRIORITY=%u", p);
+                assert_se(sd_journal_add_match(j, s, SIZE_MAX) >= 0);
+        }
+
+        (void) count_forward();
+        return 1;
+}
+
+static uint64_t tail(unsigned batch, void *userdata) {
+        /* journalctl -n 10 */
+        sd_journal_flush_matches(j);
+
+        assert_se(count_backward(10) == 10);
+        return 1;
+}
+
+static uint64_t match_unit_tail(unsigned batch, void *userdata) {
+        /* journalctl -u unit-7.service -n 10 */
+        sd_journal_flush_matches(j);
+        assert_se(sd_journal_add_match(j, "_SYSTEMD_UNIT=unit-7.service", SIZE_MAX) >= 0);
+
+        (void) count_backward(10);
+        return 1;
+}
+
+int main(int argc, char *argv[]) {
+        _cleanup_(rm_rf_physical_and_freep) char *tmpdir = NULL;
+        _cleanup_(mmap_cache_unrefp) MMapCache *m = NULL;
+        JournalMetrics metrics;
+        JournalFile *f;
+        uint64_t payload, size;
+        usec_t start, t;
+
+        test_setup_logging(LOG_INFO);
+
+        arg_duration = benchmark_duration(argc, argv);
+
+        arg_entries = slow_tests_enabled() ? 200000 : 20000;
+
+        /* journal_file_open() requires a valid machine id */
+        if (sd_id128_get_machine(NULL) < 0)
+                return log_tests_skipped("No valid machine ID found");
+
+        assert_se(m = mmap_cache_new());
+
+        assert_se(mkdtemp_malloc("/var/tmp/journal-benchmark-XXXXXX", &tmpdir) >= 0);
+        assert_se(chdir(tmpdir) >= 0);
+        (void) chattr_path(tmpdir, FS_NOCOW_FL, FS_NOCOW_FL, NULL);
+
+        /* Use the metrics journald would pick for this file system, so that the hash tables are sized the
+         * same way as for real journal files */
+        journal_reset_metrics(&metrics);
+        assert_se(journal_file_open(-EBADF, "system.journal", O_RDWR|O_CREAT, JOURNAL_COMPRESS, 0644,
+                                    UINT64_MAX, &metrics, m, NULL, &f) == 0);
+
+        start = now(CLOCK_MONOTONIC);
+        payload = append_entries(f);
+        t = now(CLOCK_MONOTONIC) - start;
+
+        size = le64toh(f->header->header_size) + le64toh(f->header->arena_size);
+        log_info("benchmark journal-append %u %.1f", arg_entries, (double) t * NSEC_PER_USEC / arg_entries);
+        log_info("journal: %u entries, %" PRIu64 " bytes of payload, %" PRIu64 " bytes used in file, "
+                 "%.1f bytes/entry, payload/file ratio %.2f",
+                 arg_entries, payload, size, (double) size / arg_entries, (double) payload / size);
+
+        assert_se(journal_file_offline_close(f) == NULL);
+
+        assert_se(sd_journal_open_directory(&j, tmpdir, 0) >= 0);
+
+        benchmark_run("journal-read-all", arg_duration, read_all, NULL);
+        benchmark_run("journal-match-unit", arg_duration, match_unit, NULL);
+        benchmark_run("journal-match-unit-priority", arg_duration, match_unit_priority, NULL);
+        benchmark_run("journal-tail", arg_duration, tail, NULL);
+        benchmark_run("journal-match-unit-tail", arg_duration, match_unit_tail, NULL);
+
+        sd_journal_close(TAKE_PTR(j));
+
+        return 0;
+}
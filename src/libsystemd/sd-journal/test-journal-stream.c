@@ -62,7 +62,7 @@ static void run_test(void) {
         _cleanup_(mmap_cache_unrefp) MMapCache *m = NULL;
         JournalFile *one, *two, *three;
         char t[] = "/var/tmp/journal-stream-XXXXXX";
-        unsigned i;
+        unsigned i, n;
         _cleanup_(sd_journal_closep) sd_journal *j = NULL;
         char *z;
         const void *data;
@@ -169,8 +169,23 @@ static void run_test(void) {
         verify_contents(j, 0);
 
         assert_se(sd_journal_query_unique(j, "NUMBER") >= 0);
-        SD_JOURNAL_FOREACH_UNIQUE(j, data, l)
+        n = 0;
+        SD_JOURNAL_FOREACH_UNIQUE(j, data, l) {
                 printf("%.*s\n", (int) l, (const char*) data);
+                n++;
+        }
+        assert_se(n == N_ENTRIES);
+
+        /* MAGIC= values are spread over all three files, each must be returned exactly once */
+        assert_se(sd_journal_query_unique(j, "MAGIC") >= 0);
+        for (unsigned k = 0; k < 2; k++) {
+                n = 0;
+                SD_JOURNAL_FOREACH_UNIQUE(j, data, l) {
+                        printf("%.*s\n", (int) l, (const char*) data);
+                        n++;
+                }
+                assert_se(n == 2);
+        }
 
         assert_se(rm_rf(t, REMOVE_ROOT|REMOVE_PHYSICAL) >= 0);
 }
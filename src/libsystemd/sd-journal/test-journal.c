@@ -8,8 +8,10 @@
 #include "journal-authenticate.h"
 #include "journal-file-util.h"
 #include "journal-vacuum.h"
+#include "journal-verify.h"
 #include "log.h"
 #include "rm-rf.h"
+#include "stdio-util.h"
 #include "tests.h"
 
 static bool arg_keep = false;
@@ -53,6 +55,10 @@ static void test_non_empty_one(void) {
         iovec = IOVEC_MAKE_STRING(test);
         assert_se(journal_file_append_entry(f, &ts, &fake_boot_id, &iovec, 1, NULL, NULL, NULL, NULL) == 0);
 
+        /* The repeated payload was found in the cache of recently used DATA objects */
+        assert_se(f->n_data_cache_hit == 1);
+        assert_se(f->n_data_cache_miss == 2);
+
 #if HAVE_GCRYPT
         journal_file_append_tag(f);
 #endif
@@ -174,6 +180,218 @@ TEST(empty) {
         test_empty_one();
 }
 
+static void test_rewrite_one(void) {
+        _cleanup_(mmap_cache_unrefp) MMapCache *m = NULL;
+        JournalFile *f, *c, *x;
+        dual_timestamp ts;
+        struct iovec iovec[2];
+        Object *o, *d;
+        uint64_t p = 0, q = 0, seqnum = 0;
+        char t[] = "/var/tmp/journal-XXXXXX";
+        char a[32], b[32];
+
+        m = mmap_cache_new();
+        assert_se(m != NULL);
+
+        mkdtemp_chdir_chattr(t);
+
+        assert_se(journal_file_open(-EBADF, "test.journal", O_RDWR|O_CREAT, JOURNAL_COMPRESS, 0666, UINT64_MAX, NULL, m, NULL, &f) == 0);
+
+        assert_se(dual_timestamp_now(&ts));
+
+        /* Leave a gap in the sequence numbers, to check that they are retained */
+        for (unsigned i = 0; i < 100; i++) {
+                xsprintf(a, "A=%u", i % 7);
+                xsprintf(b, "B=%u", i);
+                iovec[0] = IOVEC_MAKE_STRING(a);
+                iovec[1] = IOVEC_MAKE_STRING(b);
+
+                if (i == 50)
+                        seqnum = 1000;
+
+                assert_se(journal_file_append_entry(f, &ts, NULL, iovec, 2, &seqnum, NULL, NULL, NULL) == 0);
+        }
+
+        /* Pretend the file was written on another host, the copy has to retain that */
+        assert_se(sd_id128_randomize(&f->header->machine_id) >= 0);
+        f->archive = true;
+        (void) journal_file_offline_close(f);
+
+        assert_se(journal_file_open(-EBADF, "test.journal", O_RDONLY, 0, 0666, UINT64_MAX, NULL, m, NULL, &f) == 0);
+        assert_se(f->header->state == STATE_ARCHIVED);
+
+        assert_se(journal_file_rewrite(f, "copy.journal", m, &c) == 0);
+        assert_se(sd_id128_equal(c->header->seqnum_id, f->header->seqnum_id));
+        assert_se(sd_id128_equal(c->header->machine_id, f->header->machine_id));
+        assert_se(le64toh(c->header->n_entries) == 100);
+        assert_se(le64toh(c->header->n_data) == le64toh(f->header->n_data));
+        assert_se(le64toh(c->header->head_entry_seqnum) == 1);
+        assert_se(le64toh(c->header->tail_entry_seqnum) == 1050);
+
+        for (unsigned i = 0; i < 100; i++) {
+                uint64_t x;
+
+                assert_se(journal_file_next_entry(f, p, DIRECTION_DOWN, &o, &p) == 1);
+                x = le64toh(o->entry.seqnum);
+                assert_se(journal_file_next_entry(c, q, DIRECTION_DOWN, &o, &q) == 1);
+                assert_se(le64toh(o->entry.seqnum) == x);
+                assert_se(le64toh(o->entry.realtime) == ts.realtime);
+        }
+        assert_se(journal_file_next_entry(c, q, DIRECTION_DOWN, &o, &q) == 0);
+
+        /* Data objects are shared between entries just like in the original file */
+        assert_se(journal_file_find_data_object(c, "A=3", STRLEN("A=3"), &d, NULL) == 1);
+        assert_se(le64toh(d->data.n_entries) == 14);
+
+        /* The target must not exist yet */
+        assert_se(journal_file_rewrite(f, "copy.journal", m, &x) == -EEXIST);
+
+        (void) journal_file_offline_close(c);
+        (void) journal_file_offline_close(f);
+
+        assert_se(journal_file_open(-EBADF, "copy.journal", O_RDONLY, 0, 0666, UINT64_MAX, NULL, m, NULL, &c) == 0);
+        assert_se(journal_file_verify(c, NULL, NULL, NULL, NULL, false) >= 0);
+        (void) journal_file_close(c);
+
+        if (arg_keep)
+                log_info("Not removing %s", t);
+        else
+                assert_se(rm_rf(t, REMOVE_ROOT|REMOVE_PHYSICAL) >= 0);
+}
+
+TEST(rewrite) {
+        assert_se(setenv("SYSTEMD_JOURNAL_COMPACT", "0", 1) >= 0);
+        test_rewrite_one();
+
+        assert_se(setenv("SYSTEMD_JOURNAL_COMPACT", "1", 1) >= 0);
+        test_rewrite_one();
+}
+
+static void test_data_bloom_filter_one(void) {
+        _cleanup_(mmap_cache_unrefp) MMapCache *m = NULL;
+        JournalFile *f;
+        dual_timestamp ts;
+        struct iovec iovec;
+        unsigned n_false_positives = 0;
+        char t[] = "/var/tmp/journal-XXXXXX";
+        char a[32];
+
+        m = mmap_cache_new();
+        assert_se(m != NULL);
+
+        mkdtemp_chdir_chattr(t);
+
+        assert_se(journal_file_open(-EBADF, "test.journal", O_RDWR|O_CREAT, JOURNAL_COMPRESS, 0666, UINT64_MAX, NULL, m, NULL, &f) == 0);
+
+        assert_se(dual_timestamp_now(&ts));
+
+        for (unsigned i = 0; i < 1000; i++) {
+                xsprintf(a, "A=%u", i);
+                iovec = IOVEC_MAKE_STRING(a);
+                assert_se(journal_file_append_entry(f, &ts, NULL, &iovec, 1, NULL, NULL, NULL, NULL) == 0);
+        }
+
+        /* The filter is added while offlining an archived file */
+        assert_se(!JOURNAL_HEADER_DATA_BLOOM_FILTER(f->header));
+        f->archive = true;
+        (void) journal_file_offline_close(f);
+
+        assert_se(journal_file_open(-EBADF, "test.journal", O_RDONLY, 0, 0666, UINT64_MAX, NULL, m, NULL, &f) == 0);
+        assert_se(f->header->state == STATE_ARCHIVED);
+        assert_se(JOURNAL_HEADER_DATA_BLOOM_FILTER(f->header));
+        assert_se(f->header->data_bloom_filter_offset != 0);
+
+        for (unsigned i = 0; i < 1000; i++) {
+                xsprintf(a, "A=%u", i);
+                assert_se(journal_file_data_maybe_present(f, journal_file_hash_data(f, a, strlen(a))));
+                assert_se(journal_file_find_data_object(f, a, strlen(a), NULL, NULL) == 1);
+        }
+
+        for (unsigned i = 1000; i < 11000; i++) {
+                xsprintf(a, "A=%u", i);
+                if (journal_file_data_maybe_present(f, journal_file_hash_data(f, a, strlen(a))))
+                        n_false_positives++;
+                assert_se(journal_file_find_data_object(f, a, strlen(a), NULL, NULL) == 0);
+        }
+
+        /* The filter is sized for a false positive rate of about 1% */
+        log_info("Bloom filter false positives: %u/10000", n_false_positives);
+        assert_se(n_false_positives < 500);
+
+        assert_se(journal_file_verify(f, NULL, NULL, NULL, NULL, false) >= 0);
+
+        (void) journal_file_close(f);
+
+        if (arg_keep)
+                log_info("Not removing %s", t);
+        else
+                assert_se(rm_rf(t, REMOVE_ROOT|REMOVE_PHYSICAL) >= 0);
+}
+
+TEST(data_bloom_filter) {
+        assert_se(setenv("SYSTEMD_JOURNAL_COMPACT", "0", 1) >= 0);
+        test_data_bloom_filter_one();
+
+        assert_se(setenv("SYSTEMD_JOURNAL_COMPACT", "1", 1) >= 0);
+        test_data_bloom_filter_one();
+}
+
+TEST(realtime_in_range) {
+        _cleanup_(mmap_cache_unrefp) MMapCache *m = NULL;
+        static const char test[] = "TEST1=1";
+        JournalFile *f;
+        dual_timestamp ts;
+        struct iovec iovec;
+        Object *o;
+        char t[] = "/var/tmp/journal-XXXXXX";
+
+        m = mmap_cache_new();
+        assert_se(m != NULL);
+
+        mkdtemp_chdir_chattr(t);
+
+        assert_se(journal_file_open(-EBADF, "test.journal", O_RDWR|O_CREAT, JOURNAL_COMPRESS, 0666, UINT64_MAX, NULL, m, NULL, &f) == 0);
+
+        /* No entries, nothing is in range */
+        assert_se(!journal_file_realtime_in_range(f, 1, DIRECTION_DOWN));
+        assert_se(!journal_file_realtime_in_range(f, 1, DIRECTION_UP));
+
+        iovec = IOVEC_MAKE_STRING(test);
+        for (usec_t i = 1; i <= 10; i++) {
+                ts = (dual_timestamp) {
+                        .realtime = i * USEC_PER_SEC,
+                        .monotonic = i * USEC_PER_SEC,
+                };
+                assert_se(journal_file_append_entry(f, &ts, NULL, &iovec, 1, NULL, NULL, NULL, NULL) == 0);
+        }
+
+        assert_se(journal_file_realtime_in_range(f, 5 * USEC_PER_SEC, DIRECTION_DOWN));
+        assert_se(journal_file_realtime_in_range(f, 5 * USEC_PER_SEC, DIRECTION_UP));
+        assert_se(journal_file_realtime_in_range(f, 10 * USEC_PER_SEC, DIRECTION_DOWN));
+        assert_se(!journal_file_realtime_in_range(f, 11 * USEC_PER_SEC, DIRECTION_DOWN));
+        assert_se(journal_file_realtime_in_range(f, 11 * USEC_PER_SEC, DIRECTION_UP));
+        assert_se(journal_file_realtime_in_range(f, 1 * USEC_PER_SEC, DIRECTION_UP));
+        assert_se(!journal_file_realtime_in_range(f, 1, DIRECTION_UP));
+
+        assert_se(journal_file_move_to_entry_by_realtime(f, 11 * USEC_PER_SEC, DIRECTION_DOWN, &o, NULL) == 0);
+        assert_se(journal_file_move_to_entry_by_realtime(f, 11 * USEC_PER_SEC, DIRECTION_UP, &o, NULL) == 1);
+        assert_se(le64toh(o->entry.realtime) == 10 * USEC_PER_SEC);
+        assert_se(journal_file_move_to_entry_by_realtime(f, 1, DIRECTION_DOWN, &o, NULL) == 1);
+        assert_se(le64toh(o->entry.realtime) == 1 * USEC_PER_SEC);
+        assert_se(journal_file_move_to_entry_by_realtime(f, 1, DIRECTION_UP, &o, NULL) == 0);
+
+        assert_se(!journal_file_seqnum_in_range(f, 11, DIRECTION_DOWN));
+        assert_se(journal_file_move_to_entry_by_seqnum(f, 11, DIRECTION_DOWN, &o, NULL) == 0);
+        assert_se(journal_file_move_to_entry_by_seqnum(f, 10, DIRECTION_DOWN, &o, NULL) == 1);
+
+        (void) journal_file_offline_close(f);
+
+        if (arg_keep)
+                log_info("Not removing %s", t);
+        else
+                assert_se(rm_rf(t, REMOVE_ROOT|REMOVE_PHYSICAL) >= 0);
+}
+
 #if HAVE_COMPRESSION
 static bool check_compressed(uint64_t compress_threshold, uint64_t data_size) {
         _cleanup_(mmap_cache_unrefp) MMapCache *m = NULL;
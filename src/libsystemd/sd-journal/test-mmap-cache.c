@@ -57,6 +57,23 @@ int main(int argc, char *argv[]) {
 
         assert_se((uint8_t*) p + 1 == (uint8_t*) q);
 
+        /* Walking upwards through the file should make the cache map larger windows ahead of the access. */
+        r = mmap_cache_fd_get(fx, 2, false, 64ULL*1024ULL*1024ULL, 2, NULL, &p);
+        assert_se(r >= 0);
+
+        r = mmap_cache_fd_get(fx, 2, false, 68ULL*1024ULL*1024ULL, 2, NULL, &p);
+        assert_se(r >= 0);
+
+        r = mmap_cache_fd_get(fx, 2, false, 72ULL*1024ULL*1024ULL, 2, NULL, &p);
+        assert_se(r >= 0);
+
+        r = mmap_cache_fd_get(fx, 2, false, 100ULL*1024ULL*1024ULL, 2, NULL, &q);
+        assert_se(r >= 0);
+
+        assert_se((uint8_t*) p + 28ULL*1024ULL*1024ULL == (uint8_t*) q);
+
+        mmap_cache_stats_log_debug(m);
+
         mmap_cache_fd_free(fx);
         mmap_cache_unref(m);
 
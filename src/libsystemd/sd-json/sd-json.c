@@ -1616,7 +1616,20 @@ static void json_format_string(FILE *f, const char *q, sd_json_format_flags_t fl
         if (flags & SD_JSON_FORMAT_COLOR)
                 fputs(ansi_green(), f);
 
-        for (; *q; q++)
+        for (;;) {
+                const char *e;
+
+                /* Write out runs of characters that need no escaping in one go, the per-character
+                 * fputc() calls (and the stdio locking they imply) are expensive for long strings. */
+                for (e = q; *e && !IN_SET(*e, '"', '\\') && !((signed char) *e >= 0 && *e < ' '); e++)
+                        ;
+                if (e > q)
+                        fwrite(q, 1, e - q, f);
+
+                q = e;
+                if (!*q)
+                        break;
+
                 switch (*q) {
                 case '"':
                         fputs("\\\"", f);
@@ -1647,13 +1660,13 @@ static void json_format_string(FILE *f, const char *q, sd_json_format_flags_t fl
                         break;
 
                 default:
-                        if ((signed char) *q >= 0 && *q < ' ')
-                                fprintf(f, "\\u%04x", (unsigned) *q);
-                        else
-                                fputc(*q, f);
+                        fprintf(f, "\\u%04x", (unsigned) *q);
                         break;
                 }
 
+                q++;
+        }
+
         if (flags & SD_JSON_FORMAT_COLOR)
                 fputs(ANSI_NORMAL, f);
 
@@ -2590,6 +2603,13 @@ static int unhex_ucs2(const char *c, uint16_t *ret) {
         return 0;
 }
 
+/* Characters that end a run of regular characters in a JSON string: the closing quote, the escape character,
+ * and all control characters (NUL is implied) */
+#define STRING_SPECIAL_CHARS                                                   \
+        "\"\\\x7f"                                                             \
+        "\x01\x02\x03\x04\x05\x06\x07\x08\x09\x0a\x0b\x0c\x0d\x0e\x0f"         \
+        "\x10\x11\x12\x13\x14\x15\x16\x17\x18\x19\x1a\x1b\x1c\x1d\x1e\x1f"
+
 static int json_parse_string(const char **p, char **ret) {
         _cleanup_free_ char *s = NULL;
         size_t n = 0;
@@ -2701,9 +2721,13 @@ static int json_parse_string(const char **p, char **ret) {
                         continue;
                 }
 
-                len = utf8_encoded_valid_unichar(c, SIZE_MAX);
-                if (len < 0)
-                        return len;
+                /* Copy the whole run of characters up to the next quote, backslash or control character in
+                 * one go, instead of character by character. */
+                len = strcspn(c, STRING_SPECIAL_CHARS);
+                assert(len > 0);
+
+                if (!utf8_is_valid_n(c, len))
+                        return -EINVAL;
 
                 if (!GREEDY_REALLOC(s, n + len + 1))
                         return -ENOMEM;
@@ -78,6 +78,7 @@ struct sd_netlink {
         Hashmap *rqueue_partial_by_serial;
 
         struct nlmsghdr *rbuffer;
+        unsigned n_overruns;
 
         bool processing:1;
 
@@ -126,6 +127,8 @@ struct sd_netlink_message {
         bool sealed:1;
 
         sd_netlink_message *next; /* next in a chain of multi-part messages */
+        sd_netlink_message *tail; /* last in the chain, only maintained for the head of a chain that is
+                                   * still being received */
 };
 
 int message_new_empty(sd_netlink *nl, sd_netlink_message **ret);
@@ -398,6 +398,8 @@ int socket_read_message(sd_netlink *nl) {
 
                                 /* finished reading multi-part message */
                                 existing = hashmap_remove(nl->rqueue_partial_by_serial, UINT32_TO_PTR(hdr->nlmsg_seq));
+                                if (existing)
+                                        existing->tail = NULL;
 
                                 /* if we receive only NLMSG_DONE, put it into the receive queue. */
                                 r = netlink_queue_received_message(nl, existing ?: m);
@@ -411,13 +413,15 @@ int socket_read_message(sd_netlink *nl) {
                                 existing = hashmap_get(nl->rqueue_partial_by_serial, UINT32_TO_PTR(hdr->nlmsg_seq));
                                 if (existing) {
                                         /* This is the continuation of the previously read messages.
-                                         * Let's append this message at the end. */
-                                        while (existing->next)
-                                                existing = existing->next;
-                                        existing->next = TAKE_PTR(m);
+                                         * Let's append this message at the end. Dumps may consist of
+                                         * a huge number of messages, hence do not walk the chain. */
+                                        assert(existing->tail);
+                                        existing->tail->next = m;
+                                        existing->tail = TAKE_PTR(m);
                                 } else {
                                         /* This is the first message. Put it into the queue for partially
                                          * received messages. */
+                                        m->tail = m;
                                         r = netlink_queue_partially_received_message(nl, m);
                                         if (r < 0)
                                                 return r;
@@ -20,6 +20,9 @@
 /* Some really high limit, to catch programming errors */
 #define REPLY_CALLBACKS_MAX UINT16_MAX
 
+/* When the receive buffer overruns, we double it, up to this size */
+#define RXBUF_GROW_MAX (128U*1024U*1024U)
+
 static int netlink_new(sd_netlink **ret) {
         _cleanup_(sd_netlink_unrefp) sd_netlink *nl = NULL;
 
@@ -169,6 +172,38 @@ int sd_netlink_send(
         return 1;
 }
 
+static void netlink_handle_overrun(sd_netlink *nl) {
+        size_t size;
+        int r, v;
+
+        assert(nl);
+
+        /* Broadcast messages got lost, as the kernel could not queue them. Unless the receive buffer is
+         * already large, enlarge it, so that the next burst of notifications is more likely to fit. */
+
+        nl->n_overruns++;
+
+        r = getsockopt_int(nl->fd, SOL_SOCKET, SO_RCVBUF, &v);
+        if (r < 0)
+                return (void) log_debug_errno(r, "sd-netlink: Got ENOBUFS from netlink socket (%u times), and failed to get receive buffer size, ignoring: %m",
+                                              nl->n_overruns);
+
+        /* The kernel reports twice the size that was set */
+        size = (size_t) v / 2;
+        if (size >= RXBUF_GROW_MAX)
+                return (void) log_debug("sd-netlink: Got ENOBUFS from netlink socket (%u times), ignoring.", nl->n_overruns);
+
+        size = MIN(size * 2, RXBUF_GROW_MAX);
+
+        r = fd_increase_rxbuf(nl->fd, size);
+        if (r < 0)
+                return (void) log_debug_errno(r, "sd-netlink: Got ENOBUFS from netlink socket (%u times), and failed to increase receive buffer size to %zu, ignoring: %m",
+                                              nl->n_overruns, size);
+
+        log_debug("sd-netlink: Got ENOBUFS from netlink socket (%u times), increased receive buffer size to %zu.",
+                  nl->n_overruns, size);
+}
+
 static int dispatch_rqueue(sd_netlink *nl, sd_netlink_message **ret) {
         sd_netlink_message *m;
         int r;
@@ -179,8 +214,8 @@ static int dispatch_rqueue(sd_netlink *nl, sd_netlink_message **ret) {
         if (ordered_set_isempty(nl->rqueue)) {
                 /* Try to read a new message */
                 r = socket_read_message(nl);
-                if (r == -ENOBUFS) /* FIXME: ignore buffer overruns for now */
-                        log_debug_errno(r, "sd-netlink: Got ENOBUFS from netlink socket, ignoring.");
+                if (r == -ENOBUFS) /* FIXME: the lost messages are not recovered for now */
+                        netlink_handle_overrun(nl);
                 else if (r < 0)
                         return r;
         }
@@ -39,6 +39,8 @@
 #define VARLINK_DEFAULT_TIMEOUT_USEC (45U*USEC_PER_SEC)
 #define VARLINK_BUFFER_MAX (16U*1024U*1024U)
 #define VARLINK_READ_SIZE (64U*1024U)
+#define VARLINK_INPUT_BUFFER_KEEP_MAX (4U*VARLINK_READ_SIZE)
+#define VARLINK_WRITE_BATCH_MAX VARLINK_READ_SIZE
 #define VARLINK_COLLECT_MAX 1024U
 
 static const char* const varlink_state_table[_VARLINK_STATE_MAX] = {
@@ -990,9 +992,14 @@ static int varlink_parse_message(sd_varlink *v) {
 
         v->input_buffer_size -= sz;
 
-        if (v->input_buffer_size == 0)
+        if (v->input_buffer_size == 0) {
                 v->input_buffer_index = 0;
-        else
+
+                /* The buffer got this large only when receiving a large message. Now that it has been parsed,
+                 * release the memory instead of pinning it for the rest of the connection's lifetime. */
+                if (MALLOC_SIZEOF_SAFE(v->input_buffer) > VARLINK_INPUT_BUFFER_KEEP_MAX)
+                        v->input_buffer = v->input_sensitive ? erase_and_free(v->input_buffer) : mfree(v->input_buffer);
+        } else
                 v->input_buffer_index += sz;
 
         v->input_buffer_unscanned = v->input_buffer_size;
@@ -1437,6 +1444,22 @@ fail:
         return r;
 }
 
+static bool varlink_write_can_wait(sd_varlink *v) {
+        assert(v);
+
+        /* Returns true if the client pipelined further requests, i.e. sent them without waiting for the
+         * replies to the previous ones, and they're already buffered on our side. In that case let's
+         * dispatch them first, and write out the replies together, rather than issuing one send() per
+         * reply. Don't do that if file descriptors are to be sent along, since those are tied to a specific
+         * message, and don't let the output buffer grow too much. */
+
+        return v->state == VARLINK_IDLE_SERVER &&
+                (v->current || v->input_buffer_unscanned > 0) &&
+                v->n_output_fds == 0 &&
+                !v->output_queue &&
+                v->output_buffer_size < VARLINK_WRITE_BATCH_MAX;
+}
+
 _public_ int sd_varlink_process(sd_varlink *v) {
         int r;
 
@@ -1447,11 +1470,13 @@ _public_ int sd_varlink_process(sd_varlink *v) {
 
         sd_varlink_ref(v);
 
-        r = varlink_write(v);
-        if (r < 0)
-                varlink_log_errno(v, r, "Write failed: %m");
-        if (r != 0)
-                goto finish;
+        if (!varlink_write_can_wait(v)) {
+                r = varlink_write(v);
+                if (r < 0)
+                        varlink_log_errno(v, r, "Write failed: %m");
+                if (r != 0)
+                        goto finish;
+        }
 
         r = varlink_dispatch_reply(v);
         if (r < 0)
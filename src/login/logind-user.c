@@ -135,6 +135,7 @@ User *user_free(User *u) {
 
         free(u->runtime_path);
         free(u->state_file);
+        free(u->state_file_contents);
 
         user_record_unref(u->user_record);
 
@@ -143,21 +144,19 @@ User *user_free(User *u) {
 
 static int user_save_internal(User *u) {
         _cleanup_(unlink_and_freep) char *temp_path = NULL;
+        _cleanup_free_ char *contents = NULL;
         _cleanup_fclose_ FILE *f = NULL;
+        size_t size = 0;
         int r;
 
         assert(u);
         assert(u->state_file);
 
-        r = mkdir_safe_label("/run/systemd/users", 0755, 0, 0, MKDIR_WARN_MODE);
-        if (r < 0)
+        f = open_memstream_unlocked(&contents, &size);
+        if (!f) {
+                r = -ENOMEM;
                 goto fail;
-
-        r = fopen_temporary(u->state_file, &f, &temp_path);
-        if (r < 0)
-                goto fail;
-
-        (void) fchmod(fileno(f), 0644);
+        }
 
         fprintf(f,
                 "# This is private data. Do not parse.\n"
@@ -280,6 +279,30 @@ static int user_save_internal(User *u) {
                 fputc('\n', f);
         }
 
+        r = fflush_and_check(f);
+        if (r < 0)
+                goto fail;
+
+        f = safe_fclose(f);
+
+        /* The file lists all sessions of the user and we are called whenever any of them changes, but often
+         * nothing listed here changed. Don't rewrite it in that case, so that sd-login clients watching the
+         * directory aren't woken up needlessly. */
+        if (streq_ptr(u->state_file_contents, contents))
+                return 0;
+
+        r = mkdir_safe_label("/run/systemd/users", 0755, 0, 0, MKDIR_WARN_MODE);
+        if (r < 0)
+                goto fail;
+
+        r = fopen_temporary(u->state_file, &f, &temp_path);
+        if (r < 0)
+                goto fail;
+
+        (void) fchmod(fileno(f), 0644);
+
+        fputs(contents, f);
+
         r = fflush_and_check(f);
         if (r < 0)
                 goto fail;
@@ -290,10 +313,12 @@ static int user_save_internal(User *u) {
         }
 
         temp_path = mfree(temp_path);
+        free_and_replace(u->state_file_contents, contents);
         return 0;
 
 fail:
         (void) unlink(u->state_file);
+        u->state_file_contents = mfree(u->state_file_contents);
 
         return log_error_errno(r, "Failed to save user data %s: %m", u->state_file);
 }
@@ -624,6 +649,7 @@ int user_finalize(User *u) {
                 RET_GATHER(r, clean_ipc_by_uid(u->user_record->uid));
 
         (void) unlink(u->state_file);
+        u->state_file_contents = mfree(u->state_file_contents);
         user_add_to_gc_queue(u);
 
         if (u->started) {
@@ -32,6 +32,7 @@ struct User {
         UserRecord *user_record;
 
         char *state_file;
+        char *state_file_contents; /* what we last wrote to state_file */
         char *runtime_path;
 
         /* user-UID.slice */
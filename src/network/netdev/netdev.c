@@ -934,7 +934,11 @@ static int netdev_request_to_create(NetDev *netdev) {
         if (r < 0)
                 return r;
         if (r > 0) {
-                /* If the netdev has no dependency, then create it now. */
+                /* If the netdev has no dependency, then create it now. The request is sent asynchronously,
+                 * so creation of all independent netdevs is pipelined on the rtnl socket: we do not wait
+                 * for the reply of one netdev before sending the next one. Netdevs that depend on others
+                 * (e.g. stacked ones, or those referring to another netdev) are queued below and only
+                 * sent once their dependencies are ready. */
                 r = independent_netdev_create(netdev);
                 if (r < 0)
                         return log_netdev_warning_errno(netdev, r, "Failed to create netdev: %m");
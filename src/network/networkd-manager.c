@@ -709,6 +709,7 @@ Manager* manager_free(Manager *m) {
         m->address_labels_by_section = hashmap_free(m->address_labels_by_section);
 
         sd_event_source_unref(m->speed_meter_event_source);
+        sd_event_source_unref(m->state_file_save_event_source);
         sd_event_unref(m->event);
 
         sd_device_monitor_unref(m->device_monitor);
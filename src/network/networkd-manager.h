@@ -57,6 +57,8 @@ struct Manager {
         Set *new_wlan_ifindices;
 
         char *state_file;
+        usec_t state_file_saved_usec;
+        sd_event_source *state_file_save_event_source;
         LinkOperationalState operational_state;
         LinkCarrierState carrier_state;
         LinkAddressState address_state;
@@ -8,6 +8,9 @@
 #include "string-table.h"
 
 #define REPLY_CALLBACK_COUNT_THRESHOLD 128
+/* Do not start scanning the queue while at least this many replies are pending, so that each scan submits a
+ * batch of requests rather than a single one. */
+#define REPLY_CALLBACK_COUNT_RESUME (REPLY_CALLBACK_COUNT_THRESHOLD / 2)
 
 static Request* request_detach_impl(Request *req) {
         assert(req);
@@ -268,6 +271,14 @@ int link_requeue_request(Link *link, Request *req, void *userdata, Request **ret
                         ret);
 }
 
+static bool manager_reply_callback_count_reached(Manager *manager, size_t n) {
+        assert(manager);
+
+        return netlink_get_reply_callback_count(manager->rtnl) >= n ||
+                netlink_get_reply_callback_count(manager->genl) >= n ||
+                fw_ctx_get_reply_callback_count(manager->fw_ctx) >= n;
+}
+
 int manager_process_requests(Manager *manager) {
         Request *req;
         int r;
@@ -278,6 +289,13 @@ int manager_process_requests(Manager *manager) {
         if (!ordered_set_isempty(manager->remove_request_queue))
                 return 0;
 
+        /* Requests that are waiting for a reply stay in the queue, and are skipped below. When many
+         * requests are queued, e.g. thousands of static routes, scanning the queue again each time a
+         * single reply comes in makes the cost grow with the number of requests in flight. Hence, let
+         * the replies drain a bit before starting another scan. */
+        if (manager_reply_callback_count_reached(manager, REPLY_CALLBACK_COUNT_RESUME))
+                return 0;
+
         manager->request_queued = false;
 
         ORDERED_SET_FOREACH(req, manager->request_queue) {
@@ -286,9 +304,7 @@ int manager_process_requests(Manager *manager) {
 
                 /* Typically, requests send netlink message asynchronously. If there are many requests
                  * queued, then this event may make reply callback queue in sd-netlink full. */
-                if (netlink_get_reply_callback_count(manager->rtnl) >= REPLY_CALLBACK_COUNT_THRESHOLD ||
-                    netlink_get_reply_callback_count(manager->genl) >= REPLY_CALLBACK_COUNT_THRESHOLD ||
-                    fw_ctx_get_reply_callback_count(manager->fw_ctx) >= REPLY_CALLBACK_COUNT_THRESHOLD)
+                if (manager_reply_callback_count_reached(manager, REPLY_CALLBACK_COUNT_THRESHOLD))
                         break;
 
                 /* Avoid the request and link freed by req->process() and request_detach(). */
@@ -7,6 +7,7 @@
 #include "dns-domain.h"
 #include "dns-resolver-internal.h"
 #include "escape.h"
+#include "event-util.h"
 #include "fd-util.h"
 #include "fileio.h"
 #include "fs-util.h"
@@ -23,6 +24,9 @@
 #include "strv.h"
 #include "tmpfile-util.h"
 
+/* Minimum interval between two updates of the manager state file from the event loop */
+#define MANAGER_SAVE_INTERVAL_USEC (100 * USEC_PER_MSEC)
+
 static int ordered_set_put_dns_servers(OrderedSet **s, int ifindex, struct in_addr_full **dns, unsigned n) {
         int r;
 
@@ -478,6 +482,7 @@ int manager_save(Manager *m) {
         }
 
         m->dirty = false;
+        m->state_file_saved_usec = now(CLOCK_MONOTONIC);
 
         return 0;
 }
@@ -991,13 +996,53 @@ int link_save_and_clean_full(Link *link, bool also_save_manager) {
         return k;
 }
 
+static int manager_save_handler(sd_event_source *s, uint64_t usec, void *userdata) {
+        Manager *manager = ASSERT_PTR(userdata);
+        int r;
+
+        if (!manager->dirty)
+                return 0;
+
+        r = manager_save(manager);
+        if (r < 0)
+                log_warning_errno(r, "Failed to update state file %s, ignoring: %m", manager->state_file);
+
+        return 0;
+}
+
+static int manager_save_throttled(Manager *manager) {
+        usec_t next;
+        int r;
+
+        assert(manager);
+
+        /* The manager state file summarizes all links, hence writing it costs time proportional to the
+         * number of links. When links are changing in quick succession, e.g. when thousands of interfaces
+         * are being created, do not rewrite it on every event loop iteration, but at most once per
+         * interval. */
+
+        next = usec_add(manager->state_file_saved_usec, MANAGER_SAVE_INTERVAL_USEC);
+        if (manager->state_file_saved_usec > 0 && now(CLOCK_MONOTONIC) < next) {
+                r = event_reset_time(manager->event, &manager->state_file_save_event_source,
+                                     CLOCK_MONOTONIC, next, 0,
+                                     manager_save_handler, manager,
+                                     0, "manager-save", /* force_reset = */ false);
+                if (r >= 0)
+                        return 0;
+
+                log_debug_errno(r, "Failed to schedule updating state file, updating it now: %m");
+        }
+
+        return manager_save(manager);
+}
+
 int manager_clean_all(Manager *manager) {
         int r, ret = 0;
 
         assert(manager);
 
         if (manager->dirty) {
-                r = manager_save(manager);
+                r = manager_save_throttled(manager);
                 if (r < 0)
                         log_warning_errno(r, "Failed to update state file %s, ignoring: %m", manager->state_file);
                 RET_GATHER(ret, r);
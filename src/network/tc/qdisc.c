@@ -444,6 +444,9 @@ static int qdisc_configure(QDisc *qdisc, Link *link, Request *req) {
 
         log_qdisc_debug(qdisc, link, "Configuring");
 
+        /* The message is sent with NLM_F_CREATE|NLM_F_REPLACE. Hence, when a qdisc with the same handle
+         * and kind already exists, the kernel changes its parameters in place, and its classes and child
+         * qdiscs are kept. We never delete and re-add qdiscs on reconfiguration. */
         r = sd_rtnl_message_new_traffic_control(link->manager->rtnl, &m, RTM_NEWQDISC,
                                                 link->ifindex, qdisc->handle, qdisc->parent);
         if (r < 0)
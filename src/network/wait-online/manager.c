@@ -52,6 +52,47 @@ static bool manager_ignore_link(Manager *m, Link *link) {
         return false;
 }
 
+static bool manager_link_needs_state(Manager *m, Link *link) {
+        assert(m);
+        assert(link);
+
+        /* Returns false if the state of the link can never affect whether we are online, based only on
+         * what we know from rtnl and the command line. Reading the state of a link means parsing its
+         * state file several times, hence on hosts with many interfaces we avoid doing so for links we
+         * do not care about. */
+
+        /* if interfaces are given on the command line, only those are checked, see manager_configured() */
+        if (!hashmap_isempty(m->command_line_interfaces_by_name))
+                return link_in_command_line_interfaces(link, m);
+
+        if (link->flags & IFF_LOOPBACK)
+                return false;
+
+        if (strv_fnmatch(m->ignored_interfaces, link->ifname))
+                return false;
+
+        STRV_FOREACH(n, link->altnames)
+                if (strv_fnmatch(m->ignored_interfaces, *n))
+                        return false;
+
+        return true;
+}
+
+static void manager_link_update_monitor(Manager *m, Link *l) {
+        int r;
+
+        assert(m);
+        assert(l);
+
+        if (!manager_link_needs_state(m, l))
+                return;
+
+        r = link_update_monitor(l);
+        if (r < 0)
+                log_link_full_errno(l, IN_SET(r, -ENODATA, -ENOENT) ? LOG_DEBUG : LOG_WARNING, r,
+                                    "Failed to update link state, ignoring: %m");
+}
+
 static const LinkOperationalStateRange* get_state_range(Manager *m, Link *l, const LinkOperationalStateRange *from_cmdline) {
         assert(m);
         assert(l);
@@ -258,11 +299,7 @@ static int manager_process_link(sd_netlink *rtnl, sd_netlink_message *mm, void *
                 if (r < 0)
                         log_link_warning_errno(l, r, "Failed to process RTNL link message, ignoring: %m");
 
-                r = link_update_monitor(l);
-                if (r < 0)
-                        log_link_full_errno(l, IN_SET(r, -ENODATA, -ENOENT) ? LOG_DEBUG : LOG_WARNING, r,
-                                            "Failed to update link state, ignoring: %m");
-
+                manager_link_update_monitor(m, l);
                 break;
 
         case RTM_DELLINK:
@@ -339,16 +376,11 @@ static int manager_rtnl_listen(Manager *m) {
 static int on_network_event(sd_event_source *s, int fd, uint32_t revents, void *userdata) {
         Manager *m = ASSERT_PTR(userdata);
         Link *l;
-        int r;
 
         sd_network_monitor_flush(m->network_monitor);
 
-        HASHMAP_FOREACH(l, m->links_by_index) {
-                r = link_update_monitor(l);
-                if (r < 0)
-                        log_link_full_errno(l, IN_SET(r, -ENODATA, -ENOENT) ? LOG_DEBUG : LOG_WARNING, r,
-                                            "Failed to update link state, ignoring: %m");
-        }
+        HASHMAP_FOREACH(l, m->links_by_index)
+                manager_link_update_monitor(m, l);
 
         if (manager_configured(m))
                 sd_event_exit(m->event, 0);
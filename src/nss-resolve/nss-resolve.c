@@ -70,6 +70,12 @@ static int connect_to_resolved(sd_varlink **ret) {
         _cleanup_(sd_varlink_unrefp) sd_varlink *link = NULL;
         int r;
 
+        /* Note that we deliberately open a new connection for each lookup, instead of keeping one around
+         * per thread: we are loaded into arbitrary processes, which might fork() (sharing the connection
+         * with the child), close all fds behind our back (after which the cached fd number might refer to
+         * something else entirely) or create and destroy threads in large numbers (leaking one connection
+         * each). Connecting to an AF_UNIX socket is cheap compared to the lookup itself. */
+
         r = sd_varlink_connect_address(&link, "/run/systemd/resolve/io.systemd.Resolve");
         if (r < 0)
                 return r;
@@ -145,11 +145,12 @@ bool oomd_swap_free_below(const OomdSystemContext *ctx, int threshold_permyriad)
         return (ctx->swap_total - ctx->swap_used) < swap_threshold;
 }
 
-int oomd_fetch_cgroup_oom_preference(OomdCGroupContext *ctx, const char *prefix) {
+static int oomd_fetch_cgroup_oom_preference_cached(OomdCGroupContext *ctx, const char *prefix, uid_t *prefix_uid) {
         uid_t uid;
         int r;
 
         assert(ctx);
+        assert(prefix_uid);
 
         prefix = empty_to_root(prefix);
 
@@ -162,13 +163,14 @@ int oomd_fetch_cgroup_oom_preference(OomdCGroupContext *ctx, const char *prefix)
                 return log_debug_errno(r, "Failed to get owner/group from %s: %m", ctx->path);
 
         if (uid != 0) {
-                uid_t prefix_uid;
-
-                r = cg_get_owner(prefix, &prefix_uid);
-                if (r < 0)
-                        return log_debug_errno(r, "Failed to get owner/group from %s: %m", prefix);
+                /* The owner of the prefix is the same for all candidates, only look it up once. */
+                if (!uid_is_valid(*prefix_uid)) {
+                        r = cg_get_owner(prefix, prefix_uid);
+                        if (r < 0)
+                                return log_debug_errno(r, "Failed to get owner/group from %s: %m", prefix);
+                }
 
-                if (uid != prefix_uid) {
+                if (uid != *prefix_uid) {
                         ctx->preference = MANAGED_OOM_PREFERENCE_NONE;
                         return 0;
                 }
@@ -193,8 +195,15 @@ int oomd_fetch_cgroup_oom_preference(OomdCGroupContext *ctx, const char *prefix)
         return 0;
 }
 
+int oomd_fetch_cgroup_oom_preference(OomdCGroupContext *ctx, const char *prefix) {
+        uid_t prefix_uid = UID_INVALID;
+
+        return oomd_fetch_cgroup_oom_preference_cached(ctx, prefix, &prefix_uid);
+}
+
 int oomd_sort_cgroup_contexts(Hashmap *h, oomd_compare_t compare_func, const char *prefix, OomdCGroupContext ***ret) {
         _cleanup_free_ OomdCGroupContext **sorted = NULL;
+        uid_t prefix_uid = UID_INVALID;
         OomdCGroupContext *item;
         size_t k = 0;
         int r;
@@ -212,7 +221,7 @@ int oomd_sort_cgroup_contexts(Hashmap *h, oomd_compare_t compare_func, const cha
                 if (item->path && prefix && !path_startswith(item->path, prefix))
                         continue;
 
-                r = oomd_fetch_cgroup_oom_preference(item, prefix);
+                r = oomd_fetch_cgroup_oom_preference_cached(item, prefix, &prefix_uid);
                 if (r == -ENOMEM)
                         return r;
 
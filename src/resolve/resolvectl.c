@@ -1199,12 +1199,14 @@ static int show_statistics(int argc, char **argv, void *userdata) {
                 uint64_t cache_size;
                 uint64_t n_cache_hit;
                 uint64_t n_cache_miss;
-        } cache;
+                uint64_t n_cache_prefetch;
+        } cache = {};
 
         static const sd_json_dispatch_field cache_dispatch_table[] = {
-                { "size",   _SD_JSON_VARIANT_TYPE_INVALID, sd_json_dispatch_uint64, offsetof(struct cache, cache_size),   SD_JSON_MANDATORY },
-                { "hits",   _SD_JSON_VARIANT_TYPE_INVALID, sd_json_dispatch_uint64, offsetof(struct cache, n_cache_hit),  SD_JSON_MANDATORY },
-                { "misses", _SD_JSON_VARIANT_TYPE_INVALID, sd_json_dispatch_uint64, offsetof(struct cache, n_cache_miss), SD_JSON_MANDATORY },
+                { "size",       _SD_JSON_VARIANT_TYPE_INVALID, sd_json_dispatch_uint64, offsetof(struct cache, cache_size),       SD_JSON_MANDATORY },
+                { "hits",       _SD_JSON_VARIANT_TYPE_INVALID, sd_json_dispatch_uint64, offsetof(struct cache, n_cache_hit),      SD_JSON_MANDATORY },
+                { "misses",     _SD_JSON_VARIANT_TYPE_INVALID, sd_json_dispatch_uint64, offsetof(struct cache, n_cache_miss),     SD_JSON_MANDATORY },
+                { "prefetches", _SD_JSON_VARIANT_TYPE_INVALID, sd_json_dispatch_uint64, offsetof(struct cache, n_cache_prefetch), 0                 },
                 {},
         };
 
@@ -1258,6 +1260,8 @@ static int show_statistics(int argc, char **argv, void *userdata) {
                            TABLE_UINT64, cache.n_cache_hit,
                            TABLE_FIELD, "Cache Misses",
                            TABLE_UINT64, cache.n_cache_miss,
+                           TABLE_FIELD, "Cache Prefetches",
+                           TABLE_UINT64, cache.n_cache_prefetch,
                            TABLE_EMPTY, TABLE_EMPTY,
                            TABLE_STRING, "Failure Transactions",
                            TABLE_SET_COLOR, ansi_highlight(),
@@ -3211,6 +3215,8 @@ static int dump_server_state(sd_json_variant *server) {
                 size_t received_udp_fragment_max;
                 uint64_t n_failed_udp;
                 uint64_t n_failed_tcp;
+                uint64_t rtt_usec;
+                uint64_t rtt_var_usec;
                 bool packet_truncated;
                 bool packet_bad_opt;
                 bool packet_rrsig_missing;
@@ -3234,6 +3240,8 @@ static int dump_server_state(sd_json_variant *server) {
                 { "ReceivedUDPFragmentMax", _SD_JSON_VARIANT_TYPE_INVALID, sd_json_dispatch_uint64,        offsetof(struct server_state, received_udp_fragment_max), SD_JSON_MANDATORY },
                 { "FailedUDPAttempts",      _SD_JSON_VARIANT_TYPE_INVALID, sd_json_dispatch_uint64,        offsetof(struct server_state, n_failed_udp),              SD_JSON_MANDATORY },
                 { "FailedTCPAttempts",      _SD_JSON_VARIANT_TYPE_INVALID, sd_json_dispatch_uint64,        offsetof(struct server_state, n_failed_tcp),              SD_JSON_MANDATORY },
+                { "RTTUSec",                _SD_JSON_VARIANT_TYPE_INVALID, sd_json_dispatch_uint64,        offsetof(struct server_state, rtt_usec),                  0                 },
+                { "RTTVarianceUSec",        _SD_JSON_VARIANT_TYPE_INVALID, sd_json_dispatch_uint64,        offsetof(struct server_state, rtt_var_usec),              0                 },
                 { "PacketTruncated",        SD_JSON_VARIANT_BOOLEAN,       sd_json_dispatch_stdbool,       offsetof(struct server_state, packet_truncated),          SD_JSON_MANDATORY },
                 { "PacketBadOpt",           SD_JSON_VARIANT_BOOLEAN,       sd_json_dispatch_stdbool,       offsetof(struct server_state, packet_bad_opt),            SD_JSON_MANDATORY },
                 { "PacketRRSIGMissing",     SD_JSON_VARIANT_BOOLEAN,       sd_json_dispatch_stdbool,       offsetof(struct server_state, packet_rrsig_missing),      SD_JSON_MANDATORY },
@@ -3298,6 +3306,16 @@ static int dump_server_state(sd_json_variant *server) {
                         return table_log_add_error(r);
         }
 
+        if (server_state.rtt_usec > 0) {
+                r = table_add_many(table,
+                                   TABLE_FIELD, "Round-trip time",
+                                   TABLE_TIMESPAN, server_state.rtt_usec,
+                                   TABLE_FIELD, "Round-trip time variance",
+                                   TABLE_TIMESPAN, server_state.rtt_var_usec);
+                if (r < 0)
+                        return table_log_add_error(r);
+        }
+
         r = table_add_many(table,
                            TABLE_FIELD, "DNSSEC Mode",
                            TABLE_STRING, server_state.dnssec_mode,
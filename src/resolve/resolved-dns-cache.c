@@ -25,6 +25,10 @@
  * now) */
 #define CACHE_TTL_STRANGE_RCODE_USEC (10 * USEC_PER_SEC)
 
+/* Positive entries that were used at least this often are refreshed in the background once they enter the
+ * last tenth of their TTL, if CachePrefetch= is enabled. */
+#define CACHE_PREFETCH_MIN_HITS 2U
+
 #define CACHEABLE_QUERY_FLAGS (SD_RESOLVED_AUTHENTICATED|SD_RESOLVED_CONFIDENTIAL)
 
 typedef enum DnsCacheItemType DnsCacheItemType;
@@ -47,6 +51,8 @@ struct DnsCacheItem {
 
         usec_t until;            /* If StaleRetentionSec is greater than zero, until is set to a duration of StaleRetentionSec from the time of TTL expiry. If StaleRetentionSec is zero, both until and until_valid will be set to ttl. */
         usec_t until_valid;      /* The key is for storing the time when the TTL set to expire. */
+        usec_t prefetch_after;   /* From this time on a refresh may be started in the background, see CachePrefetch= */
+        unsigned n_hit;          /* How often this item was used to answer a lookup since it was last updated */
         uint64_t query_flags;    /* SD_RESOLVED_AUTHENTICATED and/or SD_RESOLVED_CONFIDENTIAL */
         DnssecResult dnssec_result;
 
@@ -54,6 +60,8 @@ struct DnsCacheItem {
         int owner_family;
         union in_addr_union owner_address;
 
+        size_t size;             /* The memory charged to the cache for this item, see dns_cache_item_size() */
+
         unsigned prioq_idx;
         LIST_FIELDS(DnsCacheItem, by_key);
 
@@ -99,6 +107,23 @@ static DnsCacheItem* dns_cache_item_free(DnsCacheItem *i) {
 }
 DEFINE_TRIVIAL_CLEANUP_FUNC(DnsCacheItem*, dns_cache_item_free);
 
+static size_t dns_cache_item_size(const DnsCacheItem *i) {
+        size_t n = sizeof(DnsCacheItem);
+
+        assert(i);
+
+        /* An estimate of the memory used by the item. The full packet dominates for DNSSEC and EDE answers.
+         * Packets and answers may be shared between the items of an RRset, in which case they are charged
+         * to each of them, so that this errs on the side of overestimating. */
+
+        if (i->rr)
+                n += sizeof(DnsResourceRecord) + i->rr->wire_format_size;
+        if (i->full_packet)
+                n += i->full_packet->allocated;
+
+        return n;
+}
+
 static void dns_cache_item_unlink_and_free(DnsCache *c, DnsCacheItem *i) {
         DnsCacheItem *first;
 
@@ -117,6 +142,7 @@ static void dns_cache_item_unlink_and_free(DnsCache *c, DnsCacheItem *i) {
 
         prioq_remove(c->by_expiry, i, &i->prioq_idx);
 
+        c->n_bytes -= i->size;
         dns_cache_item_free(i);
 }
 
@@ -150,6 +176,7 @@ static bool dns_cache_remove_by_key(DnsCache *c, DnsResourceKey *key) {
 
         LIST_FOREACH(by_key, i, first) {
                 prioq_remove(c->by_expiry, i, &i->prioq_idx);
+                c->n_bytes -= i->size;
                 dns_cache_item_free(i);
         }
 
@@ -166,6 +193,7 @@ void dns_cache_flush(DnsCache *c) {
 
         assert(hashmap_isempty(c->by_key));
         assert(prioq_isempty(c->by_expiry));
+        assert(c->n_bytes == 0);
 
         c->by_key = hashmap_free(c->by_key);
         c->by_expiry = prioq_free(c->by_expiry);
@@ -180,7 +208,10 @@ static void dns_cache_make_space(DnsCache *c, unsigned add) {
         /* Makes space for n new entries. Note that we actually allow
          * the cache to grow beyond CACHE_MAX, but only when we shall
          * add more RRs to the cache than CACHE_MAX at once. In that
-         * case the cache will be emptied completely otherwise. */
+         * case the cache will be emptied completely otherwise. If a
+         * memory budget is configured (CacheSizeMax=), also evict the
+         * entries closest to expiry until we are below it. The new
+         * entries may then exceed the budget by their own size. */
 
         for (;;) {
                 _cleanup_(dns_resource_key_unrefp) DnsResourceKey *key = NULL;
@@ -189,7 +220,8 @@ static void dns_cache_make_space(DnsCache *c, unsigned add) {
                 if (prioq_isempty(c->by_expiry))
                         break;
 
-                if (prioq_size(c->by_expiry) + add < CACHE_MAX)
+                if (prioq_size(c->by_expiry) + add < CACHE_MAX &&
+                    (c->max_bytes == 0 || c->n_bytes < c->max_bytes))
                         break;
 
                 i = prioq_peek(c->by_expiry);
@@ -317,6 +349,9 @@ static int dns_cache_link_item(DnsCache *c, DnsCacheItem *i) {
                 }
         }
 
+        i->size = dns_cache_item_size(i);
+        c->n_bytes += i->size;
+
         return 0;
 }
 
@@ -377,6 +412,11 @@ static usec_t calculate_until(
         return stale_retention_usec > 0 ? usec_add(until_valid, stale_retention_usec) : until_valid;
 }
 
+static usec_t calculate_prefetch_after(usec_t until_valid, usec_t timestamp) {
+        /* Enter the prefetch window when 90% of the TTL has passed. */
+        return until_valid - LESS_BY(until_valid, timestamp) / 10;
+}
+
 static void dns_cache_item_update_positive(
                 DnsCache *c,
                 DnsCacheItem *i,
@@ -414,8 +454,14 @@ static void dns_cache_item_update_positive(
 
         DNS_PACKET_REPLACE(i->full_packet, dns_packet_ref(full_packet));
 
+        c->n_bytes -= i->size;
+        i->size = dns_cache_item_size(i);
+        c->n_bytes += i->size;
+
         i->until_valid = calculate_until_valid(rr, min_ttl, UINT32_MAX, timestamp, false);
         i->until = calculate_until(i->until_valid, stale_retention_usec);
+        i->prefetch_after = calculate_prefetch_after(i->until_valid, timestamp);
+        i->n_hit = 0;
         i->query_flags = query_flags & CACHEABLE_QUERY_FLAGS;
         i->shared_owner = shared_owner;
         i->dnssec_result = dnssec_result;
@@ -521,6 +567,7 @@ static int dns_cache_put_positive(
                 .full_packet = dns_packet_ref(full_packet),
                 .until = calculate_until(until_valid, stale_retention_usec),
                 .until_valid = until_valid,
+                .prefetch_after = calculate_prefetch_after(until_valid, timestamp),
                 .query_flags = query_flags & CACHEABLE_QUERY_FLAGS,
                 .shared_owner = shared_owner,
                 .dnssec_result = dnssec_result,
@@ -1089,6 +1136,8 @@ int dns_cache_lookup(
                         goto miss;
                 }
 
+                j->n_hit++;
+
                 if (j->type == DNS_CACHE_NXDOMAIN)
                         nxdomain = true;
                 else if (j->type == DNS_CACHE_RCODE)
@@ -1282,6 +1331,31 @@ miss:
         return 0;
 }
 
+bool dns_cache_prefetch_wanted(DnsCache *c, DnsResourceKey *key, usec_t t) {
+        DnsCacheItem *first;
+
+        assert(c);
+        assert(key);
+
+        /* Returns true if the primary answer for the key is popular and about to expire, so that it is worth
+         * refreshing it before the next lookup has to wait for the network. Note that CNAME/DNAME redirections
+         * are not followed here, only the directly cached key is considered. */
+
+        first = hashmap_get(c->by_key, key);
+        if (!first)
+                return false;
+
+        LIST_FOREACH(by_key, j, first) {
+                if (j->type != DNS_CACHE_POSITIVE || !DNS_CACHE_ITEM_IS_PRIMARY(j))
+                        continue;
+
+                if (j->n_hit >= CACHE_PREFETCH_MIN_HITS && t >= j->prefetch_after && t < j->until_valid)
+                        return true;
+        }
+
+        return false;
+}
+
 int dns_cache_check_conflicts(DnsCache *cache, DnsResourceRecord *rr, int owner_family, const union in_addr_union *owner_address) {
         DnsCacheItem *first;
         bool same_owner = true;
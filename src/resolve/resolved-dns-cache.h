@@ -13,6 +13,9 @@ typedef struct DnsCache {
         Prioq *by_expiry;
         unsigned n_hit;
         unsigned n_miss;
+        unsigned n_prefetch;
+        uint64_t n_bytes;   /* Estimated memory used by the cached items */
+        uint64_t max_bytes; /* CacheSizeMax=, 0 if only the number of items is limited */
 } DnsCache;
 
 #include "resolved-dns-answer.h"
@@ -48,6 +51,8 @@ int dns_cache_lookup(
                 uint64_t *ret_query_flags,
                 DnssecResult *ret_dnssec_result);
 
+bool dns_cache_prefetch_wanted(DnsCache *c, DnsResourceKey *key, usec_t t);
+
 int dns_cache_check_conflicts(DnsCache *cache, DnsResourceRecord *rr, int owner_family, const union in_addr_union *owner_address);
 
 void dns_cache_dump(DnsCache *cache, FILE *f);
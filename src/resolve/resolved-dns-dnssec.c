@@ -9,8 +9,10 @@
 #include "memory-util.h"
 #include "memstream-util.h"
 #include "openssl-util.h"
+#include "ordered-set.h"
 #include "resolved-dns-dnssec.h"
 #include "resolved-dns-packet.h"
+#include "sha256.h"
 #include "sort-util.h"
 #include "string-table.h"
 
@@ -32,6 +34,9 @@ DEFINE_TRIVIAL_CLEANUP_FUNC_FULL(EC_KEY*, EC_KEY_free, NULL);
  * RFC9276 § 3.2 says that we should reduce the acceptable iteration count */
 #define NSEC3_ITERATIONS_MAX 100
 
+/* Maximum number of successful signature verifications we remember */
+#define VERIFY_CACHE_MAX 1024U
+
 /*
  * The DNSSEC Chain of trust:
  *
@@ -71,6 +76,36 @@ uint16_t dnssec_keytag(DnsResourceRecord *dnskey, bool mask_revoke) {
 
 #if HAVE_OPENSSL_OR_GCRYPT
 
+/* Remembers successful signature verifications, so that we don't have to redo the public key operation each
+ * time the same RRset is fetched again. Each entry is a SHA-256 digest over everything that goes into the
+ * verification: the signed data (which includes the RRSIG RDATA minus the signature, and the canonical RRset),
+ * the signature and the DNSKEY. This keeps the entries small no matter how large the RRsets are, and a hit
+ * requires a SHA-256 collision to be any worse than the verification itself. */
+typedef struct VerifyCacheEntry {
+        uint8_t digest[SHA256_DIGEST_SIZE];
+} VerifyCacheEntry;
+
+static OrderedSet *verify_cache = NULL;
+
+static void verify_cache_entry_hash_func(const VerifyCacheEntry *e, struct siphash *state) {
+        siphash24_compress_typesafe(e->digest, state);
+}
+
+static int verify_cache_entry_compare_func(const VerifyCacheEntry *x, const VerifyCacheEntry *y) {
+        return memcmp(x->digest, y->digest, sizeof(x->digest));
+}
+
+DEFINE_PRIVATE_HASH_OPS_WITH_KEY_DESTRUCTOR(
+                verify_cache_hash_ops,
+                VerifyCacheEntry,
+                verify_cache_entry_hash_func,
+                verify_cache_entry_compare_func,
+                free);
+
+void dnssec_verify_cache_flush(void) {
+        verify_cache = ordered_set_free(verify_cache);
+}
+
 static int rr_compare(DnsResourceRecord * const *a, DnsResourceRecord * const *b) {
         const DnsResourceRecord *x = *a, *y = *b;
         size_t m;
@@ -975,6 +1010,77 @@ static int dnssec_rrset_verify_sig(
         }
 }
 
+static void verify_cache_digest_field(struct sha256_ctx *ctx, const void *p, size_t n) {
+        assert(ctx);
+        assert(p || n == 0);
+
+        /* Include the length, so that the boundaries of the variable sized fields are unambiguous */
+        sha256_process_bytes(&n, sizeof(n), ctx);
+        if (n > 0)
+                sha256_process_bytes(p, n, ctx);
+}
+
+static VerifyCacheEntry* verify_cache_entry_new(
+                DnsResourceRecord *rrsig,
+                DnsResourceRecord *dnskey,
+                const char *sig_data,
+                size_t sig_size) {
+
+        struct sha256_ctx ctx;
+        VerifyCacheEntry *e;
+
+        assert(rrsig);
+        assert(dnskey);
+        assert(sig_data);
+
+        e = new(VerifyCacheEntry, 1);
+        if (!e)
+                return NULL;
+
+        sha256_init_ctx(&ctx);
+        verify_cache_digest_field(&ctx, sig_data, sig_size);
+        verify_cache_digest_field(&ctx, rrsig->rrsig.signature, rrsig->rrsig.signature_size);
+        sha256_process_bytes(&dnskey->dnskey.flags, sizeof(dnskey->dnskey.flags), &ctx);
+        sha256_process_bytes(&dnskey->dnskey.protocol, sizeof(dnskey->dnskey.protocol), &ctx);
+        sha256_process_bytes(&dnskey->dnskey.algorithm, sizeof(dnskey->dnskey.algorithm), &ctx);
+        verify_cache_digest_field(&ctx, dnskey->dnskey.key, dnskey->dnskey.key_size);
+        sha256_finish_ctx(&ctx, e->digest);
+
+        return e;
+}
+
+static int dnssec_rrset_verify_sig_cached(
+                DnsResourceRecord *rrsig,
+                DnsResourceRecord *dnskey,
+                const char *sig_data,
+                size_t sig_size) {
+
+        _cleanup_free_ VerifyCacheEntry *e = NULL;
+        int r;
+
+        e = verify_cache_entry_new(rrsig, dnskey, sig_data, sig_size);
+        if (!e)
+                return -ENOMEM;
+
+        if (ordered_set_contains(verify_cache, e))
+                return 1;
+
+        r = dnssec_rrset_verify_sig(rrsig, dnskey, sig_data, sig_size);
+        if (r <= 0) /* Only remember successful verifications */
+                return r;
+
+        /* Drop the oldest entry if we are full */
+        if (ordered_set_size(verify_cache) >= VERIFY_CACHE_MAX)
+                free(ordered_set_steal_first(verify_cache));
+
+        if (ordered_set_ensure_put(&verify_cache, &verify_cache_hash_ops, e) < 0)
+                log_oom_debug(); /* Not fatal, the signature is valid after all */
+        else
+                TAKE_PTR(e);
+
+        return r;
+}
+
 int dnssec_verify_rrset(
                 DnsAnswer *a,
                 const DnsResourceKey *key,
@@ -1096,7 +1202,7 @@ int dnssec_verify_rrset(
         if (r < 0)
                 return r;
 
-        r = dnssec_rrset_verify_sig(rrsig, dnskey, sig_data, sig_size);
+        r = dnssec_rrset_verify_sig_cached(rrsig, dnskey, sig_data, sig_size);
         if (r == -EOPNOTSUPP) {
                 *result = DNSSEC_UNSUPPORTED_ALGORITHM;
                 return 0;
@@ -2506,6 +2612,9 @@ int dnssec_test_positive_wildcard(
 
 #else
 
+void dnssec_verify_cache_flush(void) {
+}
+
 int dnssec_verify_rrset(
                 DnsAnswer *a,
                 const DnsResourceKey *key,
@@ -564,17 +564,35 @@ int dns_packet_append_name(
         assert(p);
         assert(name);
 
+        if (p->refuse_compression)
+                allow_compression = false;
+
+        saved_size = p->size;
+
+        /* Fast path: the very same name was written to the packet before, which is the common case for the
+         * owner names of the RRs in a reply. Names in the compression table have been validated when they
+         * were added, and compare equal only to names that are valid too, hence skip parsing it again. */
+        if (allow_compression) {
+                size_t n;
+
+                n = PTR_TO_SIZE(hashmap_get(p->names, name));
+                if (n > 0 && n < 0x4000) {
+                        assert(n < p->size);
+
+                        r = dns_packet_append_uint16(p, 0xC000 | n, NULL);
+                        if (r < 0)
+                                return r;
+
+                        goto done;
+                }
+        }
+
         r = dns_name_is_valid(name);
         if (r < 0)
                 return r;
         if (r == 0)
                 return -EINVAL;
 
-        if (p->refuse_compression)
-                allow_compression = false;
-
-        saved_size = p->size;
-
         while (!dns_name_is_root(name)) {
                 const char *z = name;
                 char label[DNS_LABEL_MAX+1];
@@ -11,6 +11,7 @@
 #include "resolved-dns-synthesize.h"
 #include "resolved-etc-hosts.h"
 #include "string-util.h"
+#include "trace-util.h"
 
 #define QUERIES_MAX 2048
 #define AUXILIARY_QUERIES_MAX 64
@@ -759,6 +760,8 @@ int dns_query_go(DnsQuery *q) {
         if (q->state != DNS_TRANSACTION_NULL)
                 return 0;
 
+        TRACE_POINT(resolved, query_start, q, q->flags);
+
         r = dns_query_try_etc_hosts(q);
         if (r < 0)
                 return r;
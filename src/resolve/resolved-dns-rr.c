@@ -9,6 +9,7 @@
 #include "hexdecoct.h"
 #include "json-util.h"
 #include "memory-util.h"
+#include "mempool.h"
 #include "resolved-dns-dnssec.h"
 #include "resolved-dns-packet.h"
 #include "resolved-dns-rr.h"
@@ -387,15 +388,25 @@ bool dns_resource_key_reduce(DnsResourceKey **a, DnsResourceKey **b) {
         return true;
 }
 
+/* Resource records are allocated and freed at a high rate when parsing replies and maintaining the cache,
+ * hence take them from a mempool, like hashmap headers. */
+DEFINE_MEMPOOL(rr_pool, DnsResourceRecord, 64);
+
+void dns_resource_record_trim_pool(void) {
+        mempool_trim(&rr_pool);
+}
+
 DnsResourceRecord* dns_resource_record_new(DnsResourceKey *key) {
+        bool use_pool = mempool_enabled && mempool_enabled();  /* mempool_enabled is a weak symbol */
         DnsResourceRecord *rr;
 
-        rr = new(DnsResourceRecord, 1);
+        rr = use_pool ? mempool_alloc_tile(&rr_pool) : new(DnsResourceRecord, 1);
         if (!rr)
                 return NULL;
 
         *rr = (DnsResourceRecord) {
                 .n_ref = 1,
+                .from_pool = use_pool,
                 .key = dns_resource_key_ref(key),
                 .expiry = USEC_INFINITY,
                 .n_skip_labels_signer = UINT8_MAX,
@@ -520,6 +531,10 @@ static DnsResourceRecord* dns_resource_record_free(DnsResourceRecord *rr) {
         }
 
         free(rr->to_string);
+
+        if (rr->from_pool)
+                return mempool_free_tile(&rr_pool, rr);
+
         return mfree(rr);
 }
 
@@ -239,6 +239,7 @@ static void dns_server_reset_counters(DnsServer *s) {
         s->n_failed_udp = 0;
         s->n_failed_tcp = 0;
         s->n_failed_tls = 0;
+        s->n_rtt_timeouts = 0;
         s->packet_truncated = false;
         s->packet_invalid = false;
         s->verified_usec = 0;
@@ -258,6 +259,9 @@ static void dns_server_reset_counters(DnsServer *s) {
 void dns_server_packet_received(DnsServer *s, int protocol, DnsServerFeatureLevel level, size_t fragsize) {
         assert(s);
 
+        /* The server is answering, so earlier expiries of the RTT based timeout were just slow replies */
+        s->n_rtt_timeouts = 0;
+
         if (protocol == IPPROTO_UDP) {
                 if (s->possible_feature_level == level)
                         s->n_failed_udp = 0;
@@ -290,6 +294,21 @@ void dns_server_packet_received(DnsServer *s, int protocol, DnsServerFeatureLeve
                 s->received_udp_fragment_max = fragsize;
 }
 
+void dns_server_packet_rtt(DnsServer *s, usec_t rtt) {
+        assert(s);
+
+        rtt = MAX(rtt, 1U);
+
+        /* Maintain the smoothed RTT and its variance the same way TCP does (RFC 6298, section 2) */
+        if (s->rtt_usec == 0) {
+                s->rtt_usec = rtt;
+                s->rtt_var_usec = rtt / 2;
+        } else {
+                s->rtt_var_usec = (3 * s->rtt_var_usec + (rtt > s->rtt_usec ? rtt - s->rtt_usec : s->rtt_usec - rtt)) / 4;
+                s->rtt_usec = (7 * s->rtt_usec + rtt) / 8;
+        }
+}
+
 void dns_server_packet_lost(DnsServer *s, int protocol, DnsServerFeatureLevel level) {
         assert(s);
         assert(s->manager);
@@ -307,6 +326,22 @@ void dns_server_packet_lost(DnsServer *s, int protocol, DnsServerFeatureLevel le
         }
 }
 
+void dns_server_packet_rtt_timeout(DnsServer *s, DnsServerFeatureLevel level) {
+        assert(s);
+
+        /* Invoked when a UDP resend timeout derived from the server's RTT expired. That timeout is much
+         * shorter than DNS_TIMEOUT_USEC, so a single expiry might just be a reply that is slower than
+         * usual. Hence only count the second and further consecutive expiries as packet loss. A server that
+         * stopped answering at the current feature level, e.g. because a middlebox drops EDNS0 or DO
+         * packets, is still downgraded that way, only one attempt later. */
+
+        if (s->possible_feature_level != level)
+                return;
+
+        if (++s->n_rtt_timeouts > 1)
+                dns_server_packet_lost(s, IPPROTO_UDP, level);
+}
+
 void dns_server_packet_truncated(DnsServer *s, DnsServerFeatureLevel level) {
         assert(s);
 
@@ -1122,6 +1157,8 @@ int dns_server_dump_state_to_json(DnsServer *server, sd_json_variant **ret) {
                         SD_JSON_BUILD_PAIR_UNSIGNED("ReceivedUDPFragmentMax", server->received_udp_fragment_max),
                         SD_JSON_BUILD_PAIR_UNSIGNED("FailedUDPAttempts", server->n_failed_udp),
                         SD_JSON_BUILD_PAIR_UNSIGNED("FailedTCPAttempts", server->n_failed_tcp),
+                        SD_JSON_BUILD_PAIR_CONDITION(server->rtt_usec > 0, "RTTUSec", SD_JSON_BUILD_UNSIGNED(server->rtt_usec)),
+                        SD_JSON_BUILD_PAIR_CONDITION(server->rtt_usec > 0, "RTTVarianceUSec", SD_JSON_BUILD_UNSIGNED(server->rtt_var_usec)),
                         SD_JSON_BUILD_PAIR_BOOLEAN("PacketTruncated", server->packet_truncated),
                         SD_JSON_BUILD_PAIR_BOOLEAN("PacketBadOpt", server->packet_bad_opt),
                         SD_JSON_BUILD_PAIR_BOOLEAN("PacketRRSIGMissing", server->packet_rrsig_missing),
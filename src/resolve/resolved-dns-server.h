@@ -83,6 +83,7 @@ struct DnsServer {
         unsigned n_failed_udp;
         unsigned n_failed_tcp;
         unsigned n_failed_tls;
+        unsigned n_rtt_timeouts;        /* Consecutive expiries of the RTT based resend timeout */
 
         bool packet_truncated:1;        /* Set when TC bit was set on reply */
         bool packet_bad_opt:1;          /* Set when OPT was missing or otherwise bad on reply */
@@ -94,6 +95,10 @@ struct DnsServer {
         usec_t verified_usec;
         usec_t features_grace_period_usec;
 
+        /* Smoothed round-trip time of UDP replies and its mean deviation, as per RFC 6298 */
+        usec_t rtt_usec;
+        usec_t rtt_var_usec;
+
         /* Whether we already warned about downgrading to non-DNSSEC mode for this server */
         bool warned_downgrade:1;
 
@@ -128,6 +133,8 @@ void dns_server_move_back_and_unmark(DnsServer *s);
 
 void dns_server_packet_received(DnsServer *s, int protocol, DnsServerFeatureLevel level, size_t fragsize);
 void dns_server_packet_lost(DnsServer *s, int protocol, DnsServerFeatureLevel level);
+void dns_server_packet_rtt(DnsServer *s, usec_t rtt);
+void dns_server_packet_rtt_timeout(DnsServer *s, DnsServerFeatureLevel level);
 void dns_server_packet_truncated(DnsServer *s, DnsServerFeatureLevel level);
 void dns_server_packet_rrsig_missing(DnsServer *s, DnsServerFeatureLevel level);
 void dns_server_packet_bad_opt(DnsServer *s, DnsServerFeatureLevel level);
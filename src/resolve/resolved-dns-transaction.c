@@ -15,6 +15,7 @@
 #include "resolved-dnstls.h"
 #include "resolved-llmnr.h"
 #include "string-table.h"
+#include "trace-util.h"
 
 #define TRANSACTIONS_MAX 4096
 #define TRANSACTION_TCP_TIMEOUT_USEC (10U*USEC_PER_SEC)
@@ -22,6 +23,9 @@
 /* After how much time to repeat classic DNS requests */
 #define DNS_TIMEOUT_USEC (SD_RESOLVED_QUERY_TIMEOUT_USEC / DNS_TRANSACTION_ATTEMPTS_MAX)
 
+/* Lower bound for the resend timeout derived from the measured server RTT */
+#define DNS_TIMEOUT_MIN_USEC (1U*USEC_PER_SEC)
+
 static void dns_transaction_reset_answer(DnsTransaction *t) {
         assert(t);
 
@@ -1079,6 +1083,9 @@ void dns_transaction_process_reply(DnsTransaction *t, DnsPacket *p, bool encrypt
         if (t->state != DNS_TRANSACTION_PENDING)
                 return;
 
+        /* Arguments: transaction id, protocol, rcode, packet size */
+        TRACE_POINT(resolved, upstream_reply, t->id, (int) t->scope->protocol, DNS_PACKET_RCODE(p), p->size);
+
         /* Increment the total failure counter only when it is the first attempt at querying and the upstream
          * server returns a failure response code. This ensures a more accurate count of the number of queries
          * that received a failure response code, as it doesn't consider retries. */
@@ -1352,6 +1359,12 @@ void dns_transaction_process_reply(DnsTransaction *t, DnsPacket *p, bool encrypt
                 if (DNS_PACKET_TC(p))
                         dns_server_packet_truncated(t->server, t->current_feature_level);
 
+                /* Only sample UDP, the TCP/TLS handshake would skew the numbers. And only sample replies to
+                 * the first attempt, since after a resend we can't tell which query a reply belongs to
+                 * (Karn's algorithm). */
+                if (t->server && p->ipproto == IPPROTO_UDP && t->n_attempts == 1 && p->timestamp > t->start_usec)
+                        dns_server_packet_rtt(t->server, p->timestamp - t->start_usec);
+
                 break;
         }
 
@@ -1576,7 +1589,14 @@ static int on_transaction_timeout(sd_event_source *s, usec_t usec, void *userdat
 
                 case DNS_PROTOCOL_DNS:
                         assert(t->server);
-                        dns_server_packet_lost(t->server, t->stream ? IPPROTO_TCP : IPPROTO_UDP, t->current_feature_level);
+
+                        /* A timeout derived from the server's RTT (see transaction_get_resend_timeout())
+                         * expires much sooner than the fixed one, let the server decide whether that's
+                         * packet loss or just a slow reply. */
+                        if (!t->stream && usec - t->start_usec < DNS_TIMEOUT_USEC)
+                                dns_server_packet_rtt_timeout(t->server, t->current_feature_level);
+                        else
+                                dns_server_packet_lost(t->server, t->stream ? IPPROTO_TCP : IPPROTO_UDP, t->current_feature_level);
                         break;
 
                 case DNS_PROTOCOL_LLMNR:
@@ -1638,6 +1658,12 @@ static usec_t transaction_get_resend_timeout(DnsTransaction *t) {
                 if (t->stream)
                         return TRANSACTION_TCP_TIMEOUT_USEC;
 
+                /* Once we know how quickly the server usually answers, don't wait the full timeout before
+                 * resending, and switch away from a server that stopped responding sooner. */
+                if (t->server && t->server->rtt_usec > 0)
+                        return CLAMP(t->server->rtt_usec + 4 * t->server->rtt_var_usec,
+                                     DNS_TIMEOUT_MIN_USEC, DNS_TIMEOUT_USEC);
+
                 return DNS_TIMEOUT_USEC;
 
         case DNS_PROTOCOL_MDNS:
@@ -1680,6 +1706,52 @@ static void dns_transaction_randomize_answer(DnsTransaction *t) {
         dns_answer_randomize(t->answer);
 }
 
+static void dns_transaction_prefetch(DnsTransaction *t, usec_t ts) {
+        _cleanup_(dns_transaction_gcp) DnsTransaction *p = NULL;
+        uint64_t query_flags;
+        int r;
+
+        assert(t);
+
+        /* Called when the transaction is answered from the cache. If the cached answer is popular and about
+         * to expire, refresh it in the background, so that the next lookups don't have to wait for the
+         * network once the TTL ran out. */
+
+        if (!t->scope->manager->cache_prefetch)
+                return;
+
+        if (t->scope->protocol != DNS_PROTOCOL_DNS || t->bypass)
+                return;
+
+        if (FLAGS_SET(t->query_flags, SD_RESOLVED_NO_NETWORK))
+                return;
+
+        if (!dns_cache_prefetch_wanted(&t->scope->cache, dns_transaction_key(t), ts))
+                return;
+
+        /* The refresh must not be answered from the very cache entry it is supposed to replace */
+        query_flags = t->query_flags | SD_RESOLVED_NO_CACHE;
+
+        /* Already refreshing? */
+        if (dns_scope_find_transaction(t->scope, dns_transaction_key(t), query_flags))
+                return;
+
+        r = dns_transaction_new(&p, t->scope, dns_transaction_key(t), NULL, query_flags);
+        if (r < 0)
+                return (void) log_debug_errno(r, "Failed to create prefetch transaction, ignoring: %m");
+
+        /* Nobody waits for the result, keep the transaction around until the answer is in the cache. */
+        p->wait_for_answer = true;
+
+        p->block_gc++;
+        r = dns_transaction_go(p);
+        p->block_gc--;
+        if (r < 0)
+                return (void) log_debug_errno(r, "Failed to start prefetch transaction, ignoring: %m");
+
+        t->scope->cache.n_prefetch++;
+}
+
 static int dns_transaction_prepare(DnsTransaction *t, usec_t ts) {
         int r;
 
@@ -1832,7 +1904,10 @@ static int dns_transaction_prepare(DnsTransaction *t, usec_t ts) {
                                         log_debug("Serve Stale response rcode=%s for %s",
                                                 FORMAT_DNS_RCODE(t->answer_rcode),
                                                 dns_resource_key_to_string(dns_transaction_key(t), key_str, sizeof key_str));
-                                }
+                                } else
+                                        dns_transaction_prefetch(t, ts);
+
+                                TRACE_POINT(resolved, cache_hit, t->id, dns_transaction_key(t)->type, t->answer_rcode);
 
                                 t->answer_source = DNS_TRANSACTION_CACHE;
                                 if (t->answer_rcode == DNS_RCODE_SUCCESS)
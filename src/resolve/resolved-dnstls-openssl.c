@@ -61,6 +61,27 @@ static int dnstls_flush_write_buffer(DnsStream *stream) {
         return 0;
 }
 
+static int dnstls_new_session(SSL *ssl, SSL_SESSION *session) {
+        DnsStream *stream;
+
+        assert(ssl);
+        assert(session);
+
+        /* With TLS 1.3 session tickets are sent by the server after the handshake, possibly at any time
+         * during the lifetime of the connection. Store them as soon as they arrive, so that the next
+         * connection to the server can be resumed even if this one is not shut down cleanly. */
+
+        stream = SSL_get_app_data(ssl);
+        if (!stream || !stream->server)
+                return 0;
+
+        if (stream->server->dnstls_data.session)
+                SSL_SESSION_free(stream->server->dnstls_data.session);
+
+        stream->server->dnstls_data.session = session;
+        return 1; /* We took ownership of the session */
+}
+
 int dnstls_stream_connect_tls(DnsStream *stream, DnsServer *server) {
         _cleanup_(BIO_freep) BIO *rb = NULL, *wb = NULL;
         _cleanup_(SSL_freep) SSL *s = NULL;
@@ -89,6 +110,7 @@ int dnstls_stream_connect_tls(DnsStream *stream, DnsServer *server) {
         r = SSL_set_session(s, server->dnstls_data.session);
         if (r == 0)
                 return -EIO;
+        SSL_set_app_data(s, stream);
         SSL_set_bio(s, TAKE_PTR(rb), TAKE_PTR(wb));
 
         if (server->manager->dns_over_tls_mode == DNS_OVER_TLS_YES) {
@@ -402,6 +424,10 @@ int dnstls_manager_init(Manager *manager) {
 
         (void) SSL_CTX_set_options(manager->dnstls_data.ctx, SSL_OP_NO_COMPRESSION);
 
+        /* Sessions are kept per server by us, see dnstls_new_session(). */
+        (void) SSL_CTX_set_session_cache_mode(manager->dnstls_data.ctx, SSL_SESS_CACHE_CLIENT|SSL_SESS_CACHE_NO_INTERNAL_STORE);
+        SSL_CTX_sess_set_new_cb(manager->dnstls_data.ctx, dnstls_new_session);
+
         r = SSL_CTX_set_default_verify_paths(manager->dnstls_data.ctx);
         if (r == 0)
                 return log_warning_errno(SYNTHETIC_ERRNO(EIO),
@@ -40,7 +40,6 @@ static EtcHostsItemByName *etc_hosts_item_by_name_free(EtcHostsItemByName *item)
         if (!item)
                 return NULL;
 
-        free(item->name);
         set_free(item->addresses);
         return mfree(item);
 }
@@ -124,6 +123,7 @@ static int parse_line(EtcHosts *hosts, unsigned nr, const char *line) {
         for (;;) {
                 _cleanup_free_ char *name = NULL;
                 EtcHostsItemByName *bn;
+                const char *n;
 
                 r = extract_first_word(&line, &name, NULL, EXTRACT_RELAX);
                 if (r < 0)
@@ -153,21 +153,33 @@ static int parse_line(EtcHosts *hosts, unsigned nr, const char *line) {
                         continue;
                 }
 
-                bn = hashmap_get(hosts->by_name, name);
+                r = set_ensure_put(&item->names, &dns_name_hash_ops_free, name);
+                if (r < 0)
+                        return log_oom();
+                if (r == 0) /* the name is already listed, hence the by-name entry already has this address */
+                        continue;
+
+                /* The name string is owned by the set of names of the address item. The by-name entry
+                 * and the by-name hashmap merely reference it, to save an allocation per name. */
+                n = TAKE_PTR(name);
+
+                /*
+                 * Keep track of the first name listed for this address.
+                 * This name will be used in responses as the canonical name.
+                 */
+                if (!item->canonical_name)
+                        item->canonical_name = n;
+
+                bn = hashmap_get(hosts->by_name, n);
                 if (!bn) {
                         _cleanup_(etc_hosts_item_by_name_freep) EtcHostsItemByName *new_item = NULL;
-                        _cleanup_free_ char *name_copy = NULL;
-
-                        name_copy = strdup(name);
-                        if (!name_copy)
-                                return log_oom();
 
                         new_item = new(EtcHostsItemByName, 1);
                         if (!new_item)
                                 return log_oom();
 
                         *new_item = (EtcHostsItemByName) {
-                                .name = TAKE_PTR(name_copy),
+                                .name = n,
                         };
 
                         r = hashmap_ensure_put(&hosts->by_name, &by_name_hash_ops, new_item->name, new_item);
@@ -177,30 +189,10 @@ static int parse_line(EtcHosts *hosts, unsigned nr, const char *line) {
                         bn = TAKE_PTR(new_item);
                 }
 
-                if (!set_contains(bn->addresses, &address)) {
-                        _cleanup_free_ struct in_addr_data *address_copy = NULL;
-
-                        address_copy = newdup(struct in_addr_data, &address, 1);
-                        if (!address_copy)
-                                return log_oom();
-
-                        r = set_ensure_consume(&bn->addresses, &in_addr_data_hash_ops_free, TAKE_PTR(address_copy));
-                        if (r < 0)
-                                return log_oom();
-                }
-
-                r = set_ensure_put(&item->names, &dns_name_hash_ops_free, name);
+                /* Similarly, reference the address stored in the address item instead of copying it */
+                r = set_ensure_put(&bn->addresses, &in_addr_data_hash_ops, &item->address);
                 if (r < 0)
                         return log_oom();
-                if (r == 0) /* the name is already listed */
-                        continue;
-                /*
-                 * Keep track of the first name listed for this address.
-                 * This name will be used in responses as the canonical name.
-                 */
-                if (!item->canonical_name)
-                        item->canonical_name = name;
-                TAKE_PTR(name);
         }
 
         if (!found)
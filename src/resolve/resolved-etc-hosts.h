@@ -12,8 +12,8 @@ typedef struct EtcHostsItemByAddress {
 } EtcHostsItemByAddress;
 
 typedef struct EtcHostsItemByName {
-        char *name;
-        Set *addresses;
+        const char *name;   /* owned by the 'names' set of an EtcHostsItemByAddress */
+        Set *addresses;     /* points to the 'address' fields of EtcHostsItemByAddress */
 } EtcHostsItemByName;
 
 int etc_hosts_parse(EtcHosts *hosts, FILE *f);
@@ -31,6 +31,7 @@
 #include "random-util.h"
 #include "resolved-bus.h"
 #include "resolved-conf.h"
+#include "resolved-dns-dnssec.h"
 #include "resolved-dns-stub.h"
 #include "resolved-dnssd.h"
 #include "resolved-etc-hosts.h"
@@ -553,6 +554,7 @@ static int manager_memory_pressure(sd_event_source *s, void *userdata) {
         log_info("Under memory pressure, flushing caches.");
 
         manager_flush_caches(m, LOG_INFO);
+        dns_resource_record_trim_pool();
         sd_event_trim_memory();
 
         return 0;
@@ -584,6 +586,8 @@ static void manager_set_defaults(Manager *m) {
         m->resolve_unicast_single_label = false;
         m->cache_from_localhost = false;
         m->stale_retention_usec = 0;
+        m->cache_prefetch = false;
+        m->cache_size_max = 0;
 }
 
 static int manager_dispatch_reload_signal(sd_event_source *s, const struct signalfd_siginfo *si, void *userdata) {
@@ -612,6 +616,9 @@ static int manager_dispatch_reload_signal(sd_event_source *s, const struct signa
         else
                 log_info("Config file reloaded.");
 
+        LIST_FOREACH(scopes, s, m->dns_scopes)
+                s->cache.max_bytes = m->cache_size_max;
+
         r = dnssd_load(m);
         if (r < 0)
                 log_warning_errno(r, "Failed to load DNS-SD configuration files: %m");
@@ -838,6 +845,7 @@ Manager *manager_free(Manager *m) {
         hashmap_free(m->dnssd_services);
 
         dns_trust_anchor_flush(&m->trust_anchor);
+        dnssec_verify_cache_flush();
         manager_etc_hosts_flush(m);
 
         return mfree(m);
@@ -1706,6 +1714,8 @@ void manager_flush_caches(Manager *m, int log_level) {
         LIST_FOREACH(scopes, scope, m->dns_scopes)
                 dns_cache_flush(&scope->cache);
 
+        dnssec_verify_cache_flush();
+
         log_full(log_level, "Flushed all caches.");
 }
 
@@ -1885,7 +1895,7 @@ int socket_disable_pmtud(int fd, int af) {
 }
 
 int dns_manager_dump_statistics_json(Manager *m, sd_json_variant **ret) {
-        uint64_t size = 0, hit = 0, miss = 0;
+        uint64_t size = 0, hit = 0, miss = 0, prefetch = 0;
 
         assert(m);
         assert(ret);
@@ -1894,6 +1904,7 @@ int dns_manager_dump_statistics_json(Manager *m, sd_json_variant **ret) {
                 size += dns_cache_size(&s->cache);
                 hit += s->cache.n_hit;
                 miss += s->cache.n_miss;
+                prefetch += s->cache.n_prefetch;
         }
 
         return sd_json_buildo(ret,
@@ -1908,7 +1919,8 @@ int dns_manager_dump_statistics_json(Manager *m, sd_json_variant **ret) {
                               SD_JSON_BUILD_PAIR("cache", SD_JSON_BUILD_OBJECT(
                                                                  SD_JSON_BUILD_PAIR_UNSIGNED("size", size),
                                                                  SD_JSON_BUILD_PAIR_UNSIGNED("hits", hit),
-                                                                 SD_JSON_BUILD_PAIR_UNSIGNED("misses", miss)
+                                                                 SD_JSON_BUILD_PAIR_UNSIGNED("misses", miss),
+                                                                 SD_JSON_BUILD_PAIR_UNSIGNED("prefetches", prefetch)
                                                  )),
                               SD_JSON_BUILD_PAIR("dnssec", SD_JSON_BUILD_OBJECT(
                                                                  SD_JSON_BUILD_PAIR_UNSIGNED("secure", m->n_dnssec_verdict[DNSSEC_SECURE]),
@@ -1923,7 +1935,7 @@ void dns_manager_reset_statistics(Manager *m) {
         assert(m);
 
         LIST_FOREACH(scopes, s, m->dns_scopes)
-                s->cache.n_hit = s->cache.n_miss = 0;
+                s->cache.n_hit = s->cache.n_miss = s->cache.n_prefetch = 0;
 
         m->n_transactions_total = 0;
         m->n_timeouts_total = 0;
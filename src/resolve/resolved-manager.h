@@ -42,6 +42,8 @@ struct Manager {
         DnsOverTlsMode dns_over_tls_mode;
         DnsCacheMode enable_cache;
         bool cache_from_localhost;
+        bool cache_prefetch;
+        uint64_t cache_size_max;
         DnsStubListenerMode dns_stub_listener_mode;
         usec_t stale_retention_usec;
 
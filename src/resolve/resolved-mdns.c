@@ -236,6 +236,22 @@ static bool sender_on_local_subnet(DnsScope *s, DnsPacket *p) {
         return false;
 }
 
+static bool mdns_known_answer_suppressed(DnsPacket *p, DnsResourceRecord *rr) {
+        DnsResourceRecord *known;
+
+        assert(p);
+        assert(rr);
+
+        /* RFC 6762, section 7.1: don't answer with a record the querier listed in the Known-Answer section
+         * of its query, as long as the TTL it knows is at least half of the true TTL. */
+
+        DNS_ANSWER_FOREACH(known, p->answer)
+                if (known->ttl >= rr->ttl / 2 && dns_resource_record_equal(known, rr) > 0)
+                        return true;
+
+        return false;
+}
+
 static int mdns_scope_process_query(DnsScope *s, DnsPacket *p) {
         _cleanup_(dns_answer_unrefp) DnsAnswer *full_answer = NULL;
         _cleanup_(dns_packet_unrefp) DnsPacket *reply = NULL;
@@ -315,6 +331,11 @@ static int mdns_scope_process_query(DnsScope *s, DnsPacket *p) {
 
                 DNS_ANSWER_FOREACH_ITEM(item, answer) {
                         DnsAnswerFlags flags = item->flags | DNS_ANSWER_REFUSE_TTL_NO_MATCH;
+
+                        /* Legacy resolvers don't send Known-Answers, hence only check regular mDNS queries */
+                        if (!legacy_query && mdns_known_answer_suppressed(p, item->rr))
+                                continue;
+
                         /* The cache-flush bit must not be set in legacy unicast responses.
                          * See section 6.7 of RFC 6762. */
                         if (legacy_query)
@@ -508,6 +508,30 @@ TEST(dns_a_to_cname_success_escaped_name_returns_error) {
         ASSERT_TRUE(dns_cache_is_empty(&cache));
 }
 
+TEST(dns_cache_put_max_bytes) {
+        _cleanup_(dns_cache_unrefp) DnsCache cache = new_cache();
+        _cleanup_(put_args_unrefp) PutArgs args1 = mk_put_args(), args2 = mk_put_args();
+
+        /* Any single item exceeds the budget, hence each put evicts the previous entries */
+        cache.max_bytes = 1;
+
+        args1.key = dns_resource_key_new(DNS_CLASS_IN, DNS_TYPE_A, "www.example.com");
+        ASSERT_NOT_NULL(args1.key);
+        answer_add_a(&args1, args1.key, 0xc0a8017f, 3600, DNS_ANSWER_CACHEABLE);
+        ASSERT_OK(cache_put(&cache, &args1));
+        ASSERT_EQ(dns_cache_size(&cache), 1u);
+        ASSERT_GT(cache.n_bytes, 0u);
+
+        args2.key = dns_resource_key_new(DNS_CLASS_IN, DNS_TYPE_A, "mail.example.com");
+        ASSERT_NOT_NULL(args2.key);
+        answer_add_a(&args2, args2.key, 0x7f01a8cc, 3600, DNS_ANSWER_CACHEABLE);
+        ASSERT_OK(cache_put(&cache, &args2));
+        ASSERT_EQ(dns_cache_size(&cache), 1u);
+
+        ASSERT_FALSE(dns_cache_lookup(&cache, args1.key, 0, NULL, NULL, NULL, NULL, NULL));
+        ASSERT_OK_POSITIVE(dns_cache_lookup(&cache, args2.key, 0, NULL, NULL, NULL, NULL, NULL));
+}
+
 /* ================================================================
  * dns_cache_lookup()
  * ================================================================ */
@@ -889,6 +913,38 @@ TEST(dns_cache_lookup_mdns_multiple_unshared_responses_are_not_cached) {
         dns_resource_record_unref(rr);
 }
 
+/* ================================================================
+ * dns_cache_prefetch_wanted()
+ * ================================================================ */
+
+TEST(dns_cache_prefetch_wanted) {
+        _cleanup_(dns_cache_unrefp) DnsCache cache = new_cache();
+        _cleanup_(put_args_unrefp) PutArgs put_args = mk_put_args();
+        _cleanup_(dns_resource_key_unrefp) DnsResourceKey *key = NULL;
+        usec_t t;
+
+        put_args.key = dns_resource_key_new(DNS_CLASS_IN, DNS_TYPE_A, "www.example.com");
+        ASSERT_NOT_NULL(put_args.key);
+        answer_add_a(&put_args, put_args.key, 0xc0a8017f, 3, DNS_ANSWER_CACHEABLE);
+        t = now(CLOCK_BOOTTIME);
+        cache_put(&cache, &put_args);
+
+        key = dns_resource_key_new(DNS_CLASS_IN, DNS_TYPE_A, "www.example.com");
+        ASSERT_NOT_NULL(key);
+
+        /* Not used yet, and not close to expiry either */
+        ASSERT_FALSE(dns_cache_prefetch_wanted(&cache, key, t));
+
+        ASSERT_OK_POSITIVE(dns_cache_lookup(&cache, key, 0, NULL, NULL, NULL, NULL, NULL));
+        ASSERT_OK_POSITIVE(dns_cache_lookup(&cache, key, 0, NULL, NULL, NULL, NULL, NULL));
+        ASSERT_FALSE(dns_cache_prefetch_wanted(&cache, key, t));
+
+        /* The entry was put at or shortly after 't', hence 't + 2.9s' is in the last tenth of the TTL, and
+         * 't + 4s' is past it */
+        ASSERT_TRUE(dns_cache_prefetch_wanted(&cache, key, t + 2900 * USEC_PER_MSEC));
+        ASSERT_FALSE(dns_cache_prefetch_wanted(&cache, key, t + 4 * USEC_PER_SEC));
+}
+
 /* ================================================================
  * dns_cache_prune(), dns_cache_expiry_in_one_second()
  * ================================================================ */
@@ -0,0 +1,83 @@
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+
+#include <netinet/in.h>
+
+#include "log.h"
+#include "resolved-dns-server.h"
+#include "resolved-manager.h"
+#include "tests.h"
+
+typedef struct ServerEnv {
+        Manager manager;
+        DnsServer *server;
+} ServerEnv;
+
+static void server_env_teardown(ServerEnv *env) {
+        ASSERT_NOT_NULL(env);
+
+        if (env->server)
+                dns_server_unlink(env->server);
+        sd_event_unref(env->manager.event);
+}
+
+static void server_env_setup(ServerEnv *env) {
+        union in_addr_union addr = { .in.s_addr = htobe32(0x7f000001) };
+
+        ASSERT_NOT_NULL(env);
+
+        env->manager = (Manager) {};
+        ASSERT_OK(sd_event_new(&env->manager.event));
+
+        ASSERT_OK(dns_server_new(&env->manager, &env->server, DNS_SERVER_SYSTEM, /* link= */ NULL,
+                                 AF_INET, &addr, 53, /* ifindex= */ 0, /* server_name= */ NULL,
+                                 RESOLVE_CONFIG_SOURCE_DBUS));
+        ASSERT_NOT_NULL(env->server);
+
+        /* Pretend we know how fast the server usually is, so that transactions use RTT based timeouts */
+        dns_server_packet_rtt(env->server, 20 * USEC_PER_MSEC);
+}
+
+/* ================================================================
+ * dns_server_packet_rtt_timeout()
+ * ================================================================ */
+
+TEST(dns_server_packet_rtt_timeout_slow) {
+        _cleanup_(server_env_teardown) ServerEnv env = {};
+        DnsServerFeatureLevel level;
+
+        server_env_setup(&env);
+        level = dns_server_possible_feature_level(env.server);
+
+        /* A server that is merely slow sometimes, i.e. replies after every expiry, is never downgraded */
+        for (unsigned i = 0; i < 10; i++) {
+                dns_server_packet_rtt_timeout(env.server, level);
+                ASSERT_EQ(env.server->n_failed_udp, 0u);
+                dns_server_packet_received(env.server, IPPROTO_UDP, level, 512);
+                ASSERT_EQ(dns_server_possible_feature_level(env.server), level);
+        }
+}
+
+TEST(dns_server_packet_rtt_timeout_lost) {
+        _cleanup_(server_env_teardown) ServerEnv env = {};
+        DnsServerFeatureLevel level;
+
+        server_env_setup(&env);
+        level = dns_server_possible_feature_level(env.server);
+
+        /* The first expiry in a row is not counted, the following ones are */
+        dns_server_packet_rtt_timeout(env.server, level);
+        ASSERT_EQ(env.server->n_failed_udp, 0u);
+        dns_server_packet_rtt_timeout(env.server, level);
+        ASSERT_EQ(env.server->n_failed_udp, 1u);
+
+        /* Expiries at a feature level we already left behind don't count at all */
+        dns_server_packet_rtt_timeout(env.server, level + 1);
+        ASSERT_EQ(env.server->n_failed_udp, 1u);
+
+        /* A server that stopped answering at this feature level is eventually downgraded */
+        for (unsigned i = 0; i < 2; i++)
+                dns_server_packet_rtt_timeout(env.server, level);
+        ASSERT_LT(dns_server_possible_feature_level(env.server), level);
+}
+
+DEFINE_TEST_MAIN(LOG_DEBUG);
@@ -451,6 +451,19 @@ TEST(dnssec_verify_rfc6605_example2) {
         assert_se(dnssec_verify_rrset(answer, a->key, rrsig, dnskey,
                                       rrsig->rrsig.inception * USEC_PER_SEC, &result) >= 0);
         assert_se(result == DNSSEC_VALIDATED);
+
+        /* Once more, this time the result comes from the verification cache */
+        assert_se(dnssec_verify_rrset(answer, a->key, rrsig, dnskey,
+                                      rrsig->rrsig.inception * USEC_PER_SEC, &result) >= 0);
+        assert_se(result == DNSSEC_VALIDATED);
+
+        /* A corrupted signature must not match the cached verification */
+        ((uint8_t*) rrsig->rrsig.signature)[0] ^= 0xff;
+        assert_se(dnssec_verify_rrset(answer, a->key, rrsig, dnskey,
+                                      rrsig->rrsig.inception * USEC_PER_SEC, &result) >= 0);
+        assert_se(result == DNSSEC_INVALID);
+
+        dnssec_verify_cache_flush();
 }
 
 TEST(dnssec_verify_rrset) {
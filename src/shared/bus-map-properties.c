@@ -140,31 +140,41 @@ int bus_message_map_all_properties(
                 sd_bus_error *error,
                 void *userdata) {
 
+        size_t n_map = 0, next = 0;
         int r;
 
         assert(m);
         assert(map);
 
+        while (map[n_map].member)
+                n_map++;
+
         r = sd_bus_message_enter_container(m, SD_BUS_TYPE_ARRAY, "{sv}");
         if (r < 0)
                 return bus_log_parse_error_debug(r);
 
         while ((r = sd_bus_message_enter_container(m, SD_BUS_TYPE_DICT_ENTRY, "sv")) > 0) {
-                const struct bus_properties_map *prop;
+                const struct bus_properties_map *prop = NULL;
                 const char *member;
                 const char *contents;
                 void *v;
-                unsigned i;
 
                 r = sd_bus_message_read_basic(m, SD_BUS_TYPE_STRING, &member);
                 if (r < 0)
                         return bus_log_parse_error_debug(r);
 
-                for (i = 0, prop = NULL; map[i].member; i++)
+                /* Replies to GetAll() list the properties in vtable order, and maps are usually written in
+                 * the same order. Hence start looking right after the previous match, which makes the
+                 * lookup cheap for large maps, and wrap around so that any order still works. */
+                for (size_t k = 0; k < n_map; k++) {
+                        size_t i = (next + k) % n_map;
+
                         if (streq(map[i].member, member)) {
                                 prop = &map[i];
+                                next = i + 1;
                                 break;
                         }
+                }
 
                 if (prop) {
                         r = sd_bus_message_peek_type(m, NULL, &contents);
@@ -176,7 +186,7 @@ int bus_message_map_all_properties(
                                 return bus_log_parse_error_debug(r);
 
                         v = (uint8_t *)userdata + prop->offset;
-                        if (map[i].set)
+                        if (prop->set)
                                 r = prop->set(sd_bus_message_get_bus(m), member, m, error, v);
                         else
                                 r = map_basic(m, flags, v);
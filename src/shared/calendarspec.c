@@ -1395,6 +1395,24 @@ typedef struct SpecNextResult {
         int return_value;
 } SpecNextResult;
 
+static bool timezone_is_local(const char *tz) {
+        _cleanup_free_ char *local = NULL;
+        const char *e;
+
+        assert(tz);
+
+        /* $TZ takes precedence over /etc/localtime. Only accept the form the child process below would set,
+         * anything else may be interpreted differently by libc. */
+        e = getenv("TZ");
+        if (e)
+                return streq_ptr(startswith(e, ":"), tz);
+
+        if (get_timezone(&local) < 0)
+                return false;
+
+        return streq(local, tz);
+}
+
 int calendar_spec_next_usec(const CalendarSpec *spec, usec_t usec, usec_t *ret_next) {
         SpecNextResult *shared, tmp;
         int r;
@@ -1404,6 +1422,14 @@ int calendar_spec_next_usec(const CalendarSpec *spec, usec_t usec, usec_t *ret_n
         if (isempty(spec->timezone))
                 return calendar_spec_next_usec_impl(spec, usec, ret_next);
 
+        /* Specs often carry the system's own timezone explicitly. No need to fork off a child to switch
+         * the timezone then, which is costly when many timers are rescheduled at once. Make sure the
+         * libc state reflects the current /etc/localtime though. */
+        if (timezone_is_local(spec->timezone)) {
+                tzset();
+                return calendar_spec_next_usec_impl(spec, usec, ret_next);
+        }
+
         shared = mmap(NULL, sizeof *shared, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_ANONYMOUS, -1, 0);
         if (shared == MAP_FAILED)
                 return negative_errno();
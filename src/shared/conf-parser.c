@@ -44,6 +44,7 @@
 #include "string-util.h"
 #include "strv.h"
 #include "syslog-util.h"
+#include "terminal-util.h"
 #include "time-util.h"
 #include "utf8.h"
 
@@ -295,6 +296,7 @@ int config_parse(
         _cleanup_fclose_ FILE *ours = NULL;
         unsigned line = 0, section_line = 0;
         bool section_ignored = false, bom_seen = false;
+        ReadLineFlags read_flags = 0;
         struct stat st;
         int r, fd;
 
@@ -329,6 +331,10 @@ int config_parse(
                                               "Failed to fstat(%s): %m", filename);
 
                 (void) stat_warn_permissions(filename, &st);
+
+                /* Determine once whether we read from a TTY, instead of letting read_line() check that for
+                 * each line anew */
+                read_flags = S_ISREG(st.st_mode) || !isatty_safe(fd) ? READ_LINE_NOT_A_TTY : READ_LINE_IS_A_TTY;
         } else
                 st = (struct stat) {};
 
@@ -337,7 +343,7 @@ int config_parse(
                 bool escaped = false;
                 char *l, *p, *e;
 
-                r = read_line(f, LONG_LINE_MAX, &buf);
+                r = read_line_full(f, LONG_LINE_MAX, read_flags, &buf);
                 if (r == 0)
                         break;
                 if (r == -ENOBUFS) {
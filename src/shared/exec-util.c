@@ -4,6 +4,7 @@
 #include <errno.h>
 #include <sys/prctl.h>
 #include <sys/types.h>
+#include <sys/wait.h>
 #include <unistd.h>
 #include <stdio.h>
 
@@ -30,6 +31,7 @@
 #include "string-util.h"
 #include "strv.h"
 #include "terminal-util.h"
+#include "time-util.h"
 #include "tmpfile-util.h"
 
 #define EXIT_SKIP_REMAINING 77
@@ -88,6 +90,14 @@ static int do_spawn(
         return 1;
 }
 
+static void log_execution_time(const char *path, usec_t start) {
+        assert(path);
+
+        if (DEBUG_LOGGING)
+                log_debug("%s finished after %s.",
+                          path, FORMAT_TIMESPAN(usec_sub_unsigned(now(CLOCK_MONOTONIC), start), USEC_PER_MSEC));
+}
+
 static int do_execute(
                 char * const *paths,
                 const char *root,
@@ -101,6 +111,7 @@ static int do_execute(
 
         _cleanup_hashmap_free_free_ Hashmap *pids = NULL;
         bool parallel_execution;
+        usec_t start;
         int r;
 
         /* We fork this all off from a child process so that we can somewhat cleanly make use of SIGALRM
@@ -130,6 +141,8 @@ static int do_execute(
                 if (putenv(*e) != 0)
                         return log_error_errno(errno, "Failed to set environment variable: %m");
 
+        start = now(CLOCK_MONOTONIC);
+
         STRV_FOREACH(path, paths) {
                 _cleanup_free_ char *t = NULL;
                 _cleanup_close_ int fd = -EBADF;
@@ -171,6 +184,9 @@ static int do_execute(
                                             "permission bits. Proceeding anyway.", t);
                 }
 
+                if (!parallel_execution)
+                        start = now(CLOCK_MONOTONIC);
+
                 r = do_spawn(t, argv, fd, FLAGS_SET(flags, EXEC_DIR_SET_SYSTEMD_EXEC_PID), &pid);
                 if (r <= 0)
                         continue;
@@ -186,6 +202,9 @@ static int do_execute(
                         r = wait_for_terminate_and_check(t, pid, WAIT_LOG_ABNORMAL);
                         if (r < 0)
                                 return r;
+
+                        log_execution_time(t, start);
+
                         if (r > 0) {
                                 if (FLAGS_SET(flags, EXEC_DIR_SKIP_REMAINING) && r == EXIT_SKIP_REMAINING) {
                                         log_info("%s succeeded with exit status %i, not executing remaining executables.", *path, r);
@@ -220,16 +239,30 @@ static int do_execute(
 
         while (!hashmap_isempty(pids)) {
                 _cleanup_free_ char *t = NULL;
-                pid_t pid;
-                void *p;
+                siginfo_t si = {};
+
+                /* Pick whichever child finishes first, without reaping it yet, so that the execution time
+                 * logged for each of them is accurate. All children were started at about the same time. */
+                if (waitid(P_ALL, 0, &si, WEXITED|WNOWAIT) < 0) {
+                        if (errno == EINTR)
+                                continue;
+
+                        return log_error_errno(errno, "Failed to wait for child processes: %m");
+                }
 
-                t = ASSERT_PTR(hashmap_steal_first_key_and_value(pids, &p));
-                pid = PTR_TO_PID(p);
-                assert(pid > 0);
+                t = hashmap_remove(pids, PID_TO_PTR(si.si_pid));
+                if (!t) {
+                        /* Not one of ours, just reap it. */
+                        (void) wait_for_terminate(si.si_pid, NULL);
+                        continue;
+                }
 
-                r = wait_for_terminate_and_check(t, pid, WAIT_LOG);
+                r = wait_for_terminate_and_check(t, si.si_pid, WAIT_LOG);
                 if (r < 0)
                         return r;
+
+                log_execution_time(t, start);
+
                 if (!FLAGS_SET(flags, EXEC_DIR_IGNORE_ERRORS) && r > 0)
                         return r;
         }
@@ -74,6 +74,8 @@ typedef struct TableData {
         size_t minimum_width;       /* minimum width for the column */
         size_t maximum_width;       /* maximum width for the column */
         size_t formatted_for_width; /* the width we tried to format for */
+        size_t formatted_width;     /* cached console width of 'formatted', SIZE_MAX if not measured yet */
+        size_t formatted_height;    /* cached console height of 'formatted', SIZE_MAX if not measured yet */
         unsigned weight;            /* the horizontal weight for this column, in case the table is expanded/compressed */
         unsigned ellipsize_percent; /* 0 … 100, where to place the ellipsis when compression is needed */
         unsigned align_percent;     /* 0 … 100, where to pad with spaces when expanding is needed. 0: left-aligned, 100: right-aligned */
@@ -440,6 +442,7 @@ static TableData *table_data_new(
         d->type = type;
         d->minimum_width = minimum_width;
         d->maximum_width = maximum_width;
+        d->formatted_width = d->formatted_height = SIZE_MAX;
         d->weight = weight;
         d->align_percent = align_percent;
         d->ellipsize_percent = ellipsize_percent;
@@ -1575,6 +1578,9 @@ static const char *table_data_format(Table *t, TableData *d, bool avoid_uppercas
             (d->type != TABLE_STRV_WRAPPED || d->formatted_for_width == column_width))
                 return d->formatted;
 
+        /* We are going to (re)generate the cached string, hence forget its dimensions */
+        d->formatted_width = d->formatted_height = SIZE_MAX;
+
         switch (d->type) {
         case TABLE_EMPTY:
                 return table_ersatz_string(t);
@@ -2111,9 +2117,21 @@ static int table_data_requested_width_height(
                 t = truncated;
         }
 
-        r = console_width_height(t, &width, &height);
-        if (r < 0)
-                return r;
+        if (t == d->formatted && d->formatted_width != SIZE_MAX) {
+                /* Measuring is not cheap for long strings and we do it for every cell on every pass, hence
+                 * reuse the dimensions of the cached string if we determined them before. */
+                width = d->formatted_width;
+                height = d->formatted_height;
+        } else {
+                r = console_width_height(t, &width, &height);
+                if (r < 0)
+                        return r;
+
+                if (t == d->formatted) {
+                        d->formatted_width = width;
+                        d->formatted_height = height;
+                }
+        }
 
         if (d->maximum_width != SIZE_MAX && width > d->maximum_width)
                 width = d->maximum_width;
@@ -2549,7 +2567,10 @@ int table_print(Table *t, FILE *f) {
                                 if (extracted)
                                         field = extracted;
 
-                                l = utf8_console_width(field);
+                                if (field == d->formatted && d->formatted_height == 1)
+                                        l = d->formatted_width;
+                                else
+                                        l = utf8_console_width(field);
                                 if (l > width[j]) {
                                         /* Field is wider than allocated space. Let's ellipsize */
 
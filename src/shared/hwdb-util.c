@@ -76,16 +76,30 @@ static int trie_children_cmp(const struct trie_child_entry *a, const struct trie
 }
 
 static int node_add_child(struct trie *trie, struct trie_node *node, struct trie_node *node_child, uint8_t c) {
-        /* extend array, add new entry, sort for bisection */
+        size_t a = 0, b;
+
+        /* extend array, insert new entry at its sorted position for bisection */
         if (!GREEDY_REALLOC(node->children, node->children_count + 1))
                 return -ENOMEM;
 
-        trie->children_count++;
-        node->children[node->children_count++] = (struct trie_child_entry) {
+        b = node->children_count;
+        while (a < b) {
+                size_t m = a + (b - a) / 2;
+
+                if (node->children[m].c < c)
+                        a = m + 1;
+                else
+                        b = m;
+        }
+
+        memmove(node->children + a + 1, node->children + a, (node->children_count - a) * sizeof(struct trie_child_entry));
+        node->children[a] = (struct trie_child_entry) {
                 .c = c,
                 .child = node_child,
         };
-        typesafe_qsort(node->children, node->children_count, trie_children_cmp);
+        node->children_count++;
+
+        trie->children_count++;
         trie->nodes_count++;
 
         return 0;
@@ -124,15 +138,11 @@ static struct trie* trie_free(struct trie *trie) {
 
 DEFINE_TRIVIAL_CLEANUP_FUNC(struct trie*, trie_free);
 
-static int trie_values_cmp(const struct trie_value_entry *a, const struct trie_value_entry *b, struct trie *trie) {
-        return strcmp(trie->strings->buf + a->key_off,
-                      trie->strings->buf + b->key_off);
-}
-
 static int trie_node_add_value(struct trie *trie, struct trie_node *node,
                                const char *key, const char *value,
                                const char *filename, uint16_t file_priority, uint32_t line_number, bool compat) {
         ssize_t k, v, fn = 0;
+        size_t a = 0, b;
 
         k = strbuf_add_string(trie->strings, key);
         if (k < 0)
@@ -147,14 +157,15 @@ static int trie_node_add_value(struct trie *trie, struct trie_node *node,
                         return fn;
         }
 
-        if (node->values_count) {
-                struct trie_value_entry search = {
-                        .key_off = k,
-                        .value_off = v,
-                }, *val;
+        /* The values are kept sorted by key, look for the key or the position to insert it at */
+        b = node->values_count;
+        while (a < b) {
+                size_t m = a + (b - a) / 2;
+                struct trie_value_entry *val = node->values + m;
+                int d;
 
-                val = typesafe_bsearch_r(&search, node->values, node->values_count, trie_values_cmp, trie);
-                if (val) {
+                d = strcmp(trie->strings->buf + val->key_off, key);
+                if (d == 0) {
                         /* At this point we have 2 identical properties on the same match-string.
                          * Since we process files in order, we just replace the previous value. */
                         val->value_off = v;
@@ -163,21 +174,27 @@ static int trie_node_add_value(struct trie *trie, struct trie_node *node,
                         val->line_number = line_number;
                         return 0;
                 }
+                if (d < 0)
+                        a = m + 1;
+                else
+                        b = m;
         }
 
-        /* extend array, add new entry, sort for bisection */
+        /* extend array, insert new entry at its sorted position for bisection */
         if (!GREEDY_REALLOC(node->values, node->values_count + 1))
                 return -ENOMEM;
 
-        trie->values_count++;
-        node->values[node->values_count++] = (struct trie_value_entry) {
+        memmove(node->values + a + 1, node->values + a, (node->values_count - a) * sizeof(struct trie_value_entry));
+        node->values[a] = (struct trie_value_entry) {
                 .key_off = k,
                 .value_off = v,
                 .filename_off = fn,
                 .file_priority = file_priority,
                 .line_number = line_number,
         };
-        typesafe_qsort_r(node->values, node->values_count, trie_values_cmp, trie);
+        node->values_count++;
+
+        trie->values_count++;
         return 0;
 }
 
@@ -3671,6 +3671,7 @@ int unit_file_preset_all(
         _cleanup_(install_context_done) InstallContext plus = {}, minus = {};
         _cleanup_(lookup_paths_done) LookupPaths lp = {};
         _cleanup_(unit_file_presets_done) UnitFilePresets presets = {};
+        _cleanup_set_free_ Set *seen = NULL;
         const char *config_path = NULL;
         int r;
 
@@ -3710,6 +3711,14 @@ int unit_file_preset_all(
                         if (!IN_SET(de->d_type, DT_LNK, DT_REG))
                                 continue;
 
+                        /* Units are resolved through the whole search path, hence a name that shows up in
+                         * more than one directory gives the same result each time. Only process it once. */
+                        k = set_put_strdup(&seen, de->d_name);
+                        if (k < 0)
+                                return k;
+                        if (k == 0)
+                                continue;
+
                         k = preset_prepare_one(scope, &plus, &minus, &lp, de->d_name, &presets, changes, n_changes);
                         if (k < 0 &&
                             !IN_SET(k, -EEXIST,
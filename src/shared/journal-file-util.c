@@ -180,6 +180,13 @@ static void journal_file_set_offline_internal(JournalFile *f) {
 
                 case OFFLINE_SYNCING:
                         if (f->archive) {
+                                /* Nothing is going to be appended anymore, hence add a filter over all DATA
+                                 * objects, so that readers can quickly tell whether looking for a specific
+                                 * field is worth it. */
+                                r = journal_file_append_data_bloom_filter(f);
+                                if (r < 0 && r != -EOPNOTSUPP)
+                                        log_debug_errno(r, "Failed to append data bloom filter to %s, ignoring: %m", f->path);
+
                                 (void) journal_file_end_punch_hole(f);
                                 (void) journal_file_punch_holes(f);
                         }
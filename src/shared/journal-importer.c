@@ -228,6 +228,11 @@ static int process_special_field(JournalImporter *imp, char *line) {
 
         assert(line);
 
+        /* All fields handled below start with an underscore, so let's quickly skip the common case of
+         * regular fields such as MESSAGE= or PRIORITY=, which make up most of the stream. */
+        if (line[0] != '_')
+                return 0;
+
         if (STARTSWITH_SET(line, "__CURSOR=", "__SEQNUM=", "__SEQNUM_ID="))
                 /* ignore __CURSOR=, __SEQNUM=, __SEQNUM_ID= which we cannot replicate */
                 return 1;
@@ -1040,15 +1040,25 @@ void json_escape(
                 fputc('"', f);
 
                 while (l > 0) {
+                        size_t k;
+
+                        /* Copy runs of characters that need no escaping with a single fwrite() */
+                        for (k = 0; k < l && !IN_SET(p[k], '"', '\\') && (uint8_t) p[k] >= ' '; k++)
+                                ;
+                        if (k > 0) {
+                                fwrite(p, 1, k, f);
+                                p += k;
+                                l -= k;
+                                continue;
+                        }
+
                         if (IN_SET(*p, '"', '\\')) {
                                 fputc('\\', f);
                                 fputc(*p, f);
                         } else if (*p == '\n')
                                 fputs("\\n", f);
-                        else if ((uint8_t) *p < ' ')
-                                fprintf(f, "\\u%04x", (uint8_t) *p);
                         else
-                                fputc(*p, f);
+                                fprintf(f, "\\u%04x", (uint8_t) *p);
 
                         p++;
                         l--;
@@ -14,6 +14,7 @@ DLSYM_PROTOTYPE(pcre2_compile) = NULL;
 DLSYM_PROTOTYPE(pcre2_get_error_message) = NULL;
 DLSYM_PROTOTYPE(pcre2_match) = NULL;
 DLSYM_PROTOTYPE(pcre2_get_ovector_pointer) = NULL;
+DLSYM_PROTOTYPE(pcre2_jit_compile) = NULL;
 
 DEFINE_HASH_OPS_WITH_KEY_DESTRUCTOR(
         pcre2_code_hash_ops_free,
@@ -48,7 +49,8 @@ int dlopen_pcre2(void) {
                         DLSYM_ARG(pcre2_compile),
                         DLSYM_ARG(pcre2_get_error_message),
                         DLSYM_ARG(pcre2_match),
-                        DLSYM_ARG(pcre2_get_ovector_pointer));
+                        DLSYM_ARG(pcre2_get_ovector_pointer),
+                        DLSYM_ARG(pcre2_jit_compile));
 #else
         return log_error_errno(SYNTHETIC_ERRNO(EOPNOTSUPP), "PCRE2 support is not compiled in.");
 #endif
@@ -104,6 +106,14 @@ int pattern_compile_and_log(const char *pattern, PatternCompileCase case_, pcre2
                                        r < 0 ? "unknown error" : (char *)buf);
         }
 
+        /* Patterns are typically matched against a lot of log messages, hence let's JIT compile them.
+         * pcre2_match() automatically makes use of the JIT code if there is any. This fails if libpcre2 was
+         * built without JIT support or if we are not allowed to map executable memory, in which case we
+         * simply continue with the interpreter. */
+        r = sym_pcre2_jit_compile(p, PCRE2_JIT_COMPLETE);
+        if (r < 0)
+                log_debug("JIT compilation of pattern \"%s\" failed (%i), continuing without.", pattern, r);
+
         if (ret)
                 *ret = TAKE_PTR(p);
 
@@ -135,6 +145,18 @@ int pattern_matches_and_log(pcre2_code *compiled_pattern, const char *message, s
                             0,      /* default options */
                             md,
                             NULL);
+        if (r == PCRE2_ERROR_JIT_STACKLIMIT) {
+                /* JIT code runs on a small default stack that deeply backtracking patterns can exhaust.
+                 * The interpreter doesn't have that limitation, hence try again with that. */
+                log_debug("JIT stack exhausted while matching pattern, retrying without JIT.");
+                r = sym_pcre2_match(compiled_pattern,
+                                    (const unsigned char *)message,
+                                    size,
+                                    0,
+                                    PCRE2_NO_JIT,
+                                    md,
+                                    NULL);
+        }
         if (r == PCRE2_ERROR_NOMATCH)
                 return false;
         if (r < 0) {
@@ -18,6 +18,7 @@ extern DLSYM_PROTOTYPE(pcre2_compile);
 extern DLSYM_PROTOTYPE(pcre2_get_error_message);
 extern DLSYM_PROTOTYPE(pcre2_match);
 extern DLSYM_PROTOTYPE(pcre2_get_ovector_pointer);
+extern DLSYM_PROTOTYPE(pcre2_jit_compile);
 
 DEFINE_TRIVIAL_CLEANUP_FUNC_FULL(pcre2_match_data*, sym_pcre2_match_data_free, NULL);
 DEFINE_TRIVIAL_CLEANUP_FUNC_FULL(pcre2_code*, sym_pcre2_code_free, NULL);
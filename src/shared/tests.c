@@ -23,6 +23,7 @@
 #include "log.h"
 #include "mountpoint-util.h"
 #include "namespace-util.h"
+#include "parse-util.h"
 #include "path-util.h"
 #include "process-util.h"
 #include "random-util.h"
@@ -120,6 +121,34 @@ void test_setup_logging(int level) {
         log_setup();
 }
 
+usec_t benchmark_duration(int argc, char *argv[]) {
+        unsigned x;
+
+        if (argc < 2)
+                return slow_tests_enabled() ? USEC_PER_SEC : USEC_PER_SEC / 100;
+
+        assert_se(safe_atou(argv[1], &x) >= 0);
+        return x * USEC_PER_SEC;
+}
+
+void benchmark_run(const char *name, usec_t duration, benchmark_func_t func, void *userdata) {
+        usec_t start, t;
+        uint64_t n = 0;
+        unsigned batch = 0;
+
+        assert(name);
+        assert(func);
+
+        start = now(CLOCK_MONOTONIC);
+        do {
+                n += func(batch++, userdata);
+                t = now(CLOCK_MONOTONIC) - start;
+        } while (t < duration);
+
+        assert_se(n > 0);
+        log_info("benchmark %s %" PRIu64 " %.1f", name, n, (double) t * NSEC_PER_USEC / n);
+}
+
 int write_tmpfile(char *pattern, const char *contents) {
         _cleanup_close_ int fd = -EBADF;
 
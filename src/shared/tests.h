@@ -15,6 +15,7 @@
 #include "signal-util.h"
 #include "static-destruct.h"
 #include "strv.h"
+#include "time-util.h"
 
 static inline void log_set_assert_return_is_criticalp(bool *p) {
         log_set_assert_return_is_critical(*p);
@@ -56,6 +57,17 @@ const char* get_catalog_dir(void);
 bool slow_tests_enabled(void);
 void test_setup_logging(int level);
 
+/* Time-bounded micro benchmarks. Each benchmark calls the function with an increasing batch counter until the
+ * duration elapsed, and reports one line in the format
+ *
+ *     benchmark <name> <operations> <ns/op>
+ *
+ * so that the output can be compared between builds with simple scripts. The duration is taken from the
+ * first command line argument in seconds, and defaults to 1s with slow tests enabled and 10ms otherwise. */
+typedef uint64_t (*benchmark_func_t)(unsigned batch, void *userdata); /* returns the number of operations done */
+usec_t benchmark_duration(int argc, char *argv[]);
+void benchmark_run(const char *name, usec_t duration, benchmark_func_t func, void *userdata);
+
 #define log_tests_skipped(fmt, ...)                                     \
         ({                                                              \
                 log_notice("%s: " fmt ", skipping tests.",              \
@@ -68,6 +68,8 @@ static SD_VARLINK_DEFINE_STRUCT_TYPE(
                 SD_VARLINK_DEFINE_FIELD(ReceivedUDPFragmentMax, SD_VARLINK_INT, 0),
                 SD_VARLINK_DEFINE_FIELD(FailedUDPAttempts, SD_VARLINK_INT, 0),
                 SD_VARLINK_DEFINE_FIELD(FailedTCPAttempts, SD_VARLINK_INT, 0),
+                SD_VARLINK_DEFINE_FIELD(RTTUSec, SD_VARLINK_INT, SD_VARLINK_NULLABLE),
+                SD_VARLINK_DEFINE_FIELD(RTTVarianceUSec, SD_VARLINK_INT, SD_VARLINK_NULLABLE),
                 SD_VARLINK_DEFINE_FIELD(PacketTruncated, SD_VARLINK_BOOL, 0),
                 SD_VARLINK_DEFINE_FIELD(PacketBadOpt, SD_VARLINK_BOOL, 0),
                 SD_VARLINK_DEFINE_FIELD(PacketRRSIGMissing, SD_VARLINK_BOOL, 0),
@@ -92,7 +94,8 @@ static SD_VARLINK_DEFINE_STRUCT_TYPE(
                 CacheStatistics,
                 SD_VARLINK_DEFINE_FIELD(size, SD_VARLINK_INT, 0),
                 SD_VARLINK_DEFINE_FIELD(hits, SD_VARLINK_INT, 0),
-                SD_VARLINK_DEFINE_FIELD(misses, SD_VARLINK_INT, 0));
+                SD_VARLINK_DEFINE_FIELD(misses, SD_VARLINK_INT, 0),
+                SD_VARLINK_DEFINE_FIELD(prefetches, SD_VARLINK_INT, 0));
 
 static SD_VARLINK_DEFINE_STRUCT_TYPE(
                 DnssecStatistics,
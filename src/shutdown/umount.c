@@ -26,6 +26,7 @@
 #include "process-util.h"
 #include "random-util.h"
 #include "signal-util.h"
+#include "string-util.h"
 #include "umount.h"
 #include "virt.h"
 
@@ -47,6 +48,36 @@ void mount_points_list_free(MountPoint **head) {
                 mount_point_free(head, *head);
 }
 
+static int mount_point_below_network_fs(struct libmnt_table *table, struct libmnt_fs *fs) {
+        int r;
+
+        assert(table);
+        assert(fs);
+
+        /* Checks whether any of the mounts the specified mount is stacked on is a network or FUSE file
+         * system, i.e. whether path lookups to reach the mount point might hang. Bounded by the number of
+         * entries in the table, in case the parent relationship is looped somehow. */
+
+        for (int i = 0, n = mnt_table_get_nents(table); i < n; i++) {
+                struct libmnt_fs *parent;
+                const char *fstype;
+
+                r = mnt_table_get_parent_fs(table, fs, &parent);
+                if (r < 0)
+                        return r;
+                if (r > 0 || !parent || parent == fs) /* reached the root */
+                        return false;
+
+                fstype = mnt_fs_get_fstype(parent);
+                if (!fstype || fstype_is_network(fstype) || startswith(fstype, "fuse"))
+                        return true;
+
+                fs = parent;
+        }
+
+        return true;
+}
+
 int mount_points_list_get(const char *mountinfo, MountPoint **head) {
         _cleanup_(mnt_free_tablep) struct libmnt_table *table = NULL;
         _cleanup_(mnt_free_iterp) struct libmnt_iter *iter = NULL;
@@ -144,6 +175,14 @@ int mount_points_list_get(const char *mountinfo, MountPoint **head) {
                         return log_error_errno(r, "Failed to get children mounts for %s from %s: %m", path, mountinfo ?: "/proc/self/mountinfo");
                 bool leaf = r;
 
+                bool below_network_fs = false;
+                if (is_api_vfs) {
+                        r = mount_point_below_network_fs(table, fs);
+                        if (r < 0)
+                                log_debug_errno(r, "Failed to check whether %s is below a network file system, assuming it is: %m", path);
+                        below_network_fs = r != 0;
+                }
+
                 *m = (MountPoint) {
                         .remount_options = remount_options,
                         .remount_flags = remount_flags,
@@ -152,6 +191,9 @@ int mount_points_list_get(const char *mountinfo, MountPoint **head) {
                         /* Unmount sysfs/procfs/… lazily, since syncing doesn't matter there, and it's OK if
                          * something keeps an fd open to it. */
                         .umount_lazily = is_api_vfs,
+                        /* A lazy unmount only detaches the mount and never waits for the file system, hence
+                         * it can only hang on the path lookup, i.e. if a network file system is involved. */
+                        .umount_directly = is_api_vfs && !below_network_fs,
                         .leaf = leaf,
                 };
 
@@ -296,15 +338,43 @@ static int remount_with_timeout(MountPoint *m, bool last_try) {
         return r;
 }
 
+static int umount_one(MountPoint *m, bool last_try) {
+        int r;
+
+        assert(m);
+
+        log_info("Unmounting '%s'.", m->path);
+
+        /* Using MNT_FORCE causes some filesystems (e.g. FUSE and NFS and other network filesystems) to abort
+         * any pending requests and return -EIO rather than blocking indefinitely. If the filesysten is
+         * "busy", this may allow processes to die, thus making the filesystem less busy so the unmount might
+         * succeed (rather than return EBUSY). */
+        r = RET_NERRNO(umount2(m->path,
+                               UMOUNT_NOFOLLOW | /* Don't follow symlinks: this should never happen unless our mount list was wrong */
+                               (m->umount_lazily ? MNT_DETACH : MNT_FORCE)));
+        if (r < 0) {
+                log_full_errno(last_try ? LOG_ERR : LOG_INFO, r, "Failed to unmount %s: %m", m->path);
+
+                if (r == -EBUSY && last_try)
+                        log_umount_blockers(m->path);
+        }
+
+        return r;
+}
+
 static int umount_with_timeout(MountPoint *m, bool last_try) {
         _cleanup_close_pair_ int pfd[2] = EBADF_PAIR;
         _cleanup_(sigkill_nowaitp) pid_t pid = 0;
         int r;
 
-        BLOCK_SIGNALS(SIGCHLD);
-
         assert(m);
 
+        /* No need to fork off a child with a timeout for this one, see mount_points_list_get(). */
+        if (m->umount_directly)
+                return umount_one(m, last_try);
+
+        BLOCK_SIGNALS(SIGCHLD);
+
         r = pipe2(pfd, O_CLOEXEC|O_NONBLOCK);
         if (r < 0)
                 return r;
@@ -320,22 +390,7 @@ static int umount_with_timeout(MountPoint *m, bool last_try) {
         if (r == 0) {
                 pfd[0] = safe_close(pfd[0]);
 
-                log_info("Unmounting '%s'.", m->path);
-
-                /* Start the mount operation here in the child Using MNT_FORCE causes some filesystems
-                 * (e.g. FUSE and NFS and other network filesystems) to abort any pending requests and return
-                 * -EIO rather than blocking indefinitely. If the filesysten is "busy", this may allow
-                 * processes to die, thus making the filesystem less busy so the unmount might succeed
-                 * (rather than return EBUSY). */
-                r = RET_NERRNO(umount2(m->path,
-                                       UMOUNT_NOFOLLOW | /* Don't follow symlinks: this should never happen unless our mount list was wrong */
-                                       (m->umount_lazily ? MNT_DETACH : MNT_FORCE)));
-                if (r < 0) {
-                        log_full_errno(last_try ? LOG_ERR : LOG_INFO, r, "Failed to unmount %s: %m", m->path);
-
-                        if (r == -EBUSY && last_try)
-                                log_umount_blockers(m->path);
-                }
+                r = umount_one(m, last_try);
 
                 (void) write(pfd[1], &r, sizeof(r)); /* try to send errno up */
                 _exit(r < 0 ? EXIT_FAILURE : EXIT_SUCCESS);
@@ -18,6 +18,7 @@ typedef struct MountPoint {
         unsigned long remount_flags;
         bool try_remount_ro;
         bool umount_lazily;
+        bool umount_directly;
         bool leaf;
         LIST_FIELDS(struct MountPoint, mount_point);
 } MountPoint;
@@ -0,0 +1,197 @@
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+
+#include "sd-json.h"
+
+#include "alloc-util.h"
+#include "extract-word.h"
+#include "hashmap.h"
+#include "in-addr-util.h"
+#include "path-util.h"
+#include "prioq.h"
+#include "random-util.h"
+#include "set.h"
+#include "siphash24.h"
+#include "string-util.h"
+#include "strv.h"
+#include "tests.h"
+#include "time-util.h"
+
+/* Simple time-bounded micro benchmarks for frequently used primitives, see benchmark_run() for the output
+ * format. */
+
+#define BATCH 1000U
+#define N_KEYS 4096U
+
+static char **unit_names = NULL;
+
+static int compare_unsigned(const void *a, const void *b) {
+        return CMP(PTR_TO_UINT(a), PTR_TO_UINT(b));
+}
+
+static uint64_t bench_hashmap_ptr(unsigned batch, void *userdata) {
+        _cleanup_hashmap_free_ Hashmap *h = NULL;
+
+        assert_se(h = hashmap_new(NULL));
+        for (unsigned i = 1; i <= BATCH; i++)
+                assert_se(hashmap_put(h, UINT_TO_PTR(i * 64), UINT_TO_PTR(i)) == 1);
+        for (unsigned i = 1; i <= BATCH; i++)
+                assert_se(hashmap_get(h, UINT_TO_PTR(i * 64)) == UINT_TO_PTR(i));
+
+        return BATCH;
+}
+
+static uint64_t bench_hashmap_string(unsigned batch, void *userdata) {
+        _cleanup_hashmap_free_ Hashmap *h = NULL;
+        unsigned offset = (batch * BATCH) % (N_KEYS - BATCH);
+
+        assert_se(h = hashmap_new(&string_hash_ops));
+        for (unsigned i = 0; i < BATCH; i++)
+                assert_se(hashmap_put(h, unit_names[offset + i], UINT_TO_PTR(i + 1)) == 1);
+        for (unsigned i = 0; i < BATCH; i++)
+                assert_se(hashmap_get(h, unit_names[offset + i]) == UINT_TO_PTR(i + 1));
+
+        return BATCH;
+}
+
+static uint64_t bench_set_string(unsigned batch, void *userdata) {
+        _cleanup_set_free_ Set *s = NULL;
+        unsigned offset = (batch * BATCH) % (N_KEYS - BATCH);
+
+        for (unsigned i = 0; i < BATCH; i++)
+                assert_se(set_ensure_put(&s, &string_hash_ops, unit_names[offset + i]) == 1);
+        for (unsigned i = 0; i < BATCH; i++)
+                assert_se(set_contains(s, unit_names[offset + i]));
+
+        return BATCH;
+}
+
+static uint64_t bench_siphash24(unsigned batch, void *userdata) {
+        static const uint8_t key[16] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 };
+        uint64_t h = 0;
+
+        for (unsigned i = 0; i < BATCH; i++) {
+                const char *s = unit_names[i % N_KEYS];
+
+                h ^= siphash24(s, strlen(s), key);
+        }
+
+        assert_se(h != 1);
+
+        return BATCH;
+}
+
+static uint64_t bench_prioq(unsigned batch, void *userdata) {
+        _cleanup_(prioq_freep) Prioq *q = NULL;
+        unsigned prev = 0;
+
+        assert_se(q = prioq_new(compare_unsigned));
+        for (unsigned i = 0; i < BATCH; i++)
+                assert_se(prioq_put(q, UINT_TO_PTR(random_u64_range(UINT_MAX - 1) + 1), NULL) >= 0);
+        for (unsigned i = 0; i < BATCH; i++) {
+                unsigned v = PTR_TO_UINT(prioq_pop(q));
+
+                assert_se(v >= prev);
+                prev = v;
+        }
+
+        return BATCH;
+}
+
+static uint64_t bench_strv(unsigned batch, void *userdata) {
+        _cleanup_strv_free_ char **l = NULL;
+        _cleanup_free_ char *j = NULL;
+
+        for (unsigned i = 0; i < BATCH; i++)
+                assert_se(strv_extend(&l, unit_names[i]) >= 0);
+
+        assert_se(j = strv_join(l, " "));
+
+        return BATCH;
+}
+
+static uint64_t bench_extract_first_word(unsigned batch, void *userdata) {
+        unsigned n = 0;
+
+        for (unsigned i = 0; i < BATCH / 8; i++) {
+                const char *p = "/usr/bin/foo --bar 'baz quux' \"x y\" -- \\\"escaped\\\" a b c";
+
+                for (;;) {
+                        _cleanup_free_ char *w = NULL;
+                        int r;
+
+                        r = extract_first_word(&p, &w, NULL, EXTRACT_UNQUOTE|EXTRACT_CUNESCAPE);
+                        assert_se(r >= 0);
+                        if (r == 0)
+                                break;
+                        n++;
+                }
+        }
+
+        return n; /* one operation per extracted word */
+}
+
+static uint64_t bench_in_addr_to_string(unsigned batch, void *userdata) {
+        union in_addr_union a = {
+                .in6.s6_addr = { 0x20, 0x01, 0x0d, 0xb8, [15] = 1 },
+        };
+
+        for (unsigned i = 0; i < BATCH; i++) {
+                _cleanup_free_ char *s = NULL;
+
+                a.in6.s6_addr[14] = (uint8_t) i;
+                assert_se(in_addr_to_string(AF_INET6, &a, &s) >= 0);
+        }
+
+        return BATCH;
+}
+
+static uint64_t bench_path_simplify(unsigned batch, void *userdata) {
+        for (unsigned i = 0; i < BATCH; i++) {
+                char p[] = "/usr/./lib//systemd/../systemd///system/./foo.service/";
+
+                assert_se(path_simplify(p));
+        }
+
+        return BATCH;
+}
+
+static uint64_t bench_json(unsigned batch, void *userdata) {
+        static const char text[] =
+                "{\"Name\":\"foo.service\",\"Active\":true,\"PID\":4711,"
+                "\"Addresses\":[\"192.168.0.1\",\"fe80::1\"],\"Limits\":{\"NOFILE\":1024,\"CORE\":null}}";
+
+        for (unsigned i = 0; i < BATCH / 8; i++) {
+                _cleanup_(sd_json_variant_unrefp) sd_json_variant *v = NULL;
+                _cleanup_free_ char *s = NULL;
+
+                assert_se(sd_json_parse(text, 0, &v, NULL, NULL) >= 0);
+                assert_se(sd_json_variant_format(v, 0, &s) >= 0);
+        }
+
+        return BATCH / 8; /* one operation per parse + format round trip */
+}
+
+int main(int argc, char *argv[]) {
+        usec_t duration;
+
+        test_setup_logging(LOG_INFO);
+
+        duration = benchmark_duration(argc, argv);
+
+        for (unsigned i = 0; i < N_KEYS; i++)
+                assert_se(strv_extendf(&unit_names, "systemd-foo-%u@instance-%u.service", i, i * 7) >= 0);
+
+        benchmark_run("hashmap-ptr-put-get", duration, bench_hashmap_ptr, NULL);
+        benchmark_run("hashmap-string-put-get", duration, bench_hashmap_string, NULL);
+        benchmark_run("set-string-put-contains", duration, bench_set_string, NULL);
+        benchmark_run("siphash24", duration, bench_siphash24, NULL);
+        benchmark_run("prioq-put-pop", duration, bench_prioq, NULL);
+        benchmark_run("strv-extend-join", duration, bench_strv, NULL);
+        benchmark_run("extract-first-word", duration, bench_extract_first_word, NULL);
+        benchmark_run("in-addr-to-string", duration, bench_in_addr_to_string, NULL);
+        benchmark_run("path-simplify", duration, bench_path_simplify, NULL);
+        benchmark_run("json-parse-format", duration, bench_json, NULL);
+
+        unit_names = strv_free(unit_names);
+        return 0;
+}
@@ -221,6 +221,16 @@ TEST(calendar_spec_next) {
         test_next("Sun *-*-* 01:00:00 Europe/Dublin", "IST", 1616412478000000, 1617494400000000);
 }
 
+TEST(calendar_spec_next_local_timezone) {
+        /* A spec carrying the local timezone explicitly is evaluated in-process, make sure it yields the
+         * same results as evaluating it in a child with the timezone switched. */
+        test_next("2016-03-27 03:17:00 Europe/Berlin", "Europe/Berlin", 12345, 1459041420000000);
+        test_next("2016-03-27 03:17:00 Europe/Kyiv", "Europe/Kyiv", 12345, -1);
+        test_next("2017-09-24 03:30:00 Pacific/Auckland", "Pacific/Auckland", 12345, 1506177000000000);
+        test_next("2017-04-02 02:30:00 Pacific/Auckland", "Pacific/Auckland", 1491053400000000, -1);
+        test_next("Sun *-*-* 01:00:00 Europe/Dublin", "Europe/Dublin", 1616412478000000, 1617494400000000);
+}
+
 TEST(calendar_spec_from_string) {
         CalendarSpec *c;
 
@@ -41,6 +41,25 @@ TEST(trivial_compare_func) {
         assert_se(trivial_compare_func(INT_TO_PTR('b'), INT_TO_PTR('a')) == 1);
 }
 
+TEST(trivial_hash_ops_many) {
+        _cleanup_hashmap_free_ Hashmap *m = NULL;
+
+        /* Pointer keyed maps use a dedicated mixer, make sure aligned and sequential keys survive
+         * resizing. */
+        assert_se(m = hashmap_new(NULL));
+        for (unsigned i = 1; i <= 10000; i++)
+                assert_se(hashmap_put(m, UINT_TO_PTR(i * 16), UINT_TO_PTR(i)) == 1);
+        assert_se(hashmap_size(m) == 10000);
+        for (unsigned i = 1; i <= 10000; i++)
+                assert_se(hashmap_get(m, UINT_TO_PTR(i * 16)) == UINT_TO_PTR(i));
+        assert_se(!hashmap_get(m, UINT_TO_PTR(8)));
+        for (unsigned i = 1; i <= 10000; i += 2)
+                assert_se(hashmap_remove(m, UINT_TO_PTR(i * 16)) == UINT_TO_PTR(i));
+        for (unsigned i = 2; i <= 10000; i += 2)
+                assert_se(hashmap_get(m, UINT_TO_PTR(i * 16)) == UINT_TO_PTR(i));
+        assert_se(hashmap_size(m) == 5000);
+}
+
 TEST(string_compare_func) {
         ASSERT_NE(string_compare_func("fred", "wilma"), 0);
         assert_se(string_compare_func("fred", "fred") == 0);
@@ -751,6 +751,12 @@ TEST(tokenizer) {
         test_tokenizer_one("\"\\ud800a\"", -EINVAL);
         test_tokenizer_one("\"\\udc00\\udc00\"", -EINVAL);
         test_tokenizer_one("\"\\ud801\\udc37\"", JSON_TOKEN_STRING, "\xf0\x90\x90\xb7", JSON_TOKEN_END);
+        test_tokenizer_one("\"foo\xef\xbf\xbd" "bar\\tbaz\\\"\"", JSON_TOKEN_STRING, "foo\xef\xbf\xbd" "bar\tbaz\"", JSON_TOKEN_END);
+        test_tokenizer_one("\"foo\xff" "bar\"", -EINVAL);
+        test_tokenizer_one("\"foo\xef\xbf" "bar\"", -EINVAL);
+        test_tokenizer_one("\"foo\tbar\"", -EINVAL);
+        test_tokenizer_one("\"foo\x7f\"", -EINVAL);
+        test_tokenizer_one("\"foo", -EINVAL);
 
         test_tokenizer_one("[1, 2, -3]", JSON_TOKEN_ARRAY_OPEN, JSON_TOKEN_UNSIGNED, (uint64_t) 1, JSON_TOKEN_COMMA, JSON_TOKEN_UNSIGNED, (uint64_t) 2, JSON_TOKEN_COMMA, JSON_TOKEN_INTEGER, (int64_t) -3, JSON_TOKEN_ARRAY_CLOSE, JSON_TOKEN_END);
 }
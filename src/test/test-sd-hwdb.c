@@ -7,6 +7,7 @@
 #include "errno.h"
 #include "hwdb-internal.h"
 #include "nulstr-util.h"
+#include "string-util.h"
 #include "tests.h"
 
 TEST(failed_enumerate) {
@@ -54,6 +55,33 @@ TEST(basic_enumerate) {
         assert_se(len1 == len2);
 }
 
+TEST(repeated_get) {
+        _cleanup_(sd_hwdb_unrefp) sd_hwdb *hwdb = NULL;
+        const char *key, *value, *v;
+        int r;
+
+        assert_se(sd_hwdb_new(&hwdb) == 0);
+
+        assert_se(sd_hwdb_seek(hwdb, DELL_MODALIAS) == 0);
+        r = sd_hwdb_enumerate(hwdb, &key, &value);
+        assert_se(r >= 0);
+        if (r == 0)
+                return (void) log_tests_skipped("no properties for test modalias");
+
+        /* Lookups for the same modalias must neither change the result nor invalidate the enumeration */
+        assert_se(sd_hwdb_get(hwdb, DELL_MODALIAS, key, &v) == 0);
+        assert_se(streq(v, value));
+        assert_se(sd_hwdb_enumerate(hwdb, &key, &value) >= 0);
+
+        assert_se(sd_hwdb_get(hwdb, "no-such-modalias-should-exist", key, &v) == -ENOENT);
+        assert_se(sd_hwdb_enumerate(hwdb, &key, &value) == -EAGAIN);
+
+        assert_se(sd_hwdb_seek(hwdb, DELL_MODALIAS) == 0);
+        assert_se(sd_hwdb_enumerate(hwdb, &key, &value) == 1);
+        assert_se(sd_hwdb_get(hwdb, DELL_MODALIAS, key, &v) == 0);
+        assert_se(streq(v, value));
+}
+
 TEST(sd_hwdb_new_from_path) {
         _cleanup_(sd_hwdb_unrefp) sd_hwdb *hwdb = NULL;
         int r;
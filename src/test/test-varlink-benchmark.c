@@ -0,0 +1,128 @@
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+
+#include <pthread.h>
+
+#include "sd-event.h"
+#include "sd-json.h"
+#include "sd-varlink.h"
+
+#include "rm-rf.h"
+#include "string-util.h"
+#include "strv.h"
+#include "tests.h"
+#include "time-util.h"
+#include "tmpfile-util.h"
+
+/* Time-bounded Varlink round trip benchmarks, see benchmark_run() for the output format. A server runs on its
+ * own event loop in a separate thread, and the main thread issues synchronous calls against it. */
+
+#define BATCH 64U
+#define N_STREAM 100U
+
+static sd_varlink *client = NULL;
+static sd_json_variant *small = NULL, *large = NULL;
+
+static int method_echo(sd_varlink *link, sd_json_variant *parameters, sd_varlink_method_flags_t flags, void *userdata) {
+        return sd_varlink_reply(link, parameters);
+}
+
+static int method_stream(sd_varlink *link, sd_json_variant *parameters, sd_varlink_method_flags_t flags, void *userdata) {
+        int r;
+
+        for (unsigned i = 0; i < N_STREAM - 1; i++) {
+                r = sd_varlink_notifybo(link, SD_JSON_BUILD_PAIR_UNSIGNED("index", i));
+                if (r < 0)
+                        return r;
+        }
+
+        return sd_varlink_replybo(link, SD_JSON_BUILD_PAIR_UNSIGNED("index", N_STREAM - 1));
+}
+
+static void on_disconnect(sd_varlink_server *s, sd_varlink *link, void *userdata) {
+        /* We only have a single client, stop the server thread once it is gone */
+        assert_se(sd_event_exit(sd_varlink_server_get_event(s), 0) >= 0);
+}
+
+static void *server_thread(void *arg) {
+        sd_event *e = ASSERT_PTR(arg);
+
+        assert_se(sd_event_loop(e) >= 0);
+        return NULL;
+}
+
+static uint64_t bench_call(unsigned batch, void *userdata) {
+        sd_json_variant *parameters = ASSERT_PTR(userdata);
+
+        for (unsigned i = 0; i < BATCH; i++) {
+                sd_json_variant *reply = NULL;
+                const char *error_id = NULL;
+
+                assert_se(sd_varlink_call(client, "io.test.Echo", parameters, &reply, &error_id) >= 0);
+                assert_se(!error_id);
+                assert_se(sd_json_variant_equal(reply, parameters));
+        }
+
+        return BATCH;
+}
+
+static uint64_t bench_stream(unsigned batch, void *userdata) {
+        _cleanup_(sd_json_variant_unrefp) sd_json_variant *replies = NULL;
+        const char *error_id = NULL;
+
+        assert_se(sd_varlink_collect(client, "io.test.Stream", NULL, &replies, &error_id) >= 0);
+        assert_se(!error_id);
+        assert_se(sd_json_variant_elements(replies) == N_STREAM);
+
+        return N_STREAM; /* one operation per streamed reply */
+}
+
+int main(int argc, char *argv[]) {
+        _cleanup_(sd_varlink_server_unrefp) sd_varlink_server *s = NULL;
+        _cleanup_(rm_rf_physical_and_freep) char *tmpdir = NULL;
+        _cleanup_(sd_event_unrefp) sd_event *e = NULL;
+        _cleanup_strv_free_ char **strings = NULL;
+        pthread_t t;
+        const char *sp;
+        usec_t duration;
+
+        test_setup_logging(LOG_INFO);
+
+        duration = benchmark_duration(argc, argv);
+
+        assert_se(mkdtemp_malloc("/tmp/varlink-benchmark-XXXXXX", &tmpdir) >= 0);
+        sp = strjoina(tmpdir, "/socket");
+
+        assert_se(sd_event_new(&e) >= 0);
+        assert_se(sd_varlink_server_new(&s, 0) >= 0);
+        assert_se(sd_varlink_server_bind_method(s, "io.test.Echo", method_echo) >= 0);
+        assert_se(sd_varlink_server_bind_method(s, "io.test.Stream", method_stream) >= 0);
+        assert_se(sd_varlink_server_bind_disconnect(s, on_disconnect) >= 0);
+        assert_se(sd_varlink_server_listen_address(s, sp, 0600) >= 0);
+        assert_se(sd_varlink_server_attach_event(s, e, 0) >= 0);
+
+        assert_se(pthread_create(&t, NULL, server_thread, e) == 0);
+
+        assert_se(sd_varlink_connect_address(&client, sp) >= 0);
+
+        assert_se(sd_json_buildo(&small,
+                                 SD_JSON_BUILD_PAIR_STRING("name", "foo.service"),
+                                 SD_JSON_BUILD_PAIR_UNSIGNED("pid", 4711)) >= 0);
+
+        for (unsigned i = 0; i < 256; i++)
+                assert_se(strv_extendf(&strings, "/usr/lib/systemd/system/systemd-foo-%u@instance-%u.service", i, i * 7) >= 0);
+        assert_se(sd_json_buildo(&large,
+                                 SD_JSON_BUILD_PAIR_STRING("name", "foo.service"),
+                                 SD_JSON_BUILD_PAIR_STRV("paths", strings)) >= 0);
+
+        benchmark_run("varlink-call-small", duration, bench_call, small);
+        benchmark_run("varlink-call-large", duration, bench_call, large);
+        benchmark_run("varlink-more-stream", duration, bench_stream, NULL);
+
+        client = sd_varlink_flush_close_unref(client);
+        assert_se(pthread_join(t, NULL) == 0);
+
+        small = sd_json_variant_unref(small);
+        large = sd_json_variant_unref(large);
+
+        return 0;
+}
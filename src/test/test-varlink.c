@@ -442,4 +442,60 @@ TEST(invalid_parameter) {
         assert_se(sd_event_loop(e) >= 0);
 }
 
+static size_t count_nul(const char *p, size_t n) {
+        size_t c = 0;
+
+        for (const char *q = p; (q = memchr(q, 0, n - (q - p))); q++)
+                c++;
+
+        return c;
+}
+
+TEST(pipelining) {
+        _cleanup_(sd_varlink_server_unrefp) sd_varlink_server *s = NULL;
+        _cleanup_(sd_event_unrefp) sd_event *e = NULL;
+        _cleanup_close_pair_ int connfd[2] = EBADF_PAIR;
+        char buf[4096];
+        size_t n = 0;
+        const char *p;
+
+        assert_se(sd_event_new(&e) >= 0);
+        assert_se(sd_varlink_server_new(&s, 0) >= 0);
+        assert_se(sd_varlink_server_attach_event(s, e, 0) >= 0);
+        assert_se(sd_varlink_server_bind_method(s, "io.test.DoSomething", method_something) >= 0);
+
+        assert_se(socketpair(AF_UNIX, SOCK_STREAM|SOCK_NONBLOCK|SOCK_CLOEXEC, 0, connfd) >= 0);
+        assert_se(sd_varlink_server_add_connection(s, TAKE_FD(connfd[0]), /* ret= */ NULL) >= 0);
+
+        /* Send three requests in one go, without waiting for the replies in between */
+        static const char requests[] =
+                "{\"method\":\"io.test.DoSomething\",\"parameters\":{\"a\":1,\"b\":2}}\0"
+                "{\"method\":\"io.test.DoSomething\",\"parameters\":{\"a\":3,\"b\":4}}\0"
+                "{\"method\":\"io.test.DoSomething\",\"parameters\":{\"a\":5,\"b\":6}}";
+        assert_se(write(connfd[1], requests, sizeof(requests)) == (ssize_t) sizeof(requests));
+
+        /* All three replies must arrive, in order */
+        while (count_nul(buf, n) < 3) {
+                ssize_t k;
+
+                assert_se(sd_event_run(e, 100 * USEC_PER_MSEC) >= 0);
+
+                k = read(connfd[1], buf + n, sizeof(buf) - n);
+                if (k < 0 && errno == EAGAIN)
+                        continue;
+                assert_se(k > 0);
+                n += k;
+        }
+
+        p = buf;
+        for (int64_t expected = 3; expected <= 11; expected += 4) {
+                _cleanup_(sd_json_variant_unrefp) sd_json_variant *v = NULL;
+
+                assert_se(sd_json_parse(p, 0, &v, NULL, NULL) >= 0);
+                assert_se(sd_json_variant_integer(sd_json_variant_by_key(sd_json_variant_by_key(v, "parameters"), "sum")) == expected);
+
+                p += strlen(p) + 1;
+        }
+}
+
 DEFINE_TEST_MAIN(LOG_DEBUG);
@@ -450,9 +450,16 @@ static struct Item* find_glob(OrderedHashmap *h, const char *match) {
         ItemArray *j;
 
         ORDERED_HASHMAP_FOREACH(j, h)
-                FOREACH_ARRAY(item, j->items, j->n_items)
+                FOREACH_ARRAY(item, j->items, j->n_items) {
+                        /* This is called for every file encountered while cleaning up directories, hence
+                         * quickly skip globs whose literal prefix doesn't match before calling into
+                         * fnmatch(). */
+                        if (!strneq(item->path, match, strcspn(item->path, GLOB_CHARS "\\")))
+                                continue;
+
                         if (fnmatch(item->path, match, FNM_PATHNAME|FNM_PERIOD) == 0)
                                 return item;
+                }
         return NULL;
 }
 
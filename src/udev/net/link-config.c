@@ -51,6 +51,7 @@ struct LinkConfigContext {
         LIST_HEAD(LinkConfig, configs);
         int ethtool_fd;
         Hashmap *stats_by_path;
+        bool need_permanent_hw_addr;
 };
 
 static LinkConfig* link_config_free(LinkConfig *config) {
@@ -88,6 +89,7 @@ static void link_configs_free(LinkConfigContext *ctx) {
                 return;
 
         ctx->stats_by_path = hashmap_free(ctx->stats_by_path);
+        ctx->need_permanent_hw_addr = false;
 
         LIST_FOREACH(configs, config, ctx->configs)
                 link_config_free(config);
@@ -319,6 +321,9 @@ int link_load_one(LinkConfigContext *ctx, const char *filename) {
 
         log_debug("Parsed configuration file \"%s\"", filename);
 
+        if (!set_isempty(config->match.permanent_hw_addr))
+                ctx->need_permanent_hw_addr = true;
+
         LIST_PREPEND(configs, ctx->configs, TAKE_PTR(config));
         return 0;
 }
@@ -427,7 +432,9 @@ int link_new(LinkConfigContext *ctx, sd_netlink **rtnl, sd_device *device, sd_de
         if (r < 0)
                 return r;
 
-        if (link->hw_addr.length > 0 && link->permanent_hw_addr.length == 0) {
+        /* The permanent hardware address is only used for matching. Skip the ethtool ioctl when no
+         * .link file matches on PermanentMACAddress=, e.g. for veth interfaces created en masse. */
+        if (ctx->need_permanent_hw_addr && link->hw_addr.length > 0 && link->permanent_hw_addr.length == 0) {
                 r = ethtool_get_permanent_hw_addr(&ctx->ethtool_fd, link->ifname, &link->permanent_hw_addr);
                 if (r < 0)
                         log_link_debug_errno(link, r, "Failed to get permanent hardware address, ignoring: %m");
@@ -122,6 +122,35 @@ static void print_property(sd_device *dev, EventMode mode, const char *name, con
         }
 }
 
+#if defined(SD_GPT_ROOT_NATIVE) && ENABLE_EFI
+static int get_loader_device_part_uuid(sd_id128_t *ret) {
+        static sd_id128_t cached_uuid = SD_ID128_NULL;
+        static int cached_r = 1; /* not read yet */
+
+        assert(ret);
+
+        /* The ESP/XBOOTLDR we booted from doesn't change at runtime, hence read the EFI variable only once
+         * per worker, rather than for each ESP/XBOOTLDR partition of each disk we probe. Transient errors
+         * are not cached. */
+
+        if (cached_r > 0) {
+                int r;
+
+                r = efi_loader_get_device_part_uuid(&cached_uuid);
+                if (r < 0 && r != -ENOENT && !ERRNO_IS_NEG_NOT_SUPPORTED(r))
+                        return r;
+
+                cached_r = r;
+        }
+
+        if (cached_r < 0)
+                return cached_r;
+
+        *ret = cached_uuid;
+        return 0;
+}
+#endif
+
 static int find_gpt_root(sd_device *dev, blkid_probe pr, EventMode mode) {
 
 #if defined(SD_GPT_ROOT_NATIVE) && ENABLE_EFI
@@ -171,7 +200,7 @@ static int find_gpt_root(sd_device *dev, blkid_probe pr, EventMode mode) {
 
                         /* We found an ESP or XBOOTLDR, let's see if it matches the ESP/XBOOTLDR we booted from. */
 
-                        r = efi_loader_get_device_part_uuid(&esp_or_xbootldr);
+                        r = get_loader_device_part_uuid(&esp_or_xbootldr);
                         if (r < 0)
                                 return r;
 
@@ -66,9 +66,6 @@ typedef struct Event {
         usec_t retry_again_timeout_usec;
         sd_event_source *retry_event_source;
 
-        sd_event_source *timeout_warning_event;
-        sd_event_source *timeout_event;
-
         LIST_FIELDS(Event, event);
 } Event;
 
@@ -87,8 +84,30 @@ typedef struct Worker {
         union sockaddr_union address;
         WorkerState state;
         Event *event;
+
+        /* Timeouts for the event currently processed. Kept around and rearmed for each event. */
+        sd_event_source *timeout_warning_event;
+        sd_event_source *timeout_event;
 } Worker;
 
+static void event_detach_worker(Event *event) {
+        Worker *worker;
+
+        assert(event);
+
+        worker = event->worker;
+        if (!worker)
+                return;
+
+        if (worker->event == event) {
+                (void) event_source_disable(worker->timeout_warning_event);
+                (void) event_source_disable(worker->timeout_event);
+                worker->event = NULL;
+        }
+
+        event->worker = NULL;
+}
+
 static Event *event_free(Event *event) {
         if (!event)
                 return NULL;
@@ -99,11 +118,8 @@ static Event *event_free(Event *event) {
         sd_device_unref(event->dev);
 
         sd_event_source_unref(event->retry_event_source);
-        sd_event_source_unref(event->timeout_warning_event);
-        sd_event_source_unref(event->timeout_event);
 
-        if (event->worker)
-                event->worker->event = NULL;
+        event_detach_worker(event);
 
         return mfree(event);
 }
@@ -127,6 +143,9 @@ static Worker *worker_free(Worker *worker) {
         sd_event_source_unref(worker->child_event_source);
         event_free(worker->event);
 
+        sd_event_source_unref(worker->timeout_warning_event);
+        sd_event_source_unref(worker->timeout_event);
+
         return mfree(worker);
 }
 
@@ -300,25 +319,24 @@ static int on_kill_workers_event(sd_event_source *s, uint64_t usec, void *userda
 }
 
 static int on_event_timeout(sd_event_source *s, uint64_t usec, void *userdata) {
-        Event *event = ASSERT_PTR(userdata);
+        Worker *worker = ASSERT_PTR(userdata);
+        Event *event = ASSERT_PTR(worker->event);
 
-        assert(event->manager);
-        assert(event->worker);
+        assert(worker->manager);
 
-        kill_and_sigcont(event->worker->pid, event->manager->timeout_signal);
-        event->worker->state = WORKER_KILLED;
+        kill_and_sigcont(worker->pid, worker->manager->timeout_signal);
+        worker->state = WORKER_KILLED;
 
-        log_device_error(event->dev, "Worker ["PID_FMT"] processing SEQNUM=%"PRIu64" killed", event->worker->pid, event->seqnum);
+        log_device_error(event->dev, "Worker ["PID_FMT"] processing SEQNUM=%"PRIu64" killed", worker->pid, event->seqnum);
 
         return 1;
 }
 
 static int on_event_timeout_warning(sd_event_source *s, uint64_t usec, void *userdata) {
-        Event *event = ASSERT_PTR(userdata);
-
-        assert(event->worker);
+        Worker *worker = ASSERT_PTR(userdata);
+        Event *event = ASSERT_PTR(worker->event);
 
-        log_device_warning(event->dev, "Worker ["PID_FMT"] processing SEQNUM=%"PRIu64" is taking a long time", event->worker->pid, event->seqnum);
+        log_device_warning(event->dev, "Worker ["PID_FMT"] processing SEQNUM=%"PRIu64" is taking a long time", worker->pid, event->seqnum);
 
         return 1;
 }
@@ -364,17 +382,19 @@ static void worker_attach_event(Worker *worker, Event *event) {
         event->state = EVENT_RUNNING;
         event->worker = worker;
 
-        (void) sd_event_add_time_relative(e, &event->timeout_warning_event, CLOCK_MONOTONIC,
-                                          udev_warn_timeout(manager->timeout_usec), USEC_PER_SEC,
-                                          on_event_timeout_warning, event);
+        (void) event_reset_time_relative(e, &worker->timeout_warning_event, CLOCK_MONOTONIC,
+                                         udev_warn_timeout(manager->timeout_usec), USEC_PER_SEC,
+                                         on_event_timeout_warning, worker,
+                                         0, NULL, /* force_reset = */ true);
 
         /* Manager.timeout_usec is also used as the timeout for running programs specified in
          * IMPORT{program}=, PROGRAM=, or RUN=. Here, let's add an extra time before the manager
          * kills a worker, to make it possible that the worker detects timed out of spawned programs,
          * kills them, and finalizes the event. */
-        (void) sd_event_add_time_relative(e, &event->timeout_event, CLOCK_MONOTONIC,
-                                          usec_add(manager->timeout_usec, extra_timeout_usec()), USEC_PER_SEC,
-                                          on_event_timeout, event);
+        (void) event_reset_time_relative(e, &worker->timeout_event, CLOCK_MONOTONIC,
+                                         usec_add(manager->timeout_usec, extra_timeout_usec()), USEC_PER_SEC,
+                                         on_event_timeout, worker,
+                                         0, NULL, /* force_reset = */ true);
 }
 
 static int worker_spawn(Manager *manager, Event *event) {
@@ -430,8 +450,39 @@ static int worker_spawn(Manager *manager, Event *event) {
         return 0;
 }
 
-static int event_run(Event *event) {
+static bool manager_may_spawn_worker(Manager *manager) {
         static bool log_children_max_reached = true;
+
+        assert(manager);
+
+        if (hashmap_size(manager->workers) >= manager->children_max) {
+                /* Avoid spamming the debug logs if the limit is already reached and
+                 * many events still need to be processed */
+                if (log_children_max_reached && manager->children_max > 1) {
+                        log_debug("Maximum number (%u) of children reached.", hashmap_size(manager->workers));
+                        log_children_max_reached = false;
+                }
+                return false;
+        }
+
+        /* Re-enable the debug message for the next batch of events */
+        log_children_max_reached = true;
+        return true;
+}
+
+static bool manager_has_free_worker(Manager *manager) {
+        Worker *worker;
+
+        assert(manager);
+
+        HASHMAP_FOREACH(worker, manager->workers)
+                if (worker->state == WORKER_IDLE)
+                        return true;
+
+        return manager_may_spawn_worker(manager);
+}
+
+static int event_run(Event *event) {
         Manager *manager;
         Worker *worker;
         int r;
@@ -460,18 +511,8 @@ static int event_run(Event *event) {
                 return 1; /* event is now processing. */
         }
 
-        if (hashmap_size(manager->workers) >= manager->children_max) {
-                /* Avoid spamming the debug logs if the limit is already reached and
-                 * many events still need to be processed */
-                if (log_children_max_reached && manager->children_max > 1) {
-                        log_debug("Maximum number (%u) of children reached.", hashmap_size(manager->workers));
-                        log_children_max_reached = false;
-                }
+        if (!manager_may_spawn_worker(manager))
                 return 0; /* no free worker */
-        }
-
-        /* Re-enable the debug message for the next batch of events */
-        log_children_max_reached = true;
 
         /* start new worker and pass initial device */
         r = worker_spawn(manager, event);
@@ -593,6 +634,11 @@ static int event_queue_start(Manager *manager) {
                 if (event->state != EVENT_QUEUED)
                         continue;
 
+                /* Looking for blocking events means walking the queue, which is expensive with many queued
+                 * events, e.g. on coldplug. Hence, don't bother if no worker could take the event anyway. */
+                if (!manager_has_free_worker(manager))
+                        return 0;
+
                 /* do not start event if parent or child event is still running or queued */
                 r = event_is_blocked(event);
                 if (r > 0)
@@ -625,9 +671,6 @@ static int event_requeue(Event *event) {
         assert(event->manager);
         assert(event->manager->event);
 
-        event->timeout_warning_event = sd_event_source_disable_unref(event->timeout_warning_event);
-        event->timeout_event = sd_event_source_disable_unref(event->timeout_event);
-
         /* add a short delay to suppress busy loop */
         r = sd_event_now(event->manager->event, CLOCK_BOOTTIME, &now_usec);
         if (r < 0)
@@ -656,9 +699,7 @@ static int event_requeue(Event *event) {
                                                 "skipping event (SEQNUM=%"PRIu64", ACTION=%s): %m",
                                                 event->seqnum, strna(device_action_to_string(event->action)));
 
-        if (event->worker && event->worker->event == event)
-                event->worker->event = NULL;
-        event->worker = NULL;
+        event_detach_worker(event);
 
         event->state = EVENT_QUEUED;
         return 0;
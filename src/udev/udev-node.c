@@ -23,10 +23,12 @@
 #include "smack-util.h"
 #include "stat-util.h"
 #include "string-util.h"
+#include "time-util.h"
 #include "udev-node.h"
 #include "user-util.h"
 
 #define UDEV_NODE_HASH_KEY SD_ID128_MAKE(b9,6a,f1,ce,40,31,44,1a,9e,19,ec,8b,ae,f3,e3,2f)
+#define STACK_DIRECTORY_LOCK_WAIT_LOG_USEC (100 * USEC_PER_MSEC)
 
 static int node_remove_symlink(sd_device *dev, const char *slink) {
         assert(dev);
@@ -99,6 +101,15 @@ static int stack_directory_read_one(int dirfd, const char *id, char **devnode, i
 
                 *colon = '\0';
 
+                r = safe_atoi(buf, &tmp_prio);
+                if (r < 0)
+                        return r;
+
+                /* Entries that cannot win are skipped before checking the device node, so that scanning a
+                 * stack directory with many entries costs one access() per better candidate only. */
+                if (devnode && *devnode && tmp_prio <= *priority)
+                        return 0; /* Unchanged */
+
                 /* Of course, this check is racy, but it is not necessary to be perfect. Even if the device
                  * node will be removed after this check, we will receive 'remove' uevent, and the invalid
                  * symlink will be removed during processing the event. The check is just for shortening the
@@ -106,16 +117,9 @@ static int stack_directory_read_one(int dirfd, const char *id, char **devnode, i
                 if (access(colon + 1, F_OK) < 0)
                         return -ENODEV;
 
-                r = safe_atoi(buf, &tmp_prio);
-                if (r < 0)
-                        return r;
-
                 if (!devnode)
                         goto finalize;
 
-                if (*devnode && tmp_prio <= *priority)
-                        return 0; /* Unchanged */
-
                 r = free_and_strdup(devnode, colon + 1);
                 if (r < 0)
                         return r;
@@ -354,10 +358,18 @@ static int stack_directory_open_and_lock(
         if (!lockname)
                 return -ENOMEM;
 
+        usec_t begin_usec = now(CLOCK_MONOTONIC);
+
         r = make_lock_file(lockname, LOCK_EX, &lockfile);
         if (r < 0)
                 return log_device_debug_errno(dev, r, "Failed to create and lock '%s': %m", lockname);
 
+        /* Devlinks shared by many devices make workers wait for each other here, make that visible. */
+        usec_t wait_usec = usec_sub_unsigned(now(CLOCK_MONOTONIC), begin_usec);
+        if (wait_usec >= STACK_DIRECTORY_LOCK_WAIT_LOG_USEC)
+                log_device_debug(dev, "Waited %s for the lock of the stack directory of '%s'.",
+                                 FORMAT_TIMESPAN(wait_usec, USEC_PER_MSEC), slink);
+
         /* 2. Create and open the stack directory. Do not create the stack directory before taking a lock,
          * otherwise the directory may be removed by another worker. */
         dirpath = path_join("/run/udev/links/", name);
@@ -4,6 +4,7 @@
 
 #include "alloc-util.h"
 #include "architecture.h"
+#include "bitfield.h"
 #include "conf-files.h"
 #include "conf-parser.h"
 #include "confidential-virt.h"
@@ -24,6 +25,7 @@
 #include "parse-util.h"
 #include "path-util.h"
 #include "proc-cmdline.h"
+#include "sort-util.h"
 #include "socket-util.h"
 #include "stat-util.h"
 #include "string-table.h"
@@ -173,6 +175,10 @@ struct UdevRuleLine {
         char *line;
         unsigned line_number;
         UdevRuleLineType type;
+        unsigned action_mask; /* the actions the ACTION match tokens of the line accept, as bitmask */
+
+        unsigned n_evaluated; /* used by "udevadm test --profile" */
+        usec_t evaluation_usec;
 
         const char *label;
         const char *goto_label;
@@ -197,6 +203,7 @@ struct UdevRules {
         Hashmap *known_users;
         Hashmap *known_groups;
         Hashmap *stats_by_path;
+        bool profile;
         LIST_HEAD(UdevRuleFile, rule_files);
 };
 
@@ -1280,6 +1287,28 @@ static void check_tokens_order(UdevRuleLine *rule_line) {
                 }
 }
 
+static bool token_match_string(UdevRuleToken *token, const char *str);
+
+static void rule_line_compute_action_mask(UdevRuleLine *rule_line) {
+        assert(rule_line);
+
+        assert_cc(_SD_DEVICE_ACTION_MAX <= sizeof(rule_line->action_mask) * 8);
+
+        /* ACTION matches only depend on the action of the event, hence evaluate them once here for all
+         * actions, so that lines which cannot match the action of an event are skipped right away. */
+
+        rule_line->action_mask = UINT_MAX;
+
+        LIST_FOREACH(tokens, token, rule_line->tokens) {
+                if (token->type != TK_M_ACTION)
+                        continue;
+
+                for (sd_device_action_t a = 0; a < _SD_DEVICE_ACTION_MAX; a++)
+                        if (!token_match_string(token, device_action_to_string(a)))
+                                CLEAR_BIT(rule_line->action_mask, a);
+        }
+}
+
 static void sort_tokens(UdevRuleLine *rule_line) {
         assert(rule_line);
 
@@ -1353,6 +1382,7 @@ static int rule_add_line(UdevRuleFile *rule_file, const char *line_str, unsigned
                 check_tokens_order(rule_line);
 
         sort_tokens(rule_line);
+        rule_line_compute_action_mask(rule_line);
         TAKE_PTR(rule_line);
         return 0;
 }
@@ -2873,35 +2903,22 @@ static int udev_rule_apply_line_to_event(
                 UdevEvent *event,
                 UdevRuleLine **next_line) {
 
-        UdevRuleLineType mask = LINE_HAS_GOTO | LINE_UPDATE_SOMETHING;
         bool parents_done = false;
-        sd_device_action_t action;
         int r;
 
         assert(line);
         assert(event);
         assert(next_line);
 
-        r = sd_device_get_action(event->dev, &action);
-        if (r < 0)
-                return r;
-
-        if (action != SD_DEVICE_REMOVE) {
-                if (sd_device_get_devnum(event->dev, NULL) >= 0)
-                        mask |= LINE_HAS_DEVLINK;
-
-                if (sd_device_get_ifindex(event->dev, NULL) >= 0)
-                        mask |= LINE_HAS_NAME;
-        }
-
-        if ((line->type & mask) == 0)
-                return 0;
-
         event->esc = ESCAPE_UNSET;
 
         DEVICE_TRACE_POINT(rules_apply_line, event->dev, line->rule_file->filename, line->line_number);
 
         LIST_FOREACH(tokens, token, line->tokens) {
+                /* Already checked through the action mask by the caller */
+                if (token->type == TK_M_ACTION)
+                        continue;
+
                 if (token_is_for_parents(token)) {
                         if (parents_done)
                                 continue;
@@ -2926,14 +2943,47 @@ static int udev_rule_apply_line_to_event(
 }
 
 int udev_rules_apply_to_event(UdevRules *rules, UdevEvent *event) {
+        UdevRuleLineType mask = LINE_HAS_GOTO | LINE_UPDATE_SOMETHING;
+        sd_device_action_t action;
         int r;
 
         assert(rules);
         assert(event);
 
+        /* None of these change while the rules are applied, hence determine them once rather than for
+         * each line */
+        r = sd_device_get_action(event->dev, &action);
+        if (r < 0)
+                return r;
+
+        if (action != SD_DEVICE_REMOVE) {
+                if (sd_device_get_devnum(event->dev, NULL) >= 0)
+                        mask |= LINE_HAS_DEVLINK;
+
+                if (sd_device_get_ifindex(event->dev, NULL) >= 0)
+                        mask |= LINE_HAS_NAME;
+        }
+
         LIST_FOREACH(rule_files, file, rules->rule_files)
                 LIST_FOREACH_WITH_NEXT(rule_lines, line, next_line, file->rule_lines) {
+                        usec_t begin_usec = USEC_INFINITY;
+
+                        if ((line->type & mask) == 0)
+                                continue;
+
+                        if (!BIT_SET(line->action_mask, action))
+                                continue;
+
+                        if (rules->profile)
+                                begin_usec = now(CLOCK_MONOTONIC);
+
                         r = udev_rule_apply_line_to_event(line, event, &next_line);
+
+                        if (begin_usec != USEC_INFINITY) {
+                                line->n_evaluated++;
+                                line->evaluation_usec += usec_sub_unsigned(now(CLOCK_MONOTONIC), begin_usec);
+                        }
+
                         if (r < 0)
                                 return r;
                 }
@@ -2941,6 +2991,65 @@ int udev_rules_apply_to_event(UdevRules *rules, UdevEvent *event) {
         return 0;
 }
 
+void udev_rules_set_profile(UdevRules *rules, bool b) {
+        assert(rules);
+
+        rules->profile = b;
+}
+
+static int udev_rule_line_profile_compare(const UdevRuleLineProfile *a, const UdevRuleLineProfile *b) {
+        int r;
+
+        /* The most expensive lines first */
+        r = CMP(b->evaluation_usec, a->evaluation_usec);
+        if (r != 0)
+                return r;
+
+        r = CMP(b->n_evaluated, a->n_evaluated);
+        if (r != 0)
+                return r;
+
+        r = path_compare(a->filename, b->filename);
+        if (r != 0)
+                return r;
+
+        return CMP(a->line_number, b->line_number);
+}
+
+int udev_rules_get_profile(UdevRules *rules, UdevRuleLineProfile **ret, size_t *ret_n) {
+        _cleanup_free_ UdevRuleLineProfile *profile = NULL;
+        size_t n = 0;
+
+        assert(rules);
+        assert(ret);
+        assert(ret_n);
+
+        /* Returns the lines that have been evaluated since profiling was enabled, most expensive first. The
+         * returned array references the rules, hence must not outlive them. */
+
+        LIST_FOREACH(rule_files, file, rules->rule_files)
+                LIST_FOREACH(rule_lines, line, file->rule_lines) {
+                        if (line->n_evaluated == 0)
+                                continue;
+
+                        if (!GREEDY_REALLOC(profile, n + 1))
+                                return -ENOMEM;
+
+                        profile[n++] = (UdevRuleLineProfile) {
+                                .filename = file->filename,
+                                .line_number = line->line_number,
+                                .n_evaluated = line->n_evaluated,
+                                .evaluation_usec = line->evaluation_usec,
+                        };
+                }
+
+        typesafe_qsort(profile, n, udev_rule_line_profile_compare);
+
+        *ret = TAKE_PTR(profile);
+        *ret_n = n;
+        return 0;
+}
+
 static int udev_rule_line_apply_static_dev_perms(UdevRuleLine *rule_line) {
         _cleanup_strv_free_ char **tags = NULL;
         uid_t uid = UID_INVALID;
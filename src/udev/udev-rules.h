@@ -29,6 +29,13 @@ typedef enum ResolveNameTiming {
         _RESOLVE_NAME_TIMING_INVALID = -EINVAL,
 } ResolveNameTiming;
 
+typedef struct UdevRuleLineProfile {
+        const char *filename;
+        unsigned line_number;
+        unsigned n_evaluated;
+        usec_t evaluation_usec;
+} UdevRuleLineProfile;
+
 int udev_rule_parse_value(char *str, char **ret_value, char **ret_endpos, bool *ret_is_case_insensitive);
 int udev_rules_parse_file(UdevRules *rules, const char *filename, bool extra_checks, UdevRuleFile **ret);
 unsigned udev_rule_file_get_issues(UdevRuleFile *rule_file);
@@ -41,6 +48,8 @@ DEFINE_TRIVIAL_CLEANUP_FUNC(UdevRules*, udev_rules_free);
 bool udev_rules_should_reload(UdevRules *rules);
 int udev_rules_apply_to_event(UdevRules *rules, UdevEvent *event);
 int udev_rules_apply_static_dev_perms(UdevRules *rules);
+void udev_rules_set_profile(UdevRules *rules, bool b);
+int udev_rules_get_profile(UdevRules *rules, UdevRuleLineProfile **ret, size_t *ret_n);
 
 ResolveNameTiming resolve_name_timing_from_string(const char *s) _pure_;
 const char* resolve_name_timing_to_string(ResolveNameTiming i) _const_;
@@ -2,12 +2,10 @@
 #pragma once
 
 #if HAVE_SYS_SDT_H
-#define SDT_USE_VARIADIC
-#include <sys/sdt.h>
-
 #include "device-private.h"
 #include "device-util.h"
 #include "errno-util.h"
+#include "trace-util.h"
 
 /* Each trace point can have different number of additional arguments. Note that when the macro is used only
  * additional arguments are listed in the macro invocation!
@@ -28,7 +26,7 @@
                 (void) sd_device_get_sysname(_d, &_n);                                                     \
                 (void) sd_device_get_syspath(_d, &_p);                                                     \
                 (void) sd_device_get_subsystem(_d, &_s);                                                   \
-                STAP_PROBEV(udev, name, device_action_to_string(_a), _n, _p, _s __VA_OPT__(,) __VA_ARGS__);\
+                TRACE_POINT(udev, name, device_action_to_string(_a), _n, _p, _s __VA_OPT__(,) __VA_ARGS__);\
         } while (false);
 #else
 #define DEVICE_TRACE_POINT(name, dev, ...) ((void) 0)
@@ -33,6 +33,7 @@
 static sd_device_action_t arg_action = SD_DEVICE_ADD;
 static ResolveNameTiming arg_resolve_name_timing = RESOLVE_NAME_EARLY;
 static const char *arg_syspath = NULL;
+static bool arg_profile = false;
 
 static int help(void) {
 
@@ -41,18 +42,24 @@ static int help(void) {
                "  -h --help                            Show this help\n"
                "  -V --version                         Show package version\n"
                "  -a --action=ACTION|help              Set action string\n"
-               "  -N --resolve-names=early|late|never  When to resolve names\n",
+               "  -N --resolve-names=early|late|never  When to resolve names\n"
+               "     --profile                         Show the time spent in each rule\n",
                program_invocation_short_name);
 
         return 0;
 }
 
 static int parse_argv(int argc, char *argv[]) {
+        enum {
+                ARG_PROFILE = 0x100,
+        };
+
         static const struct option options[] = {
-                { "action",        required_argument, NULL, 'a' },
-                { "resolve-names", required_argument, NULL, 'N' },
-                { "version",       no_argument,       NULL, 'V' },
-                { "help",          no_argument,       NULL, 'h' },
+                { "action",        required_argument, NULL, 'a'         },
+                { "resolve-names", required_argument, NULL, 'N'         },
+                { "profile",       no_argument,       NULL, ARG_PROFILE },
+                { "version",       no_argument,       NULL, 'V'         },
+                { "help",          no_argument,       NULL, 'h'         },
                 {}
         };
 
@@ -73,6 +80,9 @@ static int parse_argv(int argc, char *argv[]) {
                                 return log_error_errno(SYNTHETIC_ERRNO(EINVAL),
                                                        "--resolve-names= must be early, late or never");
                         break;
+                case ARG_PROFILE:
+                        arg_profile = true;
+                        break;
                 case 'V':
                         return print_version();
                 case 'h':
@@ -119,6 +129,8 @@ int test_main(int argc, char *argv[], void *userdata) {
                 goto out;
         }
 
+        udev_rules_set_profile(rules, arg_profile);
+
         r = find_device_with_action(arg_syspath, arg_action, &dev);
         if (r < 0) {
                 log_error_errno(r, "Failed to open device '%s': %m", arg_syspath);
@@ -213,6 +225,23 @@ int test_main(int argc, char *argv[], void *userdata) {
                 }
         }
 
+        if (arg_profile) {
+                _cleanup_free_ UdevRuleLineProfile *profile = NULL;
+                size_t n;
+
+                r = udev_rules_get_profile(rules, &profile, &n);
+                if (r < 0) {
+                        log_error_errno(r, "Failed to get rules profile: %m");
+                        goto out;
+                }
+
+                printf("%sRules profile:%s\n", ansi_highlight(), ansi_normal());
+                FOREACH_ARRAY(p, profile, n)
+                        printf("  %10s %6u  %s:%u\n",
+                               FORMAT_TIMESPAN(p->evaluation_usec, 1), p->n_evaluated,
+                               p->filename, p->line_number);
+        }
+
         r = 0;
 out:
         udev_builtin_exit();